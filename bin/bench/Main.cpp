@@ -15,42 +15,188 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <FreeNOS/InfoPage.h>
 #include <Arch/CPU.h>
 #include <API/ProcessCtl.h>
 #include <API/IPCMessage.h>
 #include <API/VMCtl.h>
+#include <API/SystemInfo.h>
 #include <MemoryMessage.h>
 #include <ProcessID.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/wait.h>
 
-int main(int argc, char **argv)
+/** Most CPU bound processes started by the scaling test. */
+#define SCALING_MAX   16
+
+/** Iterations of the busy loop of each process in the scaling test. */
+#define SCALING_LOOPS 50000000
+
+/** Bytes read at once by the storage test. */
+#define STORAGE_BLOCK 4096
+
+/** Number of reads by the storage test, for each access pattern. */
+#define STORAGE_READS 256
+
+/** Bytes of the device covered by random reads in the storage test. */
+#define STORAGE_SPAN  (4 * 1024 * 1024)
+
+/**
+ * Enters the kernel to execute a system call.
+ */
+typedef ulong SystemCall(ulong, ulong, ulong, ulong, ulong, ulong);
+
+/**
+ * Convert a timestamp counter difference to nanoseconds.
+ * @param ticks Difference of two timestamp() values.
+ * @return Nanoseconds, or zero if the kernel did not calibrate the counter yet.
+ */
+static u64 nanoseconds(u64 ticks)
+{
+    u64 hz = ((ClockPage *) CLOCK_PAGE_ADDR)->tscFrequency;
+    u64 seconds;
+
+    if (!hz)
+	return 0;
+
+    /* Split up, to stay within 64-bit. */
+    seconds = udiv64(ticks, hz);
+    return seconds * 1000000000 + udiv64((ticks - seconds * hz) * 1000000000, hz);
+}
+
+/**
+ * Measure ProcessCtl system calls using the given kernel entry.
+ * @param name Name of the kernel entry.
+ * @param call Performs the system call.
+ */
+static void benchProcessCtl(const char *name, SystemCall *call)
 {
     u64 t1 = 0, t2 = 0;
-    ProcessID pid = 0;
     ProcessInfo info;
-    MemoryRange range;
-    char *foo[128];
 
     t1 = timestamp();
-    pid = ProcessCtl(SELF, GetPID);
+    call(PROCESSCTL, SELF, GetPID, ZERO, 0, 0);
     t2 = timestamp();
 	
-    printf("SystemCall (GetPID) Ticks: %u\r\n", t2 - t1);
+    printf("SystemCall (GetPID, %s) ns: %llu\r\n", name, nanoseconds(t2 - t1));
 	
     t1 = timestamp();
-    ProcessCtl(SELF, InfoPID, (Address) &info);
+    call(PROCESSCTL, SELF, InfoPID, (Address) &info, 0, 0);
+    t2 = timestamp();
+
+    printf("SystemCall (InfoPID, %s) ns: %llu\r\n", name, nanoseconds(t2 - t1));
+
+    t1 = timestamp();
+    call(PROCESSCTL, SELF, Schedule, ZERO, 0, 0);
+    t2 = timestamp();
+
+    printf("SystemCall (Schedule, %s) ns: %llu\r\n", name, nanoseconds(t2 - t1));
+}
+
+/**
+ * Measure how CPU bound processes scale over the processor cores.
+ * Runs 1 up to twice the number of cores processes at the same time.
+ */
+static void benchScaling()
+{
+    SystemInformation info;
+    pid_t pids[SCALING_MAX];
+    volatile u32 count;
+    Size max = info.coreCount * 2;
+    u64 t1, t2;
+    int status;
+
+    if (max > SCALING_MAX)
+	max = SCALING_MAX;
+
+    for (Size n = 1; n <= max; n++)
+    {
+	t1 = timestamp();
+
+	for (Size i = 0; i < n; i++)
+	{
+	    /* The child only burns cycles. */
+	    if ((pids[i] = fork()) == 0)
+	    {
+		for (count = 0; count < SCALING_LOOPS; count++)
+		    ;
+		exit(EXIT_SUCCESS);
+	    }
+	}
+	for (Size i = 0; i < n; i++)
+	{
+	    if (pids[i] != (pid_t) -1)
+		waitpid(pids[i], &status, 0);
+	}
+	t2 = timestamp();
+
+	printf("Scaling (%u processes, %u cores) ns: %llu\r\n",
+	       n, info.coreCount, nanoseconds(t2 - t1));
+    }
+}
+
+/**
+ * Measure sequential and random reads from a block device.
+ * @param path Path to the device file.
+ */
+static void benchStorage(const char *path)
+{
+    static char block[STORAGE_BLOCK];
+    u32 seed = 1;
+    u64 t1, t2;
+    int fd;
+
+    if ((fd = open(path, O_RDONLY)) < 0)
+    {
+	printf("Storage (%s): not present\r\n", path);
+	return;
+    }
+    t1 = timestamp();
+    for (Size i = 0; i < STORAGE_READS; i++)
+    {
+	if (read(fd, block, sizeof(block)) != sizeof(block))
+	    break;
+    }
     t2 = timestamp();
 
-    printf("SystemCall (InfoPID) Ticks: %u\r\n", t2 - t1);
+    printf("Storage (%s, sequential %u x %u bytes) ns: %llu\r\n",
+	   path, STORAGE_READS, STORAGE_BLOCK, nanoseconds(t2 - t1));
 
     t1 = timestamp();
-    ProcessCtl(SELF, Schedule);
+    for (Size i = 0; i < STORAGE_READS; i++)
+    {
+	/* Linear congruential generator: enough to defeat readahead. */
+	seed = seed * 1103515245 + 12345;
+
+	if (lseek(fd, (seed >> 8) % (STORAGE_SPAN / STORAGE_BLOCK) * STORAGE_BLOCK,
+		  SEEK_SET) == -1 ||
+	    read(fd, block, sizeof(block)) != sizeof(block))
+	    break;
+    }
     t2 = timestamp();
 
-    printf("SystemCall (Schedule) Ticks: %u\r\n", t2 - t1);
+    printf("Storage (%s, random %u x %u bytes) ns: %llu\r\n",
+	   path, STORAGE_READS, STORAGE_BLOCK, nanoseconds(t2 - t1));
+    close(fd);
+}
+
+int main(int argc, char **argv)
+{
+    u64 t1 = 0, t2 = 0;
+    MemoryRange range;
+    MemoryMessage mem;
+    char *foo[128];
+
+    /* Compare the trap gate with the fast system call entry. */
+    benchProcessCtl("int", trapKernelInterrupt);
+
+    if (FAST_SYSTEM_CALL)
+	benchProcessCtl("sysenter", trapKernelSysEnter);
+    else
+	printf("SystemCall (sysenter): not supported\r\n");
 	
     range.virtualAddress = 0x80000000;
     range.bytes = PAGESIZE;
@@ -59,28 +205,43 @@ int main(int argc, char **argv)
     VMCtl(SELF, LookupVirtual, &range);
     t2 = timestamp();
 	
-    printf("SystemCall (VMCtl) Ticks: %u\r\n", t2 - t1);
+    printf("SystemCall (VMCtl) ns: %llu\r\n", nanoseconds(t2 - t1));
 
     t1 = timestamp();
     getpid();
     t2 = timestamp();
 
-    printf("IPC Ticks: %u\r\n", t2 - t1);
+    printf("getpid() ns: %llu\r\n", nanoseconds(t2 - t1));
+
+    mem.action = SystemMemory;
+
+    t1 = timestamp();
+    mem.ipc(MEMSRV_PID, SendReceive, sizeof(mem));
+    t2 = timestamp();
+
+    printf("IPC ns: %llu\r\n", nanoseconds(t2 - t1));
 	
     t1 = timestamp();
     for (int i = 0; i < 128; i++)
         foo[i] = new char[16];
     t2 = timestamp();
 	
-    printf("allocate() Ticks: %u (%u AVG)\r\n",
-    	    (u32)(t2 - t1), (u32)(t2 - t1) / 128);
+    printf("allocate() ns: %llu (%llu AVG)\r\n",
+    	    nanoseconds(t2 - t1), nanoseconds(t2 - t1) / 128);
 	
     t1 = timestamp();
     for (int i = 0; i < 128; i++)
         delete foo[i];
     t2 = timestamp();
-    printf("release() Ticks: %u (%u AVG)\r\n",
-	(u32)(t2 - t1), (u32)(t2 - t1) / 128);
+    printf("release() ns: %llu (%llu AVG)\r\n",
+	nanoseconds(t2 - t1), nanoseconds(t2 - t1) / 128);
+
+    /* Spread work over the processor cores. */
+    benchScaling();
+
+    /* Compare the ATA and VirtIO block devices. */
+    benchStorage("/dev/ata0");
+    benchStorage("/dev/vd0");
 
     /* Done. */
     return EXIT_SUCCESS;
@@ -24,14 +24,16 @@
 
 int cat(char *prog, char *file)
 {
-    char buf[1025];
+    char buf[1024];
     int fd, e;
 
-    /* Clear buffer. */
-    memset(buf, 0, sizeof(buf));
-
+    /* Standard input, such as a pipe, is already open. */
+    if (strcmp(file, "-") == 0)
+    {
+	fd = 0;
+    }
     /* Attempt to open the file first. */
-    if ((fd = open(file, O_RDONLY)) < 0)
+    else if ((fd = open(file, O_RDONLY)) < 0)
     {
         printf("%s: failed to open '%s': %s\r\n",
                 prog, file, strerror(errno));
@@ -40,25 +42,24 @@ int cat(char *prog, char *file)
     /* Read contents. */
     while (1)
     {
-	e = read(fd, buf, sizeof(buf) - 1);
+	e = read(fd, buf, sizeof(buf));
 	switch (e)
         {
 	    /* Error occurred. */
 	    case -1:
 		printf("%s: failed to read '%s': %s\r\n",
 		        prog, file, strerror(errno));
-		close(fd);
+		if (fd) close(fd);
 	        return EXIT_FAILURE;
     
 	    /* End of file. */
 	    case 0:
-		close(fd);
+		if (fd) close(fd);
 		return EXIT_SUCCESS;
 	
-	    /* Print out results. */
+	    /* Pass the contents on unmodified. */
 	    default:
-		buf[e] = 0;
-		printf("%s", buf);
+		write(1, buf, e);
 	        break;
 	}
     }
@@ -69,12 +70,10 @@ int main(int argc, char **argv)
 {
     int ret = EXIT_SUCCESS, result;
 
-    /* Verify command-line arguments. */
+    /* Without files, copy standard input, e.g. at the end of a pipe. */
     if (argc < 2)
     {
-	printf("usage: %s FILE1 FILE2 ...\r\n",
-		argv[0]);
-	return EXIT_FAILURE;
+	return cat(argv[0], (char *) "-");
     }
     /* Cat all given files. */
     for (int i = 0; i < argc - 1; i++)
@@ -32,7 +32,7 @@ int main(int argc, char **argv)
     {
         if ((*mounts)[i]->path[0])
         {
-            printf("%10s %s\r\n",
+            printf("%-10s %s\r\n",
             (*mounts)[i]->path, (*procs)[(*mounts)[i]->procID]->command);
         }
     }
@@ -15,94 +15,68 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <API/IPCMessage.h>
+#include <ProcessMessage.h>
+#include <ProcessID.h>
+#include <UserProcess.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <stdarg.h>
 #include <string.h>
 #include <errno.h>
-#include <dirent.h>
-#include <fcntl.h>
-#include <unistd.h>
 #include <Types.h>
 #include <Macros.h>
 
-void readfile(char *buf, Size size, char *fmt, ...)
-{
-    char path[128];
-    int fd;
-    Error e;
-    va_list av;
-    
-    /* Format the path. */
-    va_start(av, fmt);
-    vsnprintf(path, sizeof(path), fmt, av);
-    va_end(av);
+/** Number of ProcessRecords to request per IPC. */
+#define PS_BATCH 16
 
-    /* Attempt to open the file first. */
-    if ((fd = open(path, ZERO)) < 0)
-    {
-        printf("Failed to open '%s': %s\r\n",
-                path, strerror(errno));
-	exit(EXIT_FAILURE);
-    }
-    /* Read contents. */
-    switch ((e = read(fd, buf, size)))
-    {
-        /* Error occurred. */
-	case -1:
-	    printf("Failed to read '%s': %s\r\n",
-	            path, strerror(errno));
-	    close(fd);
-	    exit(EXIT_FAILURE);
-    
-	/* End of file. */
-	case 0:
-	    close(fd);
-	    return;
-	
-	/* Success. */
-	default:
-	    buf[e] = ZERO;
-	    return;
-    }
-}
+/** Printable names of each ProcessState. */
+static const char *states[] =
+{
+    "Running",
+    "Ready",
+    "Stopped",
+    "Sleeping",
+    "Exited",
+};
 
 int main(int argc, char **argv)
 {
-    DIR *d;
-    struct dirent *dent;
-    char status[11];
-    char cmdline[64];
+    ProcessRecord records[PS_BATCH];
+    ProcessMessage msg;
+    ulong next = 0;
 
     /* Print header. */
     printf("PID   STATUS     CMD\r\n");
     
-    /* Attempt to open the directory. */
-    if (!(d = opendir("/proc")))
+    /* Read the process table, a batch at a time. */
+    while (next < MAX_PROCS)
     {
-	printf("Failed to open '/proc': %s\r\n",
-		strerror(errno));
-	return errno;
-    }
-    /* Read directory. */
-    while ((dent = readdir(d)))
-    {
-	if (dent->d_name[0] != '.' && dent->d_name[0] >= '0' && dent->d_name[0] <= '9')
-	{
-	    /* Read the process' status. */
-	    readfile(status,  sizeof(status),
-		    "/proc/%s/status",  dent->d_name);
-	    readfile(cmdline, sizeof(cmdline),
-		    "/proc/%s/cmdline", dent->d_name);
+	msg.action  = ReadProcessBatch;
+	msg.number  = next;
+	msg.records = records;
+	msg.count   = PS_BATCH;
+	IPCMessage(PROCSRV_PID, SendReceive, &msg, sizeof(msg));
 
-	    /* Output a line. */	
-	    printf("%5s %10s %32s\r\n",
-		    dent->d_name, status, cmdline);
+	/* No more processes? */
+	if (msg.result == ENOENT)
+	{
+	    break;
 	}
+	else if (msg.result != ESUCCESS)
+	{
+	    printf("Failed to read processes: %s\r\n",
+		    strerror(msg.result));
+	    return EXIT_FAILURE;
+	}
+	/* Output a line per process. */
+	for (Size i = 0; i < msg.count; i++)
+	{
+	    printf("%-5u %-10s %.32s\r\n",
+		    records[i].id, states[records[i].state],
+		    records[i].process.command);
+	}
+	next = msg.number;
     }
-    /* Close it. */
-    closedir(d);
-    
     /* Done. */
     return EXIT_SUCCESS;
 }
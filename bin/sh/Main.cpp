@@ -57,7 +57,7 @@ int main(int argc, char **argv)
 	    contents = new char[st.st_size];
 	    
 	    /* Read the entire file into memory. */
-	    if (fread(contents, st.st_size, 1, fp) != (size_t) st.st_size)
+	    if (fread(contents, st.st_size, 1, fp) != 1)
 	    {
 		printf("%s: failed to fread() `%s': %s\r\n",
 			argv[0], argv[i + 1], strerror(errno));
@@ -53,6 +53,9 @@ int Shell::run()
 	/* Print the prompt. */
 	prompt();
 	
+	/* Make sure the prompt is visible. */
+	fflush(stdout);
+
 	/* Wait for a command string. */
 	cmdStr = getCommand();
 	
@@ -70,9 +73,9 @@ int Shell::run()
 int Shell::execute(char *command)
 {
     char *argv[MAX_ARGV];
-    char tmp[128];
+    char *commands[MAX_PIPELINE];
     ShellCommand *cmd;
-    Size argc;
+    Size argc, count = 1;
     int pid, status;
 
     /* Valid argument? */
@@ -80,6 +83,27 @@ int Shell::execute(char *command)
     {
 	return EXIT_SUCCESS;
     }
+    /* Split a pipeline into its commands. */
+    commands[0] = command;
+
+    for (char *c = command; *c; c++)
+    {
+	if (*c == '|')
+	{
+	    if (count == MAX_PIPELINE)
+	    {
+		printf("too many commands in pipeline (%u maximum)\r\n",
+			MAX_PIPELINE);
+		return EXIT_FAILURE;
+	    }
+	    *c = ZERO;
+	    commands[count++] = c + 1;
+	}
+    }
+    if (count > 1)
+    {
+	return executePipeline(commands, count);
+    }
     /* Attempt to extract arguments. */
     argc = parse(command, argv, MAX_ARGV);
 
@@ -91,14 +115,7 @@ int Shell::execute(char *command)
     if (!(cmd = ShellCommand::byName(argv[0])))
     {
 	/* If not, try to execute it as a file directly. */
-	if ((pid = forkexec(argv[0], (const char **) argv)) >= 0)
-	{
-	    waitpid(pid, &status, 0);
-	    return status;
-	}
-	/* Try to find it on the livecd filesystem. (temporary hardcoded PATH) */
-	else if (snprintf(tmp, sizeof(tmp), "/bin/%s",  argv[0], argv[0]) &&
-	        (pid = forkexec(tmp, (const char **) argv)) >= 0)
+	if ((pid = spawn(argv)) >= 0)
 	{
 	    waitpid(pid, &status, 0);
 	    return status;
@@ -122,6 +139,96 @@ int Shell::execute(char *command)
     return EXIT_FAILURE;
 }
 
+int Shell::executePipeline(char **commands, Size count)
+{
+    char *argv[MAX_PIPELINE][MAX_ARGV];
+    int pids[MAX_PIPELINE];
+    int fds[2], input = -1, saved[2];
+    int status = EXIT_FAILURE, error = 0;
+    char *failed = ZERO;
+
+    /* Programs only: each command needs its own process. */
+    for (Size i = 0; i < count; i++)
+    {
+	if (!parse(commands[i], argv[i], MAX_ARGV))
+	{
+	    printf("syntax error: empty command in pipeline\r\n");
+	    return EXIT_FAILURE;
+	}
+    }
+    /* Keep our own output out of the pipes. */
+    fflush(stdout);
+
+    /* Remember our standard input and output. */
+    saved[0] = dup(0);
+    saved[1] = dup(1);
+    fcntl(saved[0], F_SETFD, FD_CLOEXEC);
+    fcntl(saved[1], F_SETFD, FD_CLOEXEC);
+
+    for (Size i = 0; i < count; i++)
+    {
+	/* Read from the previous command. */
+	if (input >= 0)
+	{
+	    dup2(input, 0);
+	    close(input);
+	}
+	/* Write to the next command, or to our own output. */
+	if (i < count - 1 && pipe(fds) == 0)
+	{
+	    /* The writers must not hold the read end, nor the reader the write end. */
+	    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	    dup2(fds[1], 1);
+	    close(fds[1]);
+	    input = fds[0];
+	}
+	else
+	{
+	    dup2(saved[1], 1);
+	    input = -1;
+	}
+	if ((pids[i] = spawn(argv[i])) < 0 && !failed)
+	{
+	    failed = argv[i][0];
+	    error  = errno;
+	}
+    }
+    /* Restore, which also closes our copy of the last pipe. */
+    dup2(saved[0], 0);
+    dup2(saved[1], 1);
+    close(saved[0]);
+    close(saved[1]);
+
+    if (failed)
+    {
+	printf("forkexec '%s' failed: %s\r\n", failed, strerror(error));
+    }
+    /* Wait for all commands to finish. */
+    for (Size i = 0; i < count; i++)
+    {
+	if (pids[i] >= 0)
+	{
+	    waitpid(pids[i], &status, 0);
+	}
+    }
+    return failed ? EXIT_FAILURE : status;
+}
+
+int Shell::spawn(char **argv)
+{
+    char tmp[128];
+    int pid;
+
+    /* Try to execute it as a file directly. */
+    if ((pid = forkexec(argv[0], (const char **) argv)) >= 0)
+    {
+	return pid;
+    }
+    /* Try to find it on the livecd filesystem. (temporary hardcoded PATH) */
+    snprintf(tmp, sizeof(tmp), "/bin/%s", argv[0]);
+    return forkexec(tmp, (const char **) argv);
+}
+
 char * Shell::getCommand()
 {
     static char line[1024];
@@ -155,6 +262,8 @@ char * Shell::getCommand()
 		total++;
 		break;
 	}
+	/* Echo the input immediately. */
+	fflush(stdout);
     }
     line[total] = ZERO;
     return line;
@@ -24,6 +24,9 @@
 /** Maximum number of supported command arguments. */
 #define MAX_ARGV 16
 
+/** Maximum number of commands in a pipeline. */
+#define MAX_PIPELINE 8
+
 /**
  * Very basic command shell.
  */
@@ -50,6 +53,21 @@ class Shell
 	int execute(char *cmdline);
 
     private:
+
+	/**
+	 * Executes commands connected by pipes.
+	 * @param commands Command strings, separated at each '|'.
+	 * @param count Number of commands.
+	 * @return Exit status of the last command.
+	 */
+	int executePipeline(char **commands, Size count);
+
+	/**
+	 * Start a program, without waiting for it.
+	 * @param argv Program name and arguments.
+	 * @return ProcessID of the program, or -1 on failure.
+	 */
+	int spawn(char **argv);
     
 	/**
 	 * Fetch a command from standard input.
@@ -15,6 +15,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdio.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include "StdioCommand.h"
@@ -30,6 +31,9 @@ const char * StdioCommand::help()
 
 int StdioCommand::execute(Size nparams, char **params)
 {
+    /* Write out buffered output on the old standard I/O. */
+    fflush(ZERO);
+
     /* Reopen standard I/O. */
     close(0);
     close(1);
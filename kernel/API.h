@@ -18,17 +18,22 @@
 #ifndef __KERNEL_API_H
 #define __KERNEL_API_H
 
+/**
+ * @defgroup kernel kernel (generic)
+ * @{
+ */
+
+/** Maximum number of APIHandler functions. */
+#define MAX_APIS 16
+
+#ifndef __ASSEMBLER__
+
 #include <Types.h>
 #include <Array.h>
 #include <Init.h>
 #include "Init.h"
 #include <Arch/API.h>
 
-/**
- * @defgroup kernel kernel (generic)
- * @{
- */
-
 /**
  * Initializes an APIHandler.
  * @param nr Unique system call number.
@@ -37,7 +42,7 @@
 #define INITAPI(nr,handler) \
     void __api_##nr##handler () \
     { \
-        apis.insert(nr, (APIHandler *)handler); \
+        apis[nr] = (APIHandler *)handler; \
     } \
     INITFUNC(__api_##nr##handler, API)
 
@@ -62,8 +67,26 @@ typedef enum Operation
 }
 Operation;
 
-/** List of known APIHandler functions. */
-extern Array<APIHandler> apis;
+/**
+ * Invocation counters for one APIHandler.
+ */
+typedef struct APIStats
+{
+    /** Number of calls. */
+    u64 calls;
+
+    /** Cumulative timestamp counter cycles spent, including blocking. */
+    u64 cycles;
+}
+APIStats;
+
+/** Known APIHandler functions, indexed by system call number. */
+extern APIHandler *apis[MAX_APIS];
+
+/** Invocation counters, indexed by system call number. */
+extern APIStats apiStats[MAX_APIS];
+
+#endif /* __ASSEMBLER__ */
 
 /**
  * @}
@@ -25,19 +25,86 @@
 #include <Init.h>
 #include <MemoryBlock.h>
 
-int IPCMessageHandler(ProcessID id, Operation action, UserMessage *msg, Size size)
+/**
+ * Take the first pending message of a Process.
+ * @param proc Receiving Process.
+ * @param id Origin of the message, or ANY.
+ * @param msg Message buffer.
+ * @param size Size of the buffer.
+ * @return True if a message was copied, false if none is pending.
+ */
+static bool receiveMessage(Process *proc, ProcessID id, UserMessage *msg, Size size)
+{
+    u32 irqs;
+
+    if (id == ANY || id == KERNEL_PID)
+    {
+        /* Deliver all pending interrupts in one message. */
+        if ((irqs = proc->takeIRQs()))
+        {
+            InterruptMessage irq(irqs);
+            MemoryBlock::copy(msg, &irq, size < sizeof(irq) ?
+                                         size : sizeof(irq));
+            proc->getStats()->messagesReceived++;
+            return true;
+        }
+        /* Then the expiries of one Timer. */
+        for (ListIterator<Timer> i(proc->getTimers()); i.hasNext(); i++)
+        {
+            if (i.current()->fired)
+            {
+                TimerMessage timer(i.current()->id, i.current()->fired);
+                MemoryBlock::copy(msg, &timer, size < sizeof(timer) ?
+                                               size : sizeof(timer));
+                i.current()->fired = 0;
+                proc->getStats()->messagesReceived++;
+                return true;
+            }
+        }
+        /* Then a wakeup from ProcessCtl, as an empty message. */
+        if (proc->takeWakeup())
+        {
+            Message wakeup(WakeupType, KERNEL_PID);
+            MemoryBlock::copy(msg, &wakeup, size < sizeof(wakeup) ?
+                                            size : sizeof(wakeup));
+            proc->getStats()->messagesReceived++;
+            return true;
+        }
+    }
+    /* Look for a message, with origin 'id'. */
+    for (ListIterator<UserMessage> i(proc->getMessages()); i.hasNext(); i++)
+    {
+        if (i.current()->from == id || id == ANY)
+        {
+            /* remove() releases the node: keep the message itself. */
+            UserMessage *m = i.current();
+
+            MemoryBlock::copy(msg, m->data, size < m->size ? size : m->size);
+            proc->getMessages()->remove(m);
+            proc->getStats()->messagesReceived++;
+            delete m;
+            return true;
+        }
+    }
+    return false;
+}
+
+int IPCMessageHandler(ProcessID id, Operation action, UserMessage *msg, Size size,
+                      Size timeout)
 {
     Process *proc;
 
-    /* Verify memory read/write access. */
-    if (size > MAX_MESSAGE_SIZE || !memory->access(scheduler->current(),
-                                                  (Address) msg, sizeof(UserMessage)))
+    /* Verify memory read/write access, including the fields we set below. */
+    if (size > MAX_MESSAGE_SIZE ||
+        !memory->access(scheduler->current(), (Address) msg,
+                        size > sizeof(Message) ? size : sizeof(Message)))
     {
         return EFAULT;
     }
     /* Enforce correct fields. */
-    msg->from = scheduler->current()->getID();
-    msg->type = IPCType;
+    msg->from   = scheduler->current()->getOwner();
+    msg->thread = scheduler->current()->getID();
+    msg->type   = IPCType;
 
     /* Handle IPC request appropriately. */
     switch (action)
@@ -46,12 +113,13 @@ int IPCMessageHandler(ProcessID id, Operation action, UserMessage *msg, Size siz
         case SendReceive:
   
             /* Find the remote process to send to. */
-            if (!(proc = Process::byID(id)))
+            if (!(proc = Process::byID(id)) || proc->getState() == Exited)
             {
                 return ESRCH;
             }
             /* Put our message on their list, and try to let them execute! */
             proc->getMessages()->insertHead(new UserMessage(msg, size));
+            scheduler->current()->getStats()->messagesSent++;
 
             if (action == SendReceive)
                 scheduler->current()->setState(Sleeping);
@@ -63,26 +131,22 @@ int IPCMessageHandler(ProcessID id, Operation action, UserMessage *msg, Size siz
             
         case Receive:
 
+            /* Stop waiting after the timeout, if any. */
+            scheduler->current()->setTimeout(timeout);
+
             /* Block until we have a message. */
-            while (true)
+            while (!receiveMessage(scheduler->current(), id, msg, size))
             {
-                /* Look for a message, with origin 'id'. */
-                for (ListIterator<UserMessage> i(scheduler->current()->getMessages());
-                     i.hasNext(); i++)
+                if (scheduler->current()->isTimedOut())
                 {
-                    if (i.current()->from == id || id == ANY)
-                    {
-                        MemoryBlock::copy(msg, i.current()->data, size < i.current()->size ?
-                                                       size : i.current()->size);
-                        scheduler->current()->getMessages()->remove(i.current());
-                        delete i.current();
-                        return 0;
-                    }
+                    return ETIMEDOUT;
                 }
                 /* Let some other process run while we wait. */
                 scheduler->current()->setState(Sleeping);
                 scheduler->executeNext();
             }
+            scheduler->current()->setTimeout(0);
+            return 0;
 
         default:
             return EINVAL;
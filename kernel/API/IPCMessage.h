@@ -49,11 +49,14 @@ class Message;
  * @param action Either Send or Receive.
  * @param msg Message buffer.
  * @param sz Size of message.
- * @return Zero on success and error code on failure.
+ * @param usec Microseconds to wait for a message, or zero to wait forever.
+ * @return Zero on success and error code on failure. ETIMEDOUT if no
+ *         message arrived in time.
  */
-inline Error IPCMessage(ProcessID proc, Operation action, Message *msg, Size sz)
+inline Error IPCMessage(ProcessID proc, Operation action, Message *msg, Size sz,
+			Size usec = 0)
 {
-    return trapKernel4(IPCMESSAGE, proc, action, (ulong) msg, sz);
+    return trapKernel5(IPCMESSAGE, proc, action, (ulong) msg, sz, usec);
 }
 
 /**
@@ -64,6 +67,8 @@ typedef enum MessageType
     IPCType   = 0,
     IRQType   = 1,
     FaultType = 2,
+    TimerType = 3,
+    WakeupType = 4,
 }
 MessageType;
 
@@ -78,7 +83,7 @@ class Message
 	/**
 	 * Default constructor.
 	 */
-	Message() : from(ZERO), type(IPCType)
+	Message() : from(ZERO), thread(ZERO), type(IPCType)
 	{
 	}
     
@@ -87,14 +92,14 @@ class Message
 	 * @param t Message type.
 	 * @param p ProcessID value.
 	 */
-	Message(MessageType t, ProcessID p) : from(p), type(t)
+	Message(MessageType t, ProcessID p) : from(p), thread(p), type(t)
 	{
 	}
 
 	/**
 	 * Copy constructor function.
 	 */
-	Message(Message *m) : from(m->from), type(m->type)
+	Message(Message *m) : from(m->from), thread(m->thread), type(m->type)
 	{
 	}
 	
@@ -103,14 +108,18 @@ class Message
 	 * @param pid Process to IPC to/from.
 	 * @param action Determines the action to perform.
 	 * @param sz Size of message.
+	 * @param usec Microseconds to wait for a message, or zero to wait forever.
 	 */
-	Error ipc(ProcessID pid, Operation action, Size sz)
+	Error ipc(ProcessID pid, Operation action, Size sz, Size usec = 0)
 	{
-	    return IPCMessage(pid, action, this, sz);
+	    return IPCMessage(pid, action, this, sz, usec);
 	}
 
 	/** At minimum, we must know the origin. */
 	ProcessID from;
+
+	/** Thread inside the origin which sent it. Replies go here. */
+	ProcessID thread;
 	
 	/** Message type. */
 	MessageType type;
@@ -130,18 +139,9 @@ class UserMessage : public Message
 	 */
 	UserMessage(Message *u, Size sz) : Message(u), size(sz)
 	{
-	    data = new s8[size];
 	    MemoryBlock::copy(data, u, size);
 	}
 
-	/**
-	 * Destructor function.
-	 */
-	~UserMessage()
-	{
-	    delete data;
-	}
-
 	/**
 	 * Comparision operator.
 	 * @param u UserMessage instance pionter to compare with.
@@ -149,18 +149,18 @@ class UserMessage : public Message
 	 */
 	bool operator == (UserMessage *u)
 	{
-	    return data == u->data && size == u->size;
+	    return this == u;
 	}
 
-	/** User data. */
-	s8 *data;
+	/** User data, stored inline to need only one allocation. */
+	s8 data[MAX_MESSAGE_SIZE];
 	
 	/** Size of user data. */
 	Size size;
 };
 
 /**
- * Send by the kernel, when an IRQ has been received.
+ * Send by the kernel, when one or more IRQs have been received.
  */
 class InterruptMessage : public Message
 {
@@ -168,14 +168,44 @@ class InterruptMessage : public Message
     
 	/**
 	 * Default constructor function.
+	 * @param p Bitmask of pending IRQ vectors.
 	 */
-	InterruptMessage(ulong v) :
-	    Message(IRQType, KERNEL_PID), vector(v)
+	InterruptMessage(ulong p) :
+	    Message(IRQType, KERNEL_PID), vector(0), pending(p)
 	{
+	    while (vector < 31 && !(pending & (1 << vector)))
+		vector++;
 	}
 
-	/** Interrupt vector. */
+	/** Lowest pending interrupt vector. */
 	ulong vector;
+
+	/** Bitmask of all pending interrupt vectors. */
+	ulong pending;
+};
+
+/**
+ * Send by the kernel, when a Timer created with TimerCtl() expired.
+ */
+class TimerMessage : public Message
+{
+    public:
+
+	/**
+	 * Default constructor function.
+	 * @param id Timer ID.
+	 * @param n Number of expiries.
+	 */
+	TimerMessage(ulong id, ulong n) :
+	    Message(TimerType, KERNEL_PID), timer(id), expiries(n)
+	{
+	}
+
+	/** Timer ID, as returned by TimerCtl(). */
+	ulong timer;
+
+	/** Expiries since the previous TimerMessage. */
+	ulong expiries;
 };
 
 /**
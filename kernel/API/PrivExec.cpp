@@ -19,20 +19,47 @@
 #include <Arch/Interrupt.h>
 #include <FreeNOS/Scheduler.h>
 #include <Arch/CPU.h>
+#include <Arch/Memory.h>
 #include <FreeNOS/Kernel.h>
 #include <Error.h>
 
 int PrivExecHandler(PrivOperation op)
 {
+    Size core;
+    bool cleared;
+
     switch (op)
     {
 	case Idle:
 	    
-	    scheduler->setIdle(scheduler->current());
-	    irq_enable();
-	    
+	    /* Every core needs one idle process. */
+	    if ((core = scheduler->setIdle(scheduler->current())) == MAX_CORES)
+		return EEXIST;
+
+	    /* Continue on the chosen core. */
+	    if (core != currentCore())
+	    {
+		wakeCore(core);
+		scheduler->executeNext();
+	    }
+	    /* Clear pages for later use, then sleep until the next interrupt. */
 	    while (true)
-		idle();
+	    {
+		cleared = memory->refillZeroPool();
+
+		/* Let other cores and interrupts in, in between. */
+		unlockKernel();
+		irq_enable();
+
+		if (!cleared)
+		    idle();
+
+		irq_disable();
+		lockKernel();
+
+		/* No ticks arrive when idle: look for woken processes. */
+		scheduler->executeNext();
+	    }
 	
 	case Reboot:
 	    reboot();
@@ -20,18 +20,22 @@
 #include <Arch/Kernel.h>
 #include <Arch/Memory.h>
 #include <Error.h>
+#include <MemoryBlock.h>
 
-void interruptNotify(CPUState *st, Process *p)
+void interruptNotify(CPUState *st, ProcessID id)
 {
-    p->getMessages()->insertHead(new UserMessage(new InterruptMessage(IRQ_REG(st)),
-						 sizeof(InterruptMessage)));
-    p->wakeup();
+    Process *p = Process::byID(id);
+
+    if (p)
+	p->raiseIRQ(IRQ_REG(st));
 }
 
 int ProcessCtlHandler(ProcessID procID, ProcessOperation action, Address addr)
 {
     X86Process *proc = ZERO;
     ProcessInfo *info = (ProcessInfo *) addr;
+    Size core;
+    Error e;
 
     /* Verify memory address. */
     if (action == InfoPID)
@@ -41,6 +45,13 @@ int ProcessCtlHandler(ProcessID procID, ProcessOperation action, Address addr)
 	    return EFAULT;
 	}
     }
+    else if (action == StatsPID)
+    {
+	if (!memory->access(scheduler->current(), addr, sizeof(ProcessStats)))
+	{
+	    return EFAULT;
+	}
+    }
     /* Does the target process exist? */
     if(action != GetPID && action != Spawn && !(proc = (X86Process *) Process::byID(procID)))
     {
@@ -54,7 +65,14 @@ int ProcessCtlHandler(ProcessID procID, ProcessOperation action, Address addr)
 	    return proc->getID();
 	
 	case KillPID:
-	    delete proc;
+	    /* Another core executes it: that core deletes it. */
+	    if ((core = scheduler->findCore(proc)) != MAX_CORES)
+	    {
+		proc->setKilled();
+		wakeCore(core);
+	    }
+	    else
+		delete proc;
 	    break;
 
 	case GetPID:
@@ -74,8 +92,11 @@ int ProcessCtlHandler(ProcessID procID, ProcessOperation action, Address addr)
 	    break;
 	
 	case WatchIRQ:
-	    kernel->hookInterrupt(IRQ(addr),
-		(InterruptHandler *)interruptNotify, (ulong)proc);
+	    if ((e = kernel->hookInterrupt(IRQ(addr),
+		(InterruptHandler *)interruptNotify, proc->getID())) != ESUCCESS)
+	    {
+		return e;
+	    }
 	    kernel->enableIRQ(addr, true);
 	    break;
 	
@@ -84,11 +105,54 @@ int ProcessCtlHandler(ProcessID procID, ProcessOperation action, Address addr)
 	    info->state = proc->getState();
 	    info->stack = proc->getStack();
 	    info->pageDirectory = proc->getPageDirectory();
+	    info->quantum = proc->getQuantum();
 	    break;
 	    
 	case SetStack:
 	    proc->setStack(addr);
 	    break;
+
+	case SetParent:
+	    proc->setParent(addr);
+	    break;
+
+	case SetQuantum:
+	    if (addr < MIN_QUANTUM || addr > MAX_QUANTUM)
+	    {
+		return EINVAL;
+	    }
+	    proc->setQuantum(addr);
+	    break;
+
+	case Sleep:
+	    /* Only ourselves, until a Wakeup which may precede us. */
+	    if (proc != scheduler->current())
+	    {
+		return EINVAL;
+	    }
+	    proc->setTimeout(addr);
+
+	    while (!proc->takeWakeup())
+	    {
+		if (proc->isTimedOut())
+		{
+		    proc->setTimeout(0);
+		    return ETIMEDOUT;
+		}
+		proc->setState(Sleeping);
+		scheduler->executeNext();
+	    }
+	    proc->setTimeout(0);
+	    break;
+
+	case Wakeup:
+	    proc->raiseWakeup();
+	    break;
+
+	case StatsPID:
+	    MemoryBlock::copy((void *) addr, proc->getStats(),
+			      sizeof(ProcessStats));
+	    break;
     }
     return 0;
 }
@@ -46,6 +46,11 @@ typedef enum ProcessOperation
     Schedule = 6,
     Resume   = 7,
     SetStack = 8,
+    StatsPID = 9,
+    SetParent = 10,
+    SetQuantum = 11,
+    Sleep    = 12,
+    Wakeup   = 13,
 }
 ProcessOperation;
 
@@ -65,6 +70,9 @@ typedef struct ProcessInfo
     
     /** Physical address of the page directory. */
     Address pageDirectory;
+
+    /** Time slice in microseconds. */
+    Size quantum;
 }
 ProcessInfo;
 
@@ -73,7 +81,9 @@ ProcessInfo;
  * @param proc Target Process' ID.
  * @param op The operation to perform.
  * @param addr Argument address, used for program entry point for Spawn,
- *             ProcessInfo pointer for Info.
+ *             ProcessInfo pointer for Info, ProcessStats pointer for Stats,
+ *             microseconds for SetQuantum, microseconds until
+ *             ETIMEDOUT for Sleep, or zero to sleep until woken.
  * @return Zero on success and error code on failure.
  */
 inline Error ProcessCtl(ProcessID proc, ProcessOperation op, Address addr = 0)
@@ -17,6 +17,7 @@
 
 #include <API/SystemInfo.h>
 #include <String.h>
+#include <MemoryBlock.h>
 
 int SystemInfoHandler(SystemInformation *info)
 {
@@ -43,6 +44,17 @@ int SystemInfoHandler(SystemInformation *info)
 	info->modules[i].string[31] = ZERO;
 	String::strlcpy(info->modules[i].string, (char *)m->string, 32);
     }
+    /* System call counters. */
+    MemoryBlock::copy(info->apiStats, apiStats, sizeof(apiStats));
+
+    /* Pool of cleared pages. */
+    info->zeroPool = memory->getZeroPoolStats();
+
+    /* Kernel heap. */
+    info->heap = kernelHeap->getStats();
+
+    /* Processor cores. */
+    info->coreCount = scheduler->getCoreCount();
     return 0;
 }
 
@@ -24,6 +24,7 @@
 #include <Arch/Memory.h>
 #include <FreeNOS/Config.h>
 #include <FreeNOS/Kernel.h>
+#include <FreeNOS/KernelHeap.h>
 #include <Error.h>
 #include <Types.h>
 
@@ -87,6 +88,18 @@ typedef struct SystemInformation
     
     /** Number of modules. */
     Size moduleCount;
+
+    /** Invocation counters per system call number. */
+    APIStats apiStats[MAX_APIS];
+
+    /** Usage of the pool of cleared pages. */
+    ZeroPoolStats zeroPool;
+
+    /** Kernel heap utilization. */
+    HeapStats heap;
+
+    /** Number of processor cores in use. */
+    Size coreCount;
 }
 SystemInformation;
 
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/ThreadCtl.h>
+#include <Arch/Kernel.h>
+#include <Arch/Memory.h>
+#include <Error.h>
+
+int ThreadCtlHandler(ProcessID id, ThreadOperation action,
+		     Address addr, Address stack)
+{
+    Process *current = scheduler->current(), *thread;
+
+    switch (action)
+    {
+	case CreateThread:
+	    if (!(thread = kernel->createThread(addr, current, stack)))
+	    {
+		return ENOMEM;
+	    }
+	    thread->setState(Ready);
+	    scheduler->enqueue(thread);
+	    return thread->getID();
+
+	case ExitThread:
+
+	    /* The owner exits through the process server. */
+	    if (current->getOwner() == current->getID())
+	    {
+		return EINVAL;
+	    }
+	    current->exit(addr);
+	    scheduler->executeNext();
+	    break;
+
+	case JoinThread:
+	    if (addr && !memory->access(current, addr, sizeof(Address)))
+	    {
+		return EFAULT;
+	    }
+	    /* Only join other threads of our own process. */
+	    while ((thread = Process::byID(id)))
+	    {
+		if (thread == current || thread->getOwner() == thread->getID() ||
+		    thread->getOwner() != current->getOwner())
+		{
+		    return EINVAL;
+		}
+		/* Collect the exit value and clean up. */
+		if (thread->getState() == Exited)
+		{
+		    if (addr)
+		    {
+			/* The caller may have unmapped it while we slept. */
+			if (!memory->access(current, addr, sizeof(Address)))
+			{
+			    return EFAULT;
+			}
+			memory->populate(current, addr);
+			memory->populate(current, addr + sizeof(Address) - 1);
+			*(Address *) addr = thread->getExitValue();
+		    }
+
+		    delete thread;
+		    return 0;
+		}
+		/* Wait for it to exit. */
+		thread->setJoiner(current->getID());
+		current->setState(Sleeping);
+		scheduler->executeNext();
+	    }
+	    return ESRCH;
+
+	default:
+	    return EINVAL;
+    }
+    return 0;
+}
+
+INITAPI(THREADCTL, ThreadCtlHandler)
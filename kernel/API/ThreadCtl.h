@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __API_THREADCTL_H
+#define __API_THREADCTL_H
+
+#include <FreeNOS/API.h>
+#include <FreeNOS/Scheduler.h>
+#include <Error.h>
+#include <Types.h>
+
+/**  
+ * @defgroup kernelapi kernel (API) 
+ * @{  
+ */
+
+/** SystemCall number for ThreadCtl(). */
+#define THREADCTL 7
+
+/**
+ * Available operations to perform using ThreadCtl().
+ * @see ThreadCtl
+ */
+typedef enum ThreadOperation
+{
+    CreateThread = 0,
+    ExitThread   = 1,
+    JoinThread   = 2,
+}
+ThreadOperation;
+
+/**
+ * Prototype for user applications. Thread management related operations.
+ *
+ * Threads share the address space of the calling process. Messages they
+ * send carry the ID of the process in Message::from, and their own ID in
+ * Message::thread, where replies must be sent.
+ *
+ * @param thread Target thread's ID, for JoinThread.
+ * @param op The operation to perform.
+ * @param addr Entry point for CreateThread, exit value for ExitThread,
+ *             pointer to receive the exit value for JoinThread, or ZERO.
+ * @param stack Initial user stack pointer for CreateThread.
+ * @return ID of the new thread for CreateThread. Zero on success and
+ *         error code on failure.
+ */
+inline Error ThreadCtl(ProcessID thread, ThreadOperation op,
+		       Address addr = 0, Address stack = 0)
+{
+    return trapKernel4(THREADCTL, thread, op, addr, stack);
+}
+
+/**
+ * @}
+ */
+
+#endif /* __API_THREADCTL_H */
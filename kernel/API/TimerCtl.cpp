@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/TimerCtl.h>
+#include <FreeNOS/Kernel.h>
+#include <FreeNOS/Timer.h>
+#include <ListIterator.h>
+#include <Error.h>
+
+int TimerCtlHandler(ulong id, TimerOperation action,
+		    Size usec, Size interval)
+{
+    Process *current = scheduler->current();
+    List<Timer> *list = current->getTimers();
+    Timer *timer;
+    u32 used = 0;
+
+    switch (action)
+    {
+	case SleepTimer:
+	    if (!usec)
+		return 0;
+
+	    /* Wait for the timeout, ignoring other wakeups. */
+	    current->setTimeout(usec);
+
+	    while (!current->isTimedOut())
+	    {
+		current->setState(Sleeping);
+		scheduler->executeNext();
+	    }
+	    current->setTimeout(0);
+	    break;
+
+	case CreateTimer:
+	    if (!usec || list->count() >= MAX_TIMERS)
+	    {
+		return usec ? EAGAIN : EINVAL;
+	    }
+	    /* Pick the lowest free ID, starting at one. */
+	    for (ListIterator<Timer> i(list); i.hasNext(); i++)
+		used |= 1 << i.current()->id;
+
+	    for (id = 1; used & (1 << id); id++)
+		;
+
+	    timer = new Timer(current, id);
+	    list->insertTail(timer);
+	    timers->start(timer, usec, interval);
+	    return id;
+
+	case DeleteTimer:
+	    for (ListIterator<Timer> i(list); i.hasNext(); i++)
+	    {
+		if ((timer = i.current())->id == id)
+		{
+		    timers->stop(timer);
+		    list->remove(timer);
+		    delete timer;
+		    return 0;
+		}
+	    }
+	    return ENOENT;
+
+	default:
+	    return EINVAL;
+    }
+    return 0;
+}
+
+INITAPI(TIMERCTL, TimerCtlHandler)
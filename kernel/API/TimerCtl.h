@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __API_TIMERCTL_H
+#define __API_TIMERCTL_H
+
+#include <FreeNOS/API.h>
+#include <FreeNOS/Scheduler.h>
+#include <Error.h>
+#include <Types.h>
+
+/**
+ * @defgroup kernelapi kernel (API)
+ * @{
+ */
+
+/** SystemCall number for TimerCtl(). */
+#define TIMERCTL 8
+
+/**
+ * Available operations to perform using TimerCtl().
+ * @see TimerCtl
+ */
+typedef enum TimerOperation
+{
+    SleepTimer  = 0,
+    CreateTimer = 1,
+    DeleteTimer = 2,
+}
+TimerOperation;
+
+/**
+ * Prototype for user applications. Timer related operations.
+ *
+ * SleepTimer blocks the caller for the given time. CreateTimer starts
+ * a Timer which notifies the caller with a TimerMessage from KERNEL_PID
+ * on expiry. Expiries not yet received are counted in one message.
+ *
+ * @param timer Timer ID, for DeleteTimer.
+ * @param op The operation to perform.
+ * @param usec Microseconds to sleep, or until the first expiry.
+ * @param interval Microseconds between later expiries, or zero
+ *                 to expire once.
+ * @return ID of the new Timer for CreateTimer. Zero on success and
+ *         error code on failure.
+ */
+inline Error TimerCtl(ulong timer, TimerOperation op,
+		      Size usec = 0, Size interval = 0)
+{
+    return trapKernel4(TIMERCTL, timer, op, usec, interval);
+}
+
+/**
+ * @}
+ */
+
+#endif /* __API_TIMERCTL_H */
@@ -44,6 +44,9 @@ int VMCopyHandler(ProcessID procID, Operation how, Address ours,
     /* Keep on going until all memory is processed. */
     while (total < sz)
     {
+        /* We are about to touch a demand-zero page: populate it. */
+        memory->populate(proc, theirs);
+
         /* Update variables. */
         paddr   = memory->lookupVirtual(proc, theirs) & PAGEMASK;
         pageOff = theirs & ~PAGEMASK;
@@ -54,7 +57,7 @@ int VMCopyHandler(ProcessID procID, Operation how, Address ours,
         if (!paddr) break;
                 
         /* Map the physical page. */
-        tmpAddr = memory->mapVirtual(paddr);
+        tmpAddr = memory->mapSlot(paddr);
 
         /* Process the action appropriately. */
         switch (how)
@@ -71,11 +74,14 @@ int VMCopyHandler(ProcessID procID, Operation how, Address ours,
                 ;
         }       
         /* Remove mapping. */
-        memory->mapVirtual((Address) 0, (Address) tmpAddr, 0);
+        memory->unmapSlot(tmpAddr);
         ours   += bytes;
         theirs += bytes;
         total  += bytes;
     }
+    /* Account the transfer. */
+    scheduler->current()->getStats()->copyBytes += total;
+
     /* Success. */
     return total;
 }
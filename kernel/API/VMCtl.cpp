@@ -52,8 +52,22 @@ Error VMCtlHandler(ProcessID procID, MemoryOperation op, MemoryRange *range)
 
         case Map:
 
+            /* Demand-zero pages: physical pages are allocated on first access. */
+            if (range->protection & PAGE_LAZY && !range->physicalAddress &&
+              !(range->protection & PAGE_PINNED))
+            {
+                for (Size i = 0; i < range->bytes; i += PAGESIZE)
+                {
+                    /* Never replace (and leak) a page which is already mapped. */
+                    if (memory->lookupVirtual(proc, range->virtualAddress + i))
+                        continue;
+
+                    memory->mapVirtual(proc, ZERO, range->virtualAddress + i,
+                                       range->protection & ~PAGEMASK & ~PAGE_PRESENT);
+                }
+            }
             /* Map the memory page. */
-            if (range->protection & PAGE_PRESENT)
+            else if (range->protection & PAGE_PRESENT)
             {
                 /* Acquire physical page(s) first. */
                 if (!range->physicalAddress)
@@ -63,10 +77,21 @@ Error VMCtlHandler(ProcessID procID, MemoryOperation op, MemoryRange *range)
                 /* Insert virtual page(s). */
                 for (Size i = 0; i < range->bytes; i += PAGESIZE)
                 {
+                    /* Use large pages for pinned, contiguous memory. */
+                    if (range->protection & PAGE_PINNED &&
+                        range->bytes - i >= LARGE_PAGESIZE &&
+                        memory->mapLarge(proc,
+                                         range->physicalAddress + i,
+                                         range->virtualAddress  + i,
+                                         range->protection & ~PAGEMASK))
+                    {
+                        i += LARGE_PAGESIZE - PAGESIZE;
+                        continue;
+                    }
                     memory->mapVirtual(proc,
                                        range->physicalAddress + i,
                                        range->virtualAddress  + i,
-                                       range->protection & ~PAGEMASK);
+                                       range->protection & ~PAGEMASK & ~PAGE_LAZY);
                 }
             }
             /* Release memory page(s). */
@@ -74,17 +99,25 @@ Error VMCtlHandler(ProcessID procID, MemoryOperation op, MemoryRange *range)
             {
                 for (Size i = 0; i < range->bytes; i += PAGESIZE)
                 {
-                    /* Don't release pinned pages. */
-                    if (memory->access(proc, range->virtualAddress + i,
-                                       PAGE_PINNED))
+                    /* Large pages are pinned: unmap them as a whole. */
+                    if (range->bytes - i >= LARGE_PAGESIZE &&
+                        memory->unmapLarge(proc, range->virtualAddress + i))
+                    {
+                        i += LARGE_PAGESIZE - PAGESIZE;
                         continue;
-                
-                    if ((page = memory->lookupVirtual(proc,
-                                                 range->virtualAddress + i)))
+                    }
+                    page = memory->lookupVirtual(proc, range->virtualAddress + i);
+
+                    /* Don't release the memory of pinned pages. */
+                    if (page && !(page & PAGE_PINNED))
                     {
                         memory->releasePhysical(page & PAGEMASK);
                     }
+                    /* Clear the entry, also when it is demand-zero. */
+                    memory->unmapVirtual(proc, range->virtualAddress + i);
                 }
+                /* Other cores may still cache the released pages. */
+                memory->shootdown(proc);
             }
             break;
 
@@ -124,6 +157,7 @@ Error VMCtlHandler(ProcessID procID, MemoryOperation op, MemoryRange *range)
             }
             /* Flush caches. */
             tlb_flush_all();
+            memory->shootdown(scheduler->current());
             break;
             
         default:
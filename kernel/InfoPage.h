@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_INFOPAGE_H
+#define __KERNEL_INFOPAGE_H
+
+#include <Types.h>
+
+/** 
+ * @defgroup kernel kernel (generic)
+ * @{ 
+ */
+
+/** Virtual address of the per-process information page. */
+#define PROCESS_PAGE_ADDR       0x9fffd000
+
+/** Virtual address of the system clock page. */
+#define CLOCK_PAGE_ADDR         0x9fffe000
+
+/**
+ * Per-process information, mapped read-only into each process.
+ */
+typedef struct ProcessPage
+{
+    /** Process identity. */
+    ProcessID id;
+
+    /** Identity of the process which created us. */
+    ProcessID parent;
+
+    /** Non-zero if system calls may use the fast entry instead of the trap. */
+    u32 fastSystemCall;
+}
+ProcessPage;
+
+/**
+ * System clock, mapped read-only into every process.
+ *
+ * The kernel updates the page on every timer interrupt, and on every
+ * context switch if the timer is not periodic. The sequence
+ * counter is odd while an update is in progress: readers must retry
+ * if it is odd, or if it changed while reading. Readers add the time
+ * since tscBase, measured with the timestamp counter, for nanosecond
+ * resolution in between updates.
+ */
+typedef struct ClockPage
+{
+    /** Update sequence counter. */
+    volatile u32 sequence;
+
+    /** Timer interrupts per second, or zero if the timer is not periodic. */
+    u32 tickHz;
+
+    /** Clock updates since boot. */
+    u64 ticks;
+
+    /** Seconds since boot, at the last update. */
+    u32 seconds;
+
+    /** Nanoseconds within the current second, at the last update. */
+    u32 nanoseconds;
+
+    /** Seconds since the Epoch at boot, or zero if unknown. */
+    u32 bootTime;
+
+    /** Timestamp counter frequency in Hz, or zero if not yet known. */
+    u64 tscFrequency;
+
+    /** Timestamp counter value at the last update. */
+    u64 tscBase;
+}
+ClockPage;
+
+/**
+ * @}
+ */
+
+#endif /* __KERNEL_INFOPAGE_H */
@@ -16,7 +16,9 @@
  */
 
 #include "Kernel.h"
+#include "KernelHeap.h"
 #include <Arch/Memory.h>
+#include <API/IPCMessage.h>
 #include "Process.h"
 #include "Scheduler.h"
 #include "Multiboot.h"
@@ -26,6 +28,8 @@
 
 Kernel::Kernel()
 {
+    /* Every IPC message is a UserMessage on the kernel heap. */
+    kernelHeap->addCache(sizeof(UserMessage));
 }
 
 bool Kernel::loadBootImage()
@@ -67,7 +71,7 @@ bool Kernel::loadBootImage()
 
 void Kernel::loadBootProcess(BootImage *image, Address imagePAddr, Size index)
 {
-    Address imageVAddr = (Address) image, args;
+    Address imageVAddr = (Address) image, args, tmp;
     BootProgram *program;
     BootSegment *segment;
     Process *proc;
@@ -95,7 +99,9 @@ void Kernel::loadBootProcess(BootImage *image, Address imagePAddr, Size index)
     /* Map and copy program arguments. */
     args = memory->allocatePhysical(PAGESIZE);
     memory->mapVirtual(proc, args, ARGV_ADDR, PAGE_PRESENT | PAGE_USER | PAGE_RW);
-    String::strlcpy( (char *) memory->mapVirtual(args), program->path, ARGV_SIZE);
+    tmp = memory->mapSlot(args);
+    String::strlcpy((char *) tmp, program->path, ARGV_SIZE);
+    memory->unmapSlot(tmp);
     
     /* Schedule process. */
     scheduler->enqueue(proc);
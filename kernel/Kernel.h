@@ -20,6 +20,7 @@
 
 #include <Arch/Interrupt.h>
 #include <Macros.h>
+#include <Error.h>
 #include <Types.h>
 #include <Init.h>
 #include "BootImage.h"
@@ -47,8 +48,11 @@
 /** Starts the scheduler. */
 #define SCHEDULER "4"
 
+/** Discovers the processor cores. */
+#define CORES "5"
+
 /** Core kernel initialization. */
-#define KERNEL "5"
+#define KERNEL "6"
 
 /** Start of initialization routines. */
 extern Address initStart;
@@ -87,8 +91,9 @@ class Kernel
          * @param vec Interrupt vector to hook on.
          * @param h Handler function.
          * @param p Parameter to pass to the handler function.
+         * @return Error code status.
          */
-        virtual void hookInterrupt(int vec, InterruptHandler h, ulong p) = 0;
+        virtual Error hookInterrupt(int vec, InterruptHandler h, ulong p) = 0;
 
         /** 
          * Enable or disable an hardware interrupt (IRQ). 
@@ -104,6 +109,16 @@ class Kernel
          */
         virtual Process * createProcess(Address entry) = 0;
 
+        /**
+         * Create a new thread, sharing the address space of another process.
+         * @param entry Entry address of the new thread.
+         * @param owner Process whose address space is shared.
+         * @param stack Initial user stack pointer.
+         * @return Process pointer on success or ZERO on failure.
+         */
+        virtual Process * createThread(Address entry, Process *owner,
+                                       Address stack) = 0;
+
     private:
     
         /**
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Arch/Memory.h>
+#include "KernelHeap.h"
+
+HeapPageAllocator::HeapPageAllocator(Address f, Address t)
+    : from(f), to(t), pages(0)
+{
+}
+
+Address HeapPageAllocator::allocate(Size *size)
+{
+    Size bytes = (*size + PAGESIZE - 1) & PAGEMASK;
+    Address addr;
+
+    /* Take free physical pages, inside our range only. */
+    if (!(addr = Memory::allocatePhysical(bytes, from)))
+    {
+	return ZERO;
+    }
+    if (addr + bytes > to)
+    {
+	for (Size i = 0; i < bytes; i += PAGESIZE)
+	    Memory::releasePhysical(addr + i);
+	return ZERO;
+    }
+    pages += bytes / PAGESIZE;
+    *size  = bytes;
+    return addr;
+}
+
+void HeapPageAllocator::release(Address addr)
+{
+    release(addr, PAGESIZE);
+}
+
+void HeapPageAllocator::release(Address addr, Size size)
+{
+    for (Size i = 0; i < size; i += PAGESIZE)
+    {
+	Memory::releasePhysical(addr + i);
+	pages--;
+    }
+}
+
+Size HeapPageAllocator::getPageCount() const
+{
+    return pages;
+}
+
+KernelHeap::KernelHeap(Address from, Address to)
+    : pages(from, to), dedicatedCount(0), largeCount(0), largeBytes(0)
+{
+    for (Size i = 0; i <= HEAP_MAX_POWER - HEAP_MIN_POWER; i++)
+    {
+	new ((Address) &caches[i]) SlabAllocator(1 << (i + HEAP_MIN_POWER));
+	caches[i].setParent(&pages);
+    }
+}
+
+Address KernelHeap::allocate(Size *size)
+{
+    LargeBlock *block;
+    Size bytes;
+
+    /* Dedicated caches first. */
+    for (Size i = 0; i < dedicatedCount; i++)
+    {
+	if (dedicated[i].getObjectSize() == aligned(*size))
+	    return dedicated[i].allocate(size);
+    }
+    /* Then the smallest general purpose cache which fits. */
+    for (Size i = 0; i <= HEAP_MAX_POWER - HEAP_MIN_POWER; i++)
+    {
+	if (*size <= caches[i].getObjectSize())
+	    return caches[i].allocate(size);
+    }
+    /* Too large: use whole pages. */
+    bytes = *size + sizeof(LargeBlock);
+
+    if (!(block = (LargeBlock *) pages.allocate(&bytes)))
+    {
+	return ZERO;
+    }
+    block->cache = ZERO;
+    block->size  = bytes;
+    largeCount++;
+    largeBytes += bytes;
+
+    *size = bytes - sizeof(LargeBlock);
+    return (Address) (block + 1);
+}
+
+void KernelHeap::release(Address addr)
+{
+    Slab *slab = (Slab *) (addr & PAGEMASK);
+    LargeBlock *block = (LargeBlock *) slab;
+
+    if (!addr)
+    {
+	return;
+    }
+    /* Objects are released to the cache owning their slab. */
+    if (slab->cache)
+    {
+	slab->cache->release(addr);
+    }
+    else
+    {
+	largeCount--;
+	largeBytes -= block->size;
+	pages.release((Address) block, block->size);
+    }
+}
+
+bool KernelHeap::addCache(Size objectSize)
+{
+    if (dedicatedCount >= HEAP_MAX_CACHES)
+    {
+	return false;
+    }
+    new ((Address) &dedicated[dedicatedCount]) SlabAllocator(objectSize);
+    dedicated[dedicatedCount++].setParent(&pages);
+    return true;
+}
+
+HeapStats KernelHeap::getStats() const
+{
+    HeapStats stats;
+
+    stats.pages   = pages.getPageCount();
+    stats.objects = largeCount;
+    stats.bytes   = largeBytes;
+
+    for (Size i = 0; i <= HEAP_MAX_POWER - HEAP_MIN_POWER; i++)
+    {
+	stats.objects += caches[i].getObjectCount();
+	stats.bytes   += caches[i].getObjectCount() * caches[i].getObjectSize();
+    }
+    for (Size i = 0; i < dedicatedCount; i++)
+    {
+	stats.objects += dedicated[i].getObjectCount();
+	stats.bytes   += dedicated[i].getObjectCount() * dedicated[i].getObjectSize();
+    }
+    return stats;
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_KERNELHEAP_H
+#define __KERNEL_KERNELHEAP_H
+#ifndef __ASSEMBLER__
+
+#include <Types.h>
+
+/**
+ * @defgroup kernel kernel (generic)
+ * @{
+ */
+
+/** Smallest general purpose object cache: 16 bytes. */
+#define HEAP_MIN_POWER  4
+
+/** Largest general purpose object cache: 1024 bytes. */
+#define HEAP_MAX_POWER  10
+
+/** Maximum number of dedicated object caches. */
+#define HEAP_MAX_CACHES 4
+
+/**
+ * Kernel heap utilization.
+ */
+typedef struct HeapStats
+{
+    /** Physical pages in use by the heap. */
+    Size pages;
+
+    /** Number of allocated objects. */
+    Size objects;
+
+    /** Bytes in use by allocated objects. */
+    Size bytes;
+}
+HeapStats;
+
+#ifdef __KERNEL__
+
+#include <Allocator.h>
+#include <SlabAllocator.h>
+
+/**
+ * Allocates pages for the kernel heap from a range of physical memory.
+ * The range must be mapped in the kernel, at the same virtual address.
+ */
+class HeapPageAllocator : public Allocator
+{
+    public:
+
+	/**
+	 * Class constructor.
+	 * @param from First physical address to use.
+	 * @param to End of the physical range.
+	 */
+	HeapPageAllocator(Address from, Address to);
+
+	/**
+	 * Allocate contiguous pages.
+	 * @param size Number of bytes, rounded up to pages on output.
+	 * @return Address of the first page on success and ZERO on failure.
+	 */
+	Address allocate(Size *size);
+
+	/**
+	 * Release a single page.
+	 * @param addr Page address.
+	 */
+	void release(Address addr);
+
+	/**
+	 * Release contiguous pages.
+	 * @param addr Address of the first page.
+	 * @param size Number of bytes.
+	 */
+	void release(Address addr, Size size);
+
+	/**
+	 * Number of pages handed out.
+	 * @return Page count.
+	 */
+	Size getPageCount() const;
+
+    private:
+
+	/** Physical memory range to use. */
+	Address from, to;
+
+	/** Number of pages handed out. */
+	Size pages;
+};
+
+/**
+ * Header of allocations too large for the object caches.
+ */
+typedef struct LargeBlock
+{
+    /** Always ZERO. Overlaps Slab::cache, to tell the two apart. */
+    SlabAllocator *cache;
+
+    /** Number of bytes allocated, including this header. */
+    Size size;
+}
+LargeBlock;
+
+/**
+ * Kernel heap.
+ *
+ * Small objects come from slab caches: dedicated caches for frequently
+ * used kernel objects, and power of two sized caches for all others.
+ * Larger allocations are served with whole pages. The heap grows and
+ * shrinks page by page, using the physical memory allocator.
+ */
+class KernelHeap : public Allocator
+{
+    public:
+
+	/**
+	 * Class constructor.
+	 * @param from First physical address of the heap.
+	 * @param to End of the heap.
+	 */
+	KernelHeap(Address from, Address to);
+
+	/**
+	 * Allocate memory.
+	 * @param size Number of bytes needed. On output, the number of bytes allocated.
+	 * @return Address of the memory on success and ZERO on failure.
+	 */
+	Address allocate(Size *size);
+
+	/**
+	 * Release memory.
+	 * @param addr Points to memory previously returned by allocate().
+	 */
+	void release(Address addr);
+
+	/**
+	 * Add a dedicated cache for objects of the given size.
+	 * @param objectSize Size of the objects in bytes.
+	 * @return True on success, false if all dedicated caches are in use.
+	 */
+	bool addCache(Size objectSize);
+
+	/**
+	 * Retrieve heap utilization.
+	 * @return Heap statistics.
+	 */
+	HeapStats getStats() const;
+
+    private:
+
+	/** Provides pages for the caches and large allocations. */
+	HeapPageAllocator pages;
+
+	/** Power of two sized caches. */
+	SlabAllocator caches[HEAP_MAX_POWER - HEAP_MIN_POWER + 1];
+
+	/** Caches for objects of a fixed size. */
+	SlabAllocator dedicated[HEAP_MAX_CACHES];
+
+	/** Number of dedicated caches in use. */
+	Size dedicatedCount;
+
+	/** Number of large allocations. */
+	Size largeCount;
+
+	/** Bytes in use by large allocations. */
+	Size largeBytes;
+};
+
+/** The kernel heap. */
+extern KernelHeap *kernelHeap;
+
+#endif /* __KERNEL__ */
+
+/**
+ * @}
+ */
+
+#endif /* __ASSEMBLER__ */
+#endif /* __KERNEL_KERNELHEAP_H */
@@ -19,28 +19,19 @@
 #include "Multiboot.h"
 #include "Kernel.h"
 #include <Init.h>
-#include <Allocator.h>
-#include <BubbleAllocator.h>
-#include <PoolAllocator.h>
+#include "KernelHeap.h"
 #include <Types.h>
 
 Size Memory::memorySize, Memory::memoryAvail;
 u8  *Memory::memoryMap, *Memory::memoryMapEnd;
 
+/** Storage for the kernel heap object itself. */
+static Address heapObject[(sizeof(KernelHeap) / sizeof(Address)) + 1];
+
+KernelHeap *kernelHeap;
+
 Memory::Memory()
 {
-    /* Marks kernel memory used. */
-    allocatePhysical(0x00400000, 0);
-    
-    /* Marks boot module memory. */
-    for (Size i = 0; i < multibootInfo.modsCount; i++)
-    {
-        MultibootModule *mod  = &((MultibootModule *) multibootInfo.modsAddress)[i];
-        Size modSize = mod->modEnd - mod->modStart;
-
-        /* Mark memory used. */
-        allocatePhysical(modSize, mod->modStart);
-    }
 }
 
 Size Memory::getTotalMemory()
@@ -55,9 +46,7 @@ Size Memory::getAvailableMemory()
 
 void Memory::initialize()
 {
-    Address page = 0x00300000;
-    Size meta = sizeof(BubbleAllocator) + sizeof(PoolAllocator);
-    Allocator *bubble, *pool;
+    Address heapFrom;
 
     /* Save memory size. */
     memorySize  = (multibootInfo.memLower + multibootInfo.memUpper) * 1024;
@@ -72,16 +61,30 @@ void Memory::initialize()
     {
         *p = 0;
     }
-    /* Setup the dynamic memory heap. */
-    bubble = new (page) BubbleAllocator();
-    pool   = new (page + sizeof(BubbleAllocator)) PoolAllocator();
-    pool->setParent(bubble);
-    
-    /* Setup the heap region (1MB). */
-    bubble->region(page + meta, (1024 * 1024) - meta);
+    /* Marks the kernel and the memoryMap used. */
+    heapFrom = ((Address) memoryMapEnd + PAGESIZE - 1) & PAGEMASK;
+
+    for (Address addr = 0; addr < heapFrom; addr += PAGESIZE)
+    {
+        setMark(addr, true);
+    }
+    memoryAvail -= heapFrom;
 
+    /* Marks boot module memory, before the heap can take it. */
+    for (Size i = 0; i < multibootInfo.modsCount; i++)
+    {
+        MultibootModule *mod  = &((MultibootModule *) multibootInfo.modsAddress)[i];
+
+        reserve(mod->modStart, mod->modEnd);
+    }
+    reserve(multibootInfo.modsAddress, multibootInfo.modsAddress +
+            multibootInfo.modsCount * sizeof(MultibootModule));
+
+    /* The heap grows into the remaining identity mapped kernel memory. */
+    kernelHeap = new ((Address) heapObject) KernelHeap(heapFrom,
+                                                       PAGETAB_MAX * PAGESIZE);
     /* Set default allocator. */
-    Allocator::setDefault(pool);
+    Allocator::setDefault(kernelHeap);
 }
 
 Address Memory::allocatePhysical(Size sz, Address paddr)
@@ -123,6 +126,18 @@ Address Memory::allocatePhysical(Size sz, Address paddr)
     return (Address) ZERO;
 }
 
+void Memory::reserve(Address from, Address to)
+{
+    for (Address addr = from & PAGEMASK; addr < to; addr += PAGESIZE)
+    {
+        if (!isMarked(addr))
+        {
+            setMark(addr, true);
+            memoryAvail -= PAGESIZE;
+        }
+    }
+}
+
 void Memory::releasePhysical(Address addr)
 {
     setMark(addr & PAGEMASK, false);
@@ -64,19 +64,19 @@ class Memory
          * @param addr Physical address to start searching at.
          * @return Physical address of the allocated memory.
          */
-        Address allocatePhysical(Size sz, Address addr = 4194304);
+        static Address allocatePhysical(Size sz, Address addr = 4194304);
 
         /**
          * Unmarks physical memory used in the memoryMap.
          * @param paddr Physical address of the memory to unmark.
          */
-        void releasePhysical(Address paddr);
+        static void releasePhysical(Address paddr);
 
         /**
          * Check if a physical memory page is marked.
          * @param addr Physical address to check.
          */
-        bool isMarked(Address paddr);
+        static bool isMarked(Address paddr);
 
         /**
          * Allocate a new virtual memory page.
@@ -149,12 +149,19 @@ class Memory
 
     private:
 
+        /**
+         * Mark the pages of a physical range used, if not already.
+         * @param from Physical address of the first byte.
+         * @param to Physical address just past the range.
+         */
+        static void reserve(Address from, Address to);
+
         /**
          * (Un)mark a physical page.
          * @param addr Physical address to be (un)marked.
          * @param marked Either marks or unmarks the page.
          */
-        void setMark(Address addr, bool marked);
+        static void setMark(Address addr, bool marked);
 };
 
 /**
@@ -21,22 +21,38 @@
 #include <ProcessID.h>
 #include <ListIterator.h>
 #include <Arch/Interrupt.h>
+#include <MemoryBlock.h>
 #include <Types.h>
 #include <Array.h>
 #include <List.h>
 #include "Scheduler.h"
 
 Array<Process> Process::procs(MAX_PROCS);
-List<Process> Process::wakeups;
 
-Process::Process(Address addr) : status(Stopped)
+Process::Process(Address addr, Process *own)
+    : status(Stopped), joiner(ANY), exitValue(ZERO), core(0), killed(false),
+      quantum(DEFAULT_QUANTUM), sleepTimer(this), pendingIRQs(0),
+      pendingWakeup(false)
 {
-    pid = procs.insert(this);
+    pid   = procs.insert(this);
+    owner = own ? own->getOwner() : pid;
+
+    /* Threads run as long as their owner. */
+    if (own)
+	quantum = own->getQuantum();
+    MemoryBlock::set(&stats, 0, sizeof(stats));
 }
     
 Process::~Process()
 {
-    wakeups.remove(this);
+    /* Timers must not wake us anymore. */
+    timers->stop(&sleepTimer);
+
+    for (ListIterator<Timer> i(&userTimers); i.hasNext(); i++)
+    {
+	timers->stop(i.current());
+	delete i.current();
+    }
     procs.remove(pid);
 }
 
@@ -44,6 +60,11 @@ ProcessID Process::getID()
 {
     return pid;
 }
+
+ProcessID Process::getOwner()
+{
+    return owner;
+}
         
 ProcessState Process::getState()
 {
@@ -55,16 +76,98 @@ void Process::setState(ProcessState st)
     status = st;
 }
 
-void Process::wakeup()
+void Process::raiseIRQ(uint irq)
+{
+    pendingIRQs |= 1 << irq;
+    scheduler->wakeup(this);
+}
+
+u32 Process::takeIRQs()
+{
+    u32 pending = pendingIRQs;
+    pendingIRQs = 0;
+    return pending;
+}
+
+void Process::raiseWakeup()
+{
+    pendingWakeup = true;
+    scheduler->wakeup(this);
+}
+
+bool Process::takeWakeup()
 {
-    ulong t = irq_disable();
-    wakeups.insertTail(this);
-    irq_restore(t);
+    bool pending = pendingWakeup;
+    pendingWakeup = false;
+    return pending;
 }
 
-List<Process> * Process::getWakeups()
+void Process::setJoiner(ProcessID id)
 {
-    return &wakeups;
+    joiner = id;
+}
+
+Address Process::getExitValue()
+{
+    return exitValue;
+}
+
+void Process::exit(Address value)
+{
+    Process *p = procs[joiner];
+
+    exitValue = value;
+    status    = Exited;
+    scheduler->dequeue(this);
+
+    if (p)
+	scheduler->wakeup(p);
+}
+
+Size Process::getCore()
+{
+    return core;
+}
+
+void Process::setCore(Size c)
+{
+    core = c;
+}
+
+Size Process::getQuantum()
+{
+    return quantum;
+}
+
+void Process::setQuantum(Size usec)
+{
+    quantum = usec;
+}
+
+void Process::setTimeout(Size usec)
+{
+    if (usec)
+	timers->start(&sleepTimer, usec);
+    else
+    {
+	timers->stop(&sleepTimer);
+	sleepTimer.fired = 0;
+    }
+}
+
+bool Process::isTimedOut()
+{
+    return sleepTimer.fired != 0;
+}
+
+void Process::setKilled()
+{
+    killed = true;
+}
+
+bool Process::isKilled()
+{
+    return killed;
 }
 
 List<UserMessage> * Process::getMessages()
@@ -72,6 +175,16 @@ List<UserMessage> * Process::getMessages()
     return &messages;
 }
 
+List<Timer> * Process::getTimers()
+{
+    return &userTimers;
+}
+
+ProcessStats * Process::getStats()
+{
+    return &stats;
+}
+
 Array<Process> * Process::getProcessTable()
 {
     return &procs;
@@ -22,6 +22,7 @@
 #include <Types.h>
 #include <Array.h>
 #include <List.h>
+#include "Timer.h"
 
 /** 
  * @defgroup kernel kernel (generic)
@@ -31,6 +32,18 @@
 /** Maximum number of processes. */
 #define MAX_PROCS 1024
 
+/** Default time slice of a Process, in microseconds. */
+#define DEFAULT_QUANTUM 8000
+
+/** Shortest time slice of a Process, in microseconds. */
+#define MIN_QUANTUM     1000
+
+/** Longest time slice of a Process, in microseconds. */
+#define MAX_QUANTUM     1000000
+
+/** Maximum number of notification Timers per Process. */
+#define MAX_TIMERS      16
+
 /** @see IPCMessage.h. */
 class UserMessage;
 
@@ -43,11 +56,45 @@ typedef enum ProcessState
     Ready     = 1,
     Stopped   = 2,
     Sleeping  = 3,
+    Exited    = 4,
 }
 ProcessState;
 
+/**
+ * Performance counters kept by the kernel for each Process.
+ */
+typedef struct ProcessStats
+{
+    /** Number of times the Process gave up the CPU itself. */
+    u64 voluntarySwitches;
+
+    /** Number of times the Process was preempted by the timer. */
+    u64 involuntarySwitches;
+
+    /** Timer ticks during which the Process was executing. */
+    u64 ticks;
+
+    /** IPC messages sent. */
+    u64 messagesSent;
+
+    /** IPC messages received. */
+    u64 messagesReceived;
+
+    /** Bytes moved with VMCopy(). */
+    u64 copyBytes;
+
+    /** Page faults taken. */
+    u64 pageFaults;
+}
+ProcessStats;
+
 /**
  * Represents a process which may run on the host.
+ *
+ * A Process which shares the address space of another Process is
+ * a thread. The Process owning the address space is its owner: it sends
+ * and receives messages under the owner's ID, but keeps its own mailbox
+ * for replies.
  */
 class Process
 {
@@ -56,8 +103,9 @@ class Process
         /**
          * Constructor function.
          * @param entry Initial program counter value.
+         * @param owner Process whose address space is shared, or ZERO.
          */
-        Process(Address entry);
+        Process(Address entry, Process *owner = ZERO);
     
         /**
          * Destructor function.
@@ -69,6 +117,12 @@ class Process
          * @return Process Identification number.
          */
         ProcessID getID();
+
+        /**
+         * Retrieve the ID of the Process owning our address space.
+         * @return Our own ID, or the owner's ID for threads.
+         */
+        ProcessID getOwner();
         
         /**
          * Retrieves the current state.
@@ -83,15 +137,96 @@ class Process
         void setState(ProcessState st);
 
         /**
-         * Request this Process to be awoken by the Scheduler.
+         * Mark an IRQ pending, and wake the Process if it sleeps.
+         * @param irq IRQ number, below 32.
+         */
+        void raiseIRQ(uint irq);
+
+        /**
+         * Retrieve and clear the pending IRQs.
+         * @return Bitmask of pending IRQ numbers.
+         */
+        u32 takeIRQs();
+
+        /**
+         * Mark a wakeup pending, and wake the Process if it sleeps.
+         * A wakeup raised before the Process sleeps is not lost. It ends
+         * a ProcessCtl Sleep, or arrives as a WakeupType message when
+         * receiving from ANY.
+         */
+        void raiseWakeup();
+
+        /**
+         * Retrieve and clear the pending wakeup.
+         * @return True if a wakeup was pending, false otherwise.
+         */
+        bool takeWakeup();
+
+        /**
+         * Wake the given Process when we exit.
+         * @param id Process to wake, or ANY for none.
+         */
+        void setJoiner(ProcessID id);
+
+        /**
+         * Retrieve the value passed to exit().
+         * @return Exit value.
+         */
+        Address getExitValue();
+
+        /**
+         * Leave the scheduler for good and wake the joiner, if any.
+         * The Process is not deleted: the joiner does that.
+         * @param value Exit value passed to the joiner.
          */
-        void wakeup();
+        void exit(Address value);
 
         /**
-         * Fetch the list of processes waiting to be woken up.
-         * @return Pointer to the List of Proccess to be awoken.
+         * Retrieve the core whose run queue holds us.
+         * @return Core number.
          */
-        static List<Process> * getWakeups();
+        Size getCore();
+
+        /**
+         * Record the core whose run queue holds us.
+         * @param core Core number.
+         */
+        void setCore(Size core);
+
+        /**
+         * Retrieve the time slice.
+         * @return Microseconds the Process may run before being preempted.
+         */
+        Size getQuantum();
+
+        /**
+         * Change the time slice.
+         * @param usec Microseconds, between MIN_QUANTUM and MAX_QUANTUM.
+         */
+        void setQuantum(Size usec);
+
+        /**
+         * Limit the time a blocking system call may wait.
+         * @param usec Microseconds from now, or zero to wait forever.
+         */
+        void setTimeout(Size usec);
+
+        /**
+         * Check if the time set with setTimeout() passed.
+         * @return True if timed out, false otherwise.
+         */
+        bool isTimedOut();
+
+        /**
+         * Mark the Process for deletion by the core executing it.
+         */
+        void setKilled();
+
+        /**
+         * Check if the Process is marked for deletion.
+         * @return True if killed, false otherwise.
+         */
+        bool isKilled();
 
         /**
          * Retrieve the list of Messages for this Process.
@@ -99,6 +234,18 @@ class Process
          */
         List<UserMessage> * getMessages();
 
+        /**
+         * Retrieve the Timers which notify this Process with messages.
+         * @return Pointer to the list of Timers.
+         */
+        List<Timer> * getTimers();
+
+        /**
+         * Retrieve the performance counters for this Process.
+         * @return Pointer to the counters.
+         */
+        ProcessStats * getStats();
+
         /**
          * Retrieve the process table.
          * @return Pointer to the process table.
@@ -138,12 +285,42 @@ class Process
         
         /** Unique ID number. */
         ProcessID pid;
+
+        /** Owner of the address space. */
+        ProcessID owner;
+
+        /** Process waiting for us to exit. */
+        ProcessID joiner;
+
+        /** Value passed to exit(). */
+        Address exitValue;
+        
+        /** Core whose run queue holds us. */
+        Size core;
+
+        /** Set when another core must delete us. */
+        bool killed;
+
+        /** Time slice in microseconds. */
+        Size quantum;
         
         /** Incoming messages. */
         List<UserMessage> messages;
 
-        /** Processes waiting to be woken up. */
-        static List<Process> wakeups;
+        /** Timeout of blocking system calls. */
+        Timer sleepTimer;
+
+        /** Timers delivering messages. */
+        List<Timer> userTimers;
+
+        /** Performance counters. */
+        ProcessStats stats;
+
+        /** Bitmask of IRQs not yet received. */
+        u32 pendingIRQs;
+
+        /** Set by raiseWakeup() until taken. */
+        bool pendingWakeup;
         
         /** All known Processes. */
         static Array<Process> procs;
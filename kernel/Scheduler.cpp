@@ -21,128 +21,305 @@
 #include <ListIterator.h>
 #include <Macros.h>
 
-Scheduler::Scheduler()
-    : currentProcess(ZERO), oldProcess(ZERO), idleProcess(ZERO)
+Scheduler::Scheduler() : coreCount(1)
 {
-    queuePtr.reset(&queue);
+    for (Size i = 0; i < MAX_CORES; i++)
+    {
+        cores[i].queuePtr.reset(&cores[i].queue);
+        cores[i].current = ZERO;
+        cores[i].old     = ZERO;
+        cores[i].idle    = ZERO;
+    }
 }
 
-void Scheduler::executeNext()
+void Scheduler::executeNext(bool preempted)
 {
+    Size core = currentCore();
+    RunQueue *rq = &cores[core];
     Process *next;
 
-    /* Save the old process. */
-    oldProcess = currentProcess ? currentProcess : ZERO;
+    reap(rq);
 
-    /* Process any pending wakeups. */
-    for (ListIterator<Process> i(Process::getWakeups()); i.hasNext(); i++)
+    /* Find the next ready Process in line, or take one from another core. */
+    if (!(next = findNextReady(rq)) && !(next = steal(core)))
     {
-        /* Only wakeup when it sleeps. */
-        if (i.current()->getState() == Sleeping)
-        {
-            i.current()->setState(Ready);
-            Process::getWakeups()->remove(i.current());
-        }
+        next = rq->idle;
     }
-    /* Find the next ready Process in line. */
-    if (!(next = findNextReady()))
+    /* Nothing to run yet: keep the core where it is. */
+    if (!next)
     {
-        next = idleProcess;
+        return;
     }
+    /* Save the old process. */
+    rq->old = rq->current;
+
     /* Update current. */
-    currentProcess = next;
+    rq->current = next;
     
     /* Run it. */
-    if (currentProcess != oldProcess)
+    if (rq->current != rq->old)
     {
-        currentProcess->execute();
+        if (rq->old && preempted)
+            rq->old->getStats()->involuntarySwitches++;
+        else if (rq->old)
+            rq->old->getStats()->voluntarySwitches++;
+
+        rq->current->execute();
     }
 }
 
 void Scheduler::executeAttempt(Process *p)
 {
+    Size core = currentCore();
+    RunQueue *rq = &cores[core];
+
+    reap(rq);
+
     /* Don't switch if it's the current process. */
-    if (p == currentProcess) return;
+    if (p == rq->current) return;
     
     /* Wakeup process if needed. */
     if (p->getState() == Sleeping)
     {
         p->setState(Ready);
-        Process::getWakeups()->remove(p);
+    }
+    /* Only run queued processes which no other core executes. */
+    if (p->getState() != Ready ||
+       (p->getCore() != core && !migrate(p, core)))
+    {
+        wakeup(p);
+        return;
     }
     /* Update pointers. */
-    oldProcess = currentProcess;
-    currentProcess = p;
+    rq->old = rq->current;
+    rq->current = p;
+
+    if (rq->old)
+        rq->old->getStats()->voluntarySwitches++;
     
     /* Execute it. */
     p->execute();
 }
 
+void Scheduler::reap(RunQueue *rq)
+{
+    Process *owner;
+
+    /* Finish a kill from another core, now that we are in the kernel. */
+    if (rq->current)
+    {
+        owner = Process::byID(rq->current->getOwner());
+
+        if (rq->current->isKilled())
+            delete rq->current;
+        else if (owner && owner->isKilled())
+            delete owner;
+    }
+}
+
+void Scheduler::wakeup(Process *p)
+{
+    RunQueue *rq = &cores[p->getCore()];
+
+    if (p->getState() == Sleeping)
+    {
+        p->setState(Ready);
+    }
+    /* An idle core only looks again at its next timer interrupt. */
+    if (p->getCore() != currentCore() && rq->current == rq->idle)
+    {
+        wakeCore(p->getCore());
+    }
+}
+
 void Scheduler::enqueue(Process *proc)
 {
-    queue.insertTail(proc);
+    Process *owner = Process::byID(proc->getOwner());
+    Size core = currentCore();
+
+    /* Keep threads with their address space. */
+    if (owner && owner != proc)
+    {
+        core = owner->getCore();
+    }
+    remove(proc);
+    proc->setCore(core);
+    cores[core].queue.insertTail(proc);
+    wakeup(proc);
 }
 
 void Scheduler::dequeue(Process *proc)
 {
-    queue.remove(proc);
-    queuePtr.reset(&queue);
+    remove(proc);
 
-    if (currentProcess == proc)
-        currentProcess = ZERO;
+    for (Size i = 0; i < MAX_CORES; i++)
+    {
+        if (cores[i].current == proc)
+            cores[i].current = ZERO;
+
+        if (cores[i].old == proc)
+            cores[i].old = ZERO;
+    }
+}
+
+void Scheduler::remove(Process *proc)
+{
+    RunQueue *rq = &cores[proc->getCore()];
 
-    if (oldProcess == proc)
-        oldProcess = ZERO;
+    rq->queue.remove(proc);
+    rq->queuePtr.reset(&rq->queue);
 }
 
-Process * Scheduler::findNextReady()
+Size Scheduler::findCore(Process *p)
+{
+    Process *cur;
+
+    for (Size i = 0; i < coreCount; i++)
+    {
+        if (i == currentCore() || !(cur = cores[i].current))
+            continue;
+
+        if (cur == p || (p->getOwner() == p->getID() &&
+                         cur->getOwner() == p->getID()))
+            return i;
+    }
+    return MAX_CORES;
+}
+
+Process * Scheduler::findNextReady(RunQueue *rq)
 {
     Process *ret = ZERO, *saved = ZERO;
 
     while (!ret)
     {
         /* Search the whole list. */
-        while (queuePtr.hasNext())
+        while (rq->queuePtr.hasNext())
         {
             /* Save the current. */
             if (!saved)
-                saved = queuePtr.current();
+                saved = rq->queuePtr.current();
 
             /* We walked the whole list already. */
-            else if (queuePtr.current() == saved)
+            else if (rq->queuePtr.current() == saved)
             {
                 return ret;
             }
             /* Is this process ready? */
-            if (queuePtr.current()->getState() == Ready)
+            if (rq->queuePtr.current()->getState() == Ready)
             {
-                ret = queuePtr.current();
-                queuePtr++;
+                ret = rq->queuePtr.current();
+                rq->queuePtr++;
                 return ret;
             }
             /* Try the next. */
-            queuePtr++;
+            rq->queuePtr++;
+        }
+        /* Nothing queued at all. */
+        if (rq->queue.isEmpty())
+        {
+            return ZERO;
         }
         /* Start again at the front. */
-        queuePtr.reset(&queue);
+        rq->queuePtr.reset(&rq->queue);
     }
     return ret;
 }
 
+Process * Scheduler::steal(Size core)
+{
+    RunQueue *victim;
+    Process *p;
+
+    /* Only cores which can fall back on their idle process. */
+    if (!cores[core].idle)
+    {
+        return ZERO;
+    }
+    /* Visit the other cores, starting at our neighbour. */
+    for (Size i = 1; i < coreCount; i++)
+    {
+        victim = &cores[(core + i) % coreCount];
+
+        for (ListIterator<Process> j(&victim->queue); j.hasNext(); j++)
+        {
+            p = j.current();
+
+            if (p->getState() == Ready && migrate(p, core))
+            {
+                return p;
+            }
+        }
+    }
+    return ZERO;
+}
+
+bool Scheduler::migrate(Process *p, Size core)
+{
+    RunQueue *from = &cores[p->getCore()], *to = &cores[core];
+    ProcessID owner = p->getOwner();
+    Process *q;
+
+    /* Never move an address space which is executing. */
+    if (from->current && from->current->getOwner() == owner)
+    {
+        return false;
+    }
+    /* Move the whole address space. */
+    for (ListIterator<Process> i(&from->queue); i.hasNext(); i++)
+    {
+        if ((q = i.current())->getOwner() == owner)
+        {
+            from->queue.remove(q);
+            to->queue.insertTail(q);
+            q->setCore(core);
+        }
+    }
+    from->queuePtr.reset(&from->queue);
+    return true;
+}
+
 Process * Scheduler::current()
 {
-    return currentProcess;
+    return cores[currentCore()].current;
 }
 
 Process * Scheduler::old()
 {
-    return oldProcess;
+    return cores[currentCore()].old;
+}
+
+Process * Scheduler::getIdle()
+{
+    return cores[currentCore()].idle;
+}
+
+Size Scheduler::setIdle(Process *p)
+{
+    Size core = currentCore();
+
+    /* Serve ourselves first, then the first core without one. */
+    if (cores[core].idle)
+    {
+        for (core = 0; core < coreCount && cores[core].idle; core++)
+            ;
+
+        if (core == coreCount)
+            return MAX_CORES;
+    }
+    remove(p);
+    p->setCore(core);
+    cores[core].idle = p;
+    return core;
+}
+
+void Scheduler::setCoreCount(Size count)
+{
+    coreCount = count;
 }
 
-void Scheduler::setIdle(Process *p)
+Size Scheduler::getCoreCount()
 {
-    idleProcess = p;
-    queue.remove(p);
+    return coreCount;
 }
 
 INITOBJ(Scheduler, scheduler, SCHEDULER)
@@ -17,6 +17,10 @@
 
 #ifndef __KERNEL_SCHEDULER_H
 #define __KERNEL_SCHEDULER_H
+
+/** Maximum number of processor cores. */
+#define MAX_CORES 8
+
 #ifndef __ASSEMBLER__
 
 #include <List.h>
@@ -30,8 +34,38 @@
  * @{
  */
 
+/**
+ * Scheduling state of one processor core.
+ */
+typedef struct RunQueue
+{
+    /** Contains processes waiting to be scheduled on the core. */
+    List<Process> queue;
+
+    /** Points to the next process to be scheduled. */
+    ListIterator<Process> queuePtr;
+
+    /** Currently executing Process. */
+    Process *current;
+
+    /** Previous executing Process. */
+    Process *old;
+
+    /** Process to execute if nothing to do. */
+    Process *idle;
+}
+RunQueue;
+
 /**
  * Responsible for deciding which Process may execute on the CPU(s).
+ *
+ * Every core has its own RunQueue. A core which runs out of work
+ * takes a Ready Process from the queue of another core (work stealing).
+ * The processes sharing an address space stay together on one core,
+ * so that an address space is never active on two cores at once.
+ * Still, other cores change its page tables (e.g. the memory server
+ * releasing pages): those changes are flushed from the TLB of the
+ * core which last loaded the address space.
  */
 class Scheduler : public Singleton<Scheduler>
 {
@@ -43,16 +77,28 @@ class Scheduler : public Singleton<Scheduler>
         Scheduler();
 
         /**
-         * Let the next Process run on a CPU.
+         * Let the next Process run on the executing core.
+         * @param preempted True if the current Process is forced off
+         *                  the CPU, false if it gives it up itself.
          */
-        void executeNext();
+        void executeNext(bool preempted = false);
 
         /**
          * Try to execute the given process.
+         *
+         * A Process queued on another core is taken over, unless that
+         * core executes its address space. Then it is only woken up.
+         *
          * @param p Process pointer.
          */
         void executeAttempt(Process *p);
 
+        /**
+         * Make a Sleeping Process Ready, and interrupt its core if idle.
+         * @param p Process to wake up.
+         */
+        void wakeup(Process *p);
+
         /**
          * Fetch the current process being executed.
          * @return Pointer to the current process.
@@ -65,14 +111,23 @@ class Scheduler : public Singleton<Scheduler>
          */
         Process *old();
 
+        /**
+         * Fetch the idle process of the executing core.
+         * @return Pointer to the idle process, or ZERO if none yet.
+         */
+        Process *getIdle();
+
         /**
          * Determines which process to run if nothing to do.
+         * The executing core is served first, then the first core without one.
          * @param p Process to run if no other processes ready.
+         * @return Core which runs the Process, or MAX_CORES if all have one.
          */
-        void setIdle(Process *p);
+        Size setIdle(Process *p);
 
         /**
          * Puts the given Process in the scheduler queue.
+         * Threads join the queue of their owner.
          * @param proc Process to be scheduler later on.
          */
         void enqueue(Process *proc);
@@ -83,30 +138,102 @@ class Scheduler : public Singleton<Scheduler>
          */
         void dequeue(Process *proc = ZERO);
 
+        /**
+         * Find another core which executes the given Process. For an owner,
+         * any Process sharing its address space counts.
+         * @param p Process to look for.
+         * @return Core number, or MAX_CORES if none.
+         */
+        Size findCore(Process *p);
+
+        /**
+         * Set the number of cores which take part in scheduling.
+         * @param count Number of cores.
+         */
+        void setCoreCount(Size count);
+
+        /**
+         * Get the number of cores which take part in scheduling.
+         * @return Number of cores.
+         */
+        Size getCoreCount();
+
     private:
     
         /**
          * Look for the next Ready process.
+         * @param rq RunQueue to search.
          * @return Pointer to a Ready process, or ZERO if none is Ready yet.
          */
-        Process * findNextReady();
-    
-        /** Contains processes waiting to be scheduled. */
-        List<Process> queue;
-        
-        /** Points to the next process to be scheduled. */
-        ListIterator<Process> queuePtr;
-    
-        /** Currently executing Process. */
-        Process *currentProcess;
+        Process * findNextReady(RunQueue *rq);
+
+        /**
+         * Take a Ready process from the queue of another core.
+         * @param core Core which takes the process.
+         * @return Pointer to the process, or ZERO if none was found.
+         */
+        Process * steal(Size core);
+
+        /**
+         * Move a Process and all processes sharing its address space
+         * to the queue of another core.
+         * @param p Process to move.
+         * @param core Target core.
+         * @return True if moved, false if its address space is executing.
+         */
+        bool migrate(Process *p, Size core);
 
-        /** Previous executing Process. */
-        Process *oldProcess;
+        /**
+         * Delete the current Process of a core, if another core killed it
+         * or its owner while it was executing.
+         * @param rq RunQueue of the executing core.
+         */
+        void reap(RunQueue *rq);
 
-        /** Process to execute if nothing to do. */
-        Process *idleProcess;
+        /**
+         * Take a Process off the queue which holds it.
+         * @param proc Process to remove.
+         */
+        void remove(Process *proc);
+
+        /** Scheduling state per core. */
+        RunQueue cores[MAX_CORES];
+
+        /** Number of cores in use. */
+        Size coreCount;
 };
 
+/**
+ * Get the number of the executing core.
+ * @return Core number, below MAX_CORES.
+ * @note Implemented by the architecture.
+ */
+extern Size currentCore();
+
+/**
+ * Interrupt another core, to let it reschedule.
+ * @param core Core number.
+ * @note Implemented by the architecture.
+ */
+extern void wakeCore(Size core);
+
+/**
+ * Take the kernel lock for the executing core.
+ *
+ * Only one core at a time executes kernel code. The lock is held while
+ * running in the kernel and released when returning to user mode.
+ *
+ * @return True if taken, false if the executing core held it already.
+ * @note Implemented by the architecture.
+ */
+extern C bool lockKernel();
+
+/**
+ * Release the kernel lock.
+ * @note Implemented by the architecture.
+ */
+extern C void unlockKernel();
+
 /** Scheduler instance. */
 extern Scheduler *scheduler;
 
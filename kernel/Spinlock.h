@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_SPINLOCK_H
+#define __KERNEL_SPINLOCK_H
+#ifndef __ASSEMBLER__
+
+#include <Types.h>
+
+/**
+ * @defgroup kernel kernel (generic)
+ * @{
+ */
+
+/**
+ * Lock for data shared by processor cores.
+ *
+ * A core which finds the lock taken busy waits until it is released.
+ * Only hold it for short periods, with interrupts disabled.
+ */
+class Spinlock
+{
+    public:
+
+        /**
+         * Constructor function.
+         */
+        Spinlock() : locked(0)
+        {
+        }
+
+        /**
+         * Wait until the lock is free, then take it.
+         */
+        void lock()
+        {
+            while (__sync_lock_test_and_set(&locked, 1))
+            {
+                /* Wait with plain reads, to keep the cache line shared. */
+                while (locked)
+                    ;
+            }
+        }
+
+        /**
+         * Take the lock, if it is free.
+         * @return True if taken, false if another core holds it.
+         */
+        bool tryLock()
+        {
+            return __sync_lock_test_and_set(&locked, 1) == 0;
+        }
+
+        /**
+         * Release the lock.
+         */
+        void unlock()
+        {
+            __sync_lock_release(&locked);
+        }
+
+    private:
+
+        /** Non-zero while held. */
+        volatile ulong locked;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __ASSEMBLER__ */
+#endif /* __KERNEL_SPINLOCK_H */
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Timer.h"
+#include "Scheduler.h"
+#include "Kernel.h"
+#include <Macros.h>
+
+/** Converts microseconds to timer wheel ticks, rounding up. */
+#define TICKS(usec) \
+    (((usec) >> TIMER_SHIFT) + (((usec) & (TIMER_RESOLUTION - 1)) != 0))
+
+TimerWheel::TimerWheel() : base(0), count(0)
+{
+    for (Size i = 0; i < TIMER_ROOT_SIZE; i++)
+        root[i] = ZERO;
+
+    for (Size l = 0; l < TIMER_LEVELS; l++)
+        for (Size i = 0; i < TIMER_LEVEL_SIZE; i++)
+            levels[l][i] = ZERO;
+}
+
+void TimerWheel::start(Timer *t, Size usec, Size interval)
+{
+    u64 now = systemTime() >> TIMER_SHIFT;
+
+    stop(t);
+
+    /* Nothing to expire in between: skip ahead. */
+    if (!count)
+        base = now;
+
+    /* The current tick is partly over: never expire early. */
+    t->fired    = 0;
+    t->expires  = now + TICKS(usec) + 1;
+    t->interval = TICKS(interval);
+    insert(t);
+}
+
+void TimerWheel::stop(Timer *t)
+{
+    if (!t->slot)
+        return;
+
+    if (t->prev)
+        t->prev->next = t->next;
+    else
+        *t->slot = t->next;
+
+    if (t->next)
+        t->next->prev = t->prev;
+
+    t->slot = ZERO;
+    count--;
+}
+
+void TimerWheel::insert(Timer *t)
+{
+    u64 delta = t->expires - base, when = t->expires;
+    Size shift = TIMER_ROOT_BITS;
+    Timer **slot;
+
+    /* Overdue Timers expire with the next tick. */
+    if (t->expires < base)
+        slot = &root[base & (TIMER_ROOT_SIZE - 1)];
+
+    else if (delta < TIMER_ROOT_SIZE)
+        slot = &root[when & (TIMER_ROOT_SIZE - 1)];
+
+    else
+    {
+        /* Too far ahead: wait in the last slot, then go round again. */
+        if (delta > TIMER_MAX_TICKS)
+            when = base + TIMER_MAX_TICKS;
+
+        for (Size l = 0; ; l++, shift += TIMER_LEVEL_BITS)
+        {
+            if (l == TIMER_LEVELS - 1 ||
+                delta < ((u64) 1 << (shift + TIMER_LEVEL_BITS)))
+            {
+                slot = &levels[l][(when >> shift) & (TIMER_LEVEL_SIZE - 1)];
+                break;
+            }
+        }
+    }
+    /* Link it in front. */
+    t->prev = ZERO;
+    t->next = *slot;
+    t->slot = slot;
+
+    if (*slot)
+        (*slot)->prev = t;
+
+    *slot = t;
+    count++;
+}
+
+void TimerWheel::cascade(Size level, Size index)
+{
+    Timer *t = levels[level][index], *next;
+
+    levels[level][index] = ZERO;
+
+    for (; t; t = next)
+    {
+        next = t->next;
+        count--;
+        insert(t);
+    }
+}
+
+void TimerWheel::expire(u64 now)
+{
+    u64 to = now >> TIMER_SHIFT;
+    Size index, i;
+    Timer *t, *next;
+
+    while (base <= to)
+    {
+        /* Nothing to expire in between: skip ahead. */
+        if (!count)
+        {
+            base = to + 1;
+            break;
+        }
+        /* Bring down the next slot of each level which wrapped around. */
+        if (!(index = base & (TIMER_ROOT_SIZE - 1)))
+        {
+            for (Size l = 0; l < TIMER_LEVELS; l++)
+            {
+                i = (base >> (TIMER_ROOT_BITS + l * TIMER_LEVEL_BITS)) &
+                    (TIMER_LEVEL_SIZE - 1);
+                cascade(l, i);
+
+                if (i)
+                    break;
+            }
+        }
+        /* Take the slot of this tick. */
+        t = root[index];
+        root[index] = ZERO;
+        base++;
+
+        for (; t; t = next)
+        {
+            next    = t->next;
+            t->slot = ZERO;
+            count--;
+
+            /* Not yet due, after waiting in the last slot. */
+            if (t->expires >= base)
+            {
+                insert(t);
+                continue;
+            }
+            t->fired++;
+
+            if (t->interval)
+            {
+                t->expires += t->interval;
+                insert(t);
+            }
+            scheduler->wakeup(t->owner);
+        }
+    }
+}
+
+bool TimerWheel::nextExpiry(u64 *usec)
+{
+    u64 tick = base;
+
+    if (!count)
+        return false;
+
+    /* Look ahead until the first level wraps around. */
+    do
+    {
+        if (root[tick & (TIMER_ROOT_SIZE - 1)])
+            break;
+    }
+    while (++tick & (TIMER_ROOT_SIZE - 1));
+
+    *usec = tick << TIMER_SHIFT;
+    return true;
+}
+
+INITOBJ(TimerWheel, timers, SCHEDULER)
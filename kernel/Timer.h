@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __KERNEL_TIMER_H
+#define __KERNEL_TIMER_H
+#ifndef __ASSEMBLER__
+
+#include <Singleton.h>
+#include <Macros.h>
+#include <Types.h>
+
+/**
+ * @defgroup kernel kernel (generic)
+ * @{
+ */
+
+/** Length of one timer wheel tick, in microseconds (about a millisecond). */
+#define TIMER_RESOLUTION  1024
+
+/** Shift which converts microseconds to timer wheel ticks. */
+#define TIMER_SHIFT       10
+
+/** Number of bits of the timer wheel ticks indexing the first level. */
+#define TIMER_ROOT_BITS   8
+
+/** Number of bits of the timer wheel ticks indexing each higher level. */
+#define TIMER_LEVEL_BITS  6
+
+/** Number of levels above the first. */
+#define TIMER_LEVELS      3
+
+/** Slots in the first level. */
+#define TIMER_ROOT_SIZE   (1 << TIMER_ROOT_BITS)
+
+/** Slots in each higher level. */
+#define TIMER_LEVEL_SIZE  (1 << TIMER_LEVEL_BITS)
+
+/** Longest distance between two expiries, in timer wheel ticks. */
+#define TIMER_MAX_TICKS   ((1 << (TIMER_ROOT_BITS + \
+                                  TIMER_LEVELS * TIMER_LEVEL_BITS)) - 1)
+
+/** @see Process.h */
+class Process;
+
+/**
+ * Wakes up a Process after some time, once or periodically.
+ *
+ * An expiry only counts in Timer::fired and wakes the owner:
+ * the owner decides what the expiry means.
+ */
+class Timer
+{
+    public:
+
+        /**
+         * Constructor function.
+         * @param p Process to wake up.
+         * @param i Identifier of the timer within its owner.
+         */
+        Timer(Process *p, ulong i = 0)
+            : owner(p), id(i), fired(0), expires(0), interval(0),
+              slot(ZERO), prev(ZERO), next(ZERO)
+        {
+        }
+
+        /**
+         * Check if the Timer is waiting to expire.
+         * @return True if started, false otherwise.
+         */
+        bool isActive()
+        {
+            return slot != ZERO;
+        }
+
+        /**
+         * Comparison operator.
+         * @param t Timer to compare with.
+         * @return True if equal, false otherwise.
+         */
+        bool operator == (Timer *t)
+        {
+            return this == t;
+        }
+
+        /** Process to wake up. */
+        Process *owner;
+
+        /** Identifier of the timer within its owner. */
+        ulong id;
+
+        /** Number of expiries not yet handled by the owner. */
+        Size fired;
+
+        /** Timer wheel tick at which the Timer expires. */
+        u64 expires;
+
+        /** Timer wheel ticks between expiries, or zero if not periodic. */
+        Size interval;
+
+        /** Head of the list in the wheel, or ZERO if not started. */
+        Timer **slot;
+
+        /** Previous and next Timer in the same slot. */
+        Timer *prev, *next;
+};
+
+/**
+ * Keeps the Timers of all processes (hierarchical timer wheel).
+ *
+ * Timers expiring within TIMER_ROOT_SIZE ticks have a slot each in the
+ * first level. Later ones are kept per TIMER_LEVEL_SIZE times coarser
+ * slot in a higher level, and move down each time the level below
+ * wraps around. Starting, stopping and expiring a Timer are constant
+ * time; the wheel advances one slot per tick elapsed, skipping idle
+ * stretches while empty.
+ */
+class TimerWheel : public Singleton<TimerWheel>
+{
+    public:
+
+        /**
+         * Constructor function.
+         */
+        TimerWheel();
+
+        /**
+         * Start a Timer. A started Timer is restarted.
+         * @param t Timer to start.
+         * @param usec Microseconds until the first expiry.
+         * @param interval Microseconds between later expiries,
+         *                 or zero to expire only once.
+         */
+        void start(Timer *t, Size usec, Size interval = 0);
+
+        /**
+         * Stop a Timer, if started.
+         * @param t Timer to stop.
+         */
+        void stop(Timer *t);
+
+        /**
+         * Expire all Timers which are due.
+         * @param now Microseconds since boot.
+         */
+        void expire(u64 now);
+
+        /**
+         * Find the time at which expire() must be called next.
+         *
+         * This is the earliest expiry, or earlier if that is not yet
+         * known because the Timer waits in a higher level.
+         *
+         * @param usec Receives microseconds since boot.
+         * @return True if any Timer is started, false otherwise.
+         */
+        bool nextExpiry(u64 *usec);
+
+    private:
+
+        /**
+         * Put a Timer in the slot for its expiry.
+         * @param t Timer with Timer::expires set.
+         */
+        void insert(Timer *t);
+
+        /**
+         * Move the Timers in a slot of a higher level to lower levels.
+         * @param level Level above the first, starting at zero.
+         * @param index Slot in the level.
+         */
+        void cascade(Size level, Size index);
+
+        /** Slots of the first level, one per tick. */
+        Timer *root[TIMER_ROOT_SIZE];
+
+        /** Slots of the higher levels. */
+        Timer *levels[TIMER_LEVELS][TIMER_LEVEL_SIZE];
+
+        /** Next tick to expire. */
+        u64 base;
+
+        /** Number of started Timers. */
+        Size count;
+};
+
+/**
+ * Get the time since boot.
+ * @return Microseconds since boot.
+ * @note Implemented by the architecture.
+ */
+extern u64 systemTime();
+
+/** TimerWheel instance. */
+extern TimerWheel *timers;
+
+/**
+ * @}
+ */
+
+#endif /* __ASSEMBLER__ */
+#endif /* __KERNEL_TIMER_H */
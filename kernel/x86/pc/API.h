@@ -20,12 +20,68 @@
 
 #include <Types.h>
 #include <FreeNOS/API.h>
+#include <FreeNOS/InfoPage.h>
 
 /**  
  * @defgroup x86kernel kernel (x86) 
  * @{  
  */
 
+/**
+ * Check if the fast system call entry may be used.
+ * @see ProcessPage
+ */
+#define FAST_SYSTEM_CALL \
+    (((ProcessPage *) PROCESS_PAGE_ADDR)->fastSystemCall)
+
+/**
+ * Perform a kernel trap using the int 0x90 trap gate.
+ * @param num Unique number of the handler to execute.
+ * @param arg1 First argument becomes ECX.
+ * @param arg2 Second argument becomes EBX.
+ * @param arg3 Third argument becomes EDX.
+ * @param arg4 Fourth argument becomes ESI.
+ * @param arg5 Fifth argument becomes EDI.
+ * @return An integer.
+ */
+inline ulong trapKernelInterrupt(ulong num, ulong arg1, ulong arg2,
+				 ulong arg3, ulong arg4, ulong arg5)
+{
+    ulong ret;
+    asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
+				 "d"(arg3), "S"(arg4), "D"(arg5) : "memory");
+    return ret;
+}
+
+/**
+ * Perform a kernel trap using SYSENTER.
+ *
+ * The kernel returns to the address pushed on our stack, which
+ * EBP points to, and pops it. Only EBP and the segments are preserved.
+ *
+ * @param num Unique number of the handler to execute.
+ * @param arg1 First argument becomes ECX.
+ * @param arg2 Second argument becomes EBX.
+ * @param arg3 Third argument becomes EDX.
+ * @param arg4 Fourth argument becomes ESI.
+ * @param arg5 Fifth argument becomes EDI.
+ * @return An integer.
+ * @see FAST_SYSTEM_CALL
+ */
+inline ulong trapKernelSysEnter(ulong num, ulong arg1, ulong arg2,
+				ulong arg3, ulong arg4, ulong arg5)
+{
+    asm volatile ("pushl %%ebp\n"
+		  "pushl $1f\n"
+		  "movl %%esp, %%ebp\n"
+		  "sysenter\n"
+		  "1:\n"
+		  "popl %%ebp\n"
+		  : "+a"(num), "+c"(arg1), "+b"(arg2), "+d"(arg3),
+		    "+S"(arg4), "+D"(arg5) :: "memory");
+    return num;
+}
+
 /** 
  * Perform a kernel trap with 1 argument.
  * @param num Unique number of the handler to execute. 
@@ -35,6 +91,10 @@
 inline ulong trapKernel1(ulong num, ulong arg1)
 {
     ulong ret;
+
+    if (FAST_SYSTEM_CALL)
+	return trapKernelSysEnter(num, arg1, 0, 0, 0, 0);
+
     asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1));
     return ret;
 }
@@ -50,6 +110,10 @@ inline ulong trapKernel1(ulong num, ulong arg1)
 inline ulong trapKernel3(ulong num, ulong arg1, ulong arg2, ulong arg3)
 {
     ulong ret;
+
+    if (FAST_SYSTEM_CALL)
+	return trapKernelSysEnter(num, arg1, arg2, arg3, 0, 0);
+
     asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
 					    "d"(arg3));
     return ret;
@@ -68,6 +132,10 @@ inline ulong trapKernel4(ulong num, ulong arg1, ulong arg2, ulong arg3,
 			 ulong arg4)
 {
     ulong ret;
+
+    if (FAST_SYSTEM_CALL)
+	return trapKernelSysEnter(num, arg1, arg2, arg3, arg4, 0);
+
     asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
 					    "d"(arg3), "S"(arg4));
     return ret;
@@ -86,10 +154,10 @@ inline ulong trapKernel4(ulong num, ulong arg1, ulong arg2, ulong arg3,
 inline ulong trapKernel5(ulong num, ulong arg1, ulong arg2, ulong arg3,
 			 ulong arg4, ulong arg5)
 {
-    ulong ret;
-    asm volatile ("int $0x90" : "=a"(ret) : "a"(num), "c"(arg1), "b"(arg2),
-				 "d"(arg3), "S"(arg4), "D"(arg5));
-    return ret;
+    if (FAST_SYSTEM_CALL)
+	return trapKernelSysEnter(num, arg1, arg2, arg3, arg4, arg5);
+
+    return trapKernelInterrupt(num, arg1, arg2, arg3, arg4, arg5);
 }
 
 /**
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "APIC.h"
+#include "CPU.h"
+#include "Kernel.h"
+#include "Memory.h"
+
+/**
+ * Virtual address of the local APIC registers.
+ * The physical page behind it is never used.
+ */
+static u8 apicWindow[PAGESIZE] ALIGN(PAGESIZE);
+
+APIC::APIC() : regs(ZERO), timerCount(0), tscCount(0)
+{
+}
+
+void APIC::setAddress(Address paddr)
+{
+    memory->mapVirtual(paddr, (Address) apicWindow,
+                       PAGE_PRESENT | PAGE_RW | PAGE_UNCACHED |
+                       PAGE_PINNED  | PAGE_GLOBAL);
+    regs = (volatile u32 *) (apicWindow + (paddr & ~PAGEMASK));
+}
+
+u32 APIC::read(u32 reg)
+{
+    return regs[reg / sizeof(u32)];
+}
+
+void APIC::write(u32 reg, u32 value)
+{
+    regs[reg / sizeof(u32)] = value;
+}
+
+u8 APIC::getID()
+{
+    return read(APIC_ID) >> 24;
+}
+
+void APIC::enable(bool boot)
+{
+    /* Accept all interrupts. */
+    write(APIC_TPR, 0);
+    write(APIC_SVR, APIC_SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+
+    /* The PICs only deliver to the boot core, as set up by the BIOS. */
+    if (!boot)
+    {
+        write(APIC_LVT_LINT0, APIC_LVT_MASKED);
+        write(APIC_LVT_LINT1, APIC_LVT_MASKED);
+    }
+    write(APIC_LVT_ERROR, APIC_LVT_MASKED);
+
+    /* One-shot timer, not yet started. */
+    write(APIC_TIMER_DIVIDE, APIC_TIMER_DIV16);
+    write(APIC_LVT_TIMER, APIC_TIMER_VECTOR);
+    write(APIC_TIMER_INIT, 0);
+}
+
+void APIC::sendEOI()
+{
+    write(APIC_EOI, 0);
+}
+
+void APIC::sendIPI(u8 id, u32 command)
+{
+    write(APIC_ICR_HIGH, id << 24);
+    write(APIC_ICR_LOW, command);
+
+    /* Wait until the target accepted it. */
+    while (read(APIC_ICR_LOW) & APIC_ICR_PENDING)
+        ;
+}
+
+void APIC::calibrate()
+{
+    u64 tsc;
+
+    /* Count down for 10 milliseconds, without interrupting. */
+    write(APIC_LVT_TIMER, APIC_LVT_MASKED);
+    write(APIC_TIMER_INIT, 0xffffffff);
+    tsc = timestamp();
+    wait(10000);
+    tscCount   = timestamp() - tsc;
+    timerCount = 0xffffffff - read(APIC_TIMER_CURRENT);
+
+    write(APIC_TIMER_INIT, 0);
+    write(APIC_LVT_TIMER, APIC_TIMER_VECTOR);
+}
+
+u64 APIC::getTscFrequency()
+{
+    return tscCount * 100;
+}
+
+void APIC::setTimer(Size usec)
+{
+    u32 perMsec = timerCount / 10;
+    u32 count;
+
+    if (usec > APIC_TIMER_MAX)
+        usec = APIC_TIMER_MAX;
+
+    /* Split up, to stay within 32-bit. */
+    count = (usec / 1000) * perMsec + (usec % 1000) * perMsec / 1000;
+
+    /* Zero stops the timer: always wait at least one count. */
+    write(APIC_TIMER_INIT, usec && !count ? 1 : count);
+}
+
+void APIC::wait(Size usec)
+{
+    Size count;
+
+    while (usec)
+    {
+        count = usec < PIT_WAIT_MAX ? usec : PIT_WAIT_MAX;
+        usec -= count;
+        count = count * PIT_PER_MSEC / 1000;
+
+        /* Channel 2 in one-shot mode, with the speaker off. */
+        outb(PIT_GATE, inb(PIT_GATE) & ~0x03);
+        outb(PIT_CMD, 0xb0);
+        outb(PIT_CHAN2, count & 0xff);
+        outb(PIT_CHAN2, count >> 8);
+        outb(PIT_GATE, inb(PIT_GATE) | 0x01);
+
+        /* The output goes high when the count reaches zero. */
+        while (!(inb(PIT_GATE) & 0x20))
+            ;
+    }
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __X86_APIC_H
+#define __X86_APIC_H
+
+/**   
+ * @defgroup x86kernel kernel (x86)  
+ * @{   
+ */
+
+/** Interrupt vector of the local APIC timer. */
+#define APIC_TIMER_VECTOR    48
+
+/** Interrupt vector of the reschedule IPI. */
+#define APIC_IPI_VECTOR      49
+
+/** Interrupt vector of spurious local APIC interrupts. */
+#define APIC_SPURIOUS_VECTOR 255
+
+/** Local APIC ID register. */
+#define APIC_ID         0x20
+
+/** Task priority register. */
+#define APIC_TPR        0x80
+
+/** End of interrupt register. */
+#define APIC_EOI        0xb0
+
+/** Spurious interrupt vector register. */
+#define APIC_SVR        0xf0
+
+/** Interrupt command register (low and high half). */
+#define APIC_ICR_LOW    0x300
+#define APIC_ICR_HIGH   0x310
+
+/** Local vector table entries. */
+#define APIC_LVT_TIMER  0x320
+#define APIC_LVT_LINT0  0x350
+#define APIC_LVT_LINT1  0x360
+#define APIC_LVT_ERROR  0x370
+
+/** Timer counter registers. */
+#define APIC_TIMER_INIT    0x380
+#define APIC_TIMER_CURRENT 0x390
+#define APIC_TIMER_DIVIDE  0x3e0
+
+/** Software enable bit in the spurious interrupt vector register. */
+#define APIC_SVR_ENABLE   (1 << 8)
+
+/** Masks a local vector table entry. */
+#define APIC_LVT_MASKED   (1 << 16)
+
+/** Timer counts at the bus clock divided by 16. */
+#define APIC_TIMER_DIV16  0x3
+
+/** Set in the ICR while the IPI is not yet accepted. */
+#define APIC_ICR_PENDING  (1 << 12)
+
+/** Inter-processor interrupt commands, asserted. */
+#define APIC_IPI_FIXED    0x4000
+#define APIC_IPI_INIT     0x4500
+#define APIC_IPI_STARTUP  0x4600
+
+/** Longest timer interval, in microseconds. */
+#define APIC_TIMER_MAX    1000000
+
+/** PIT counts per millisecond, rounded down. */
+#define PIT_PER_MSEC      1193
+
+/** Longest single PIT wait, in microseconds. */
+#define PIT_WAIT_MAX      50000
+
+#ifndef __ASSEMBLER__
+
+#include <Types.h>
+#include <Macros.h>
+
+/**
+ * Local Advanced Programmable Interrupt Controller.
+ *
+ * Every core has its own local APIC, all at the same physical address.
+ * It delivers the timer and inter-processor interrupts. Device IRQs
+ * still arrive through the i8259 PICs on the boot core. The timer runs
+ * in one-shot mode: it only interrupts at the next deadline.
+ */
+class APIC
+{
+    public:
+
+        /**
+         * Constructor function.
+         */
+        APIC();
+
+        /**
+         * Map the registers of the local APIC.
+         * @param paddr Physical address of the registers.
+         */
+        void setAddress(Address paddr);
+
+        /**
+         * Read a register.
+         * @param reg Register offset.
+         * @return Register value.
+         */
+        u32 read(u32 reg);
+
+        /**
+         * Write a register.
+         * @param reg Register offset.
+         * @param value Value to write.
+         */
+        void write(u32 reg, u32 value);
+
+        /**
+         * Get the local APIC ID of the executing core.
+         * @return APIC identifier.
+         */
+        u8 getID();
+
+        /**
+         * Enable the local APIC of the executing core.
+         * @param boot True on the boot core, which keeps LINT0 for the PIC.
+         */
+        void enable(bool boot);
+
+        /**
+         * Signal the end of the current interrupt.
+         */
+        void sendEOI();
+
+        /**
+         * Send an inter-processor interrupt.
+         * @param id APIC identifier of the target core.
+         * @param command One of the APIC_IPI commands, or'ed with a vector.
+         */
+        void sendIPI(u8 id, u32 command);
+
+        /**
+         * Measure the timer and the timestamp counter against the PIT.
+         * All cores share the result.
+         */
+        void calibrate();
+
+        /**
+         * Get the timestamp counter frequency measured by calibrate().
+         * @return Timestamp counter ticks per second.
+         */
+        u64 getTscFrequency();
+
+        /**
+         * Interrupt the executing core once, after the given interval.
+         * @param usec Microseconds until the interrupt, or zero to cancel.
+         *             Longer than APIC_TIMER_MAX waits APIC_TIMER_MAX.
+         */
+        void setTimer(Size usec);
+
+        /**
+         * Busy wait using PIT channel 2.
+         * @param usec Microseconds to wait.
+         */
+        static void wait(Size usec);
+
+    private:
+
+        /** Virtual address of the registers. */
+        volatile u32 *regs;
+
+        /** Timer counts in 10 milliseconds. */
+        u32 timerCount;
+
+        /** Timestamp counter ticks in 10 milliseconds. */
+        u64 tscCount;
+};
+
+#endif /* __ASSEMBLER__ */
+
+/**
+ * @}
+ */
+
+#endif /* __X86_APIC_H */
@@ -34,6 +34,12 @@
 /** Timestamp Counter Disable. */
 #define CR4_TSD		0x00000004
 
+/** Page Size Extensions (4MB pages). */
+#define CR4_PSE		0x00000010
+
+/** Page Global Enable. */
+#define CR4_PGE		0x00000080
+
 /** Kernel Code Segment. */
 #define KERNEL_CS       1 
 #define KERNEL_CS_SEL   0x8 
@@ -54,6 +60,23 @@
 #define USER_TSS        5 
 #define USER_TSS_SEL    0x28 
 
+/** SYSENTER model specific registers. */
+#define SYSENTER_CS_MSR  0x174
+#define SYSENTER_ESP_MSR 0x175
+#define SYSENTER_EIP_MSR 0x176
+
+/** CPUID feature flag (EDX) for SYSENTER and SYSEXIT. */
+#define CPUID_SEP       (1 << 11)
+
+/** CPUID feature flag (EDX) for 4MB pages. */
+#define CPUID_PSE       (1 << 3)
+
+/** CPUID feature flag (EDX) for an on-chip local APIC. */
+#define CPUID_APIC      (1 << 9)
+
+/** CPUID feature flag (EDX) for global pages. */
+#define CPUID_PGE       (1 << 13)
+
 #ifndef __ASSEMBLER__
 
 #include <Types.h>
@@ -72,13 +95,99 @@
  */
 #define timestamp() \
     ({ \
-	u64 low = 0, high = 0; \
-	asm volatile ("rdtsc\n" \
-		      "movl %%eax, %0\n" \
-		      "movl %%edx, %1\n" : "=r"(low), "=r"(high)); \
-	(u64) (high << 32) | (low); \
+	u32 low, high; \
+	asm volatile ("rdtsc" : "=a"(low), "=d"(high)); \
+	((u64) high << 32) | (low); \
     })
 
+/**
+ * Divide a 64-bit number by a 32-bit divisor.
+ * The kernel has no libgcc for 64-bit division, so use DIV twice.
+ * @param n Dividend.
+ * @param d Divisor, not zero.
+ * @return 64-bit quotient.
+ */
+#define div64(n,d) \
+    ({ \
+	u64 __n = (n); \
+	u32 __d = (d), __hi = (u32) (__n >> 32), __lo = (u32) __n, __ql, __r; \
+	u32 __qh = __hi / __d; \
+	__r = __hi % __d; \
+	asm ("divl %4" : "=a"(__ql), "=d"(__r) : "a"(__lo), "d"(__r), "rm"(__d)); \
+	((u64) __qh << 32) | __ql; \
+    })
+
+/**
+ * Divide a 64-bit number by a 64-bit divisor.
+ * Divisors above 32 bits leave a quotient below 2^32, which is
+ * found with shift and subtract.
+ * @param n Dividend.
+ * @param d Divisor, not zero.
+ * @return 64-bit quotient.
+ */
+inline u64 udiv64(u64 n, u64 d)
+{
+    u64 q = 0;
+    int shift = 0;
+
+    if (!(d >> 32))
+	return div64(n, d);
+
+    /* Line up the divisor with the top of the dividend. */
+    while (!(d >> 63) && (d << 1) <= n)
+    {
+	d <<= 1;
+	shift++;
+    }
+    for (; shift >= 0; shift--, d >>= 1)
+    {
+	q <<= 1;
+
+	if (n >= d)
+	{
+	    n -= d;
+	    q |= 1;
+	}
+    }
+    return q;
+}
+
+/**
+ * Write a model specific register.
+ * @param msr Register number.
+ * @param value 64-bit value to write.
+ */
+#define wrmsr(msr,value) \
+    asm volatile ("wrmsr" :: "c"(msr), "a"((u32) (value)), \
+			     "d"((u32) ((u64) (value) >> 32)))
+
+/**
+ * Query processor identification and features.
+ * @param leaf Information to query, in EAX.
+ * @param a Receives EAX.
+ * @param b Receives EBX.
+ * @param c Receives ECX.
+ * @param d Receives EDX.
+ */
+#define cpuid(leaf,a,b,c,d) \
+    asm volatile ("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(leaf))
+
+/**
+ * Set bits in control register 4.
+ * @param bits Bits to set.
+ */
+#define cr4_set(bits) \
+    asm volatile ("mov %%cr4, %%eax\n" \
+		  "orl %0, %%eax\n" \
+		  "mov %%eax, %%cr4\n" :: "r"(bits) : "eax")
+
+/**
+ * Read the faulting address of the last page fault.
+ * @return Value of control register 2.
+ */
+#define cr2() \
+    ({ ulong cr2; asm volatile ("mov %%cr2, %0" : "=r"(cr2)); cr2; })
+
 /**
  * Reboot the system (by sending the a reset signal on the keyboard I/O port)
  */
@@ -133,6 +242,18 @@
     w; \
 })
 
+/**
+ * Read a long from a port.
+ * @param port The I/O port to read from.
+ * @return Long 32-bit number read from the port.
+ */
+#define inl(port) \
+({ \
+    unsigned int l; \
+    asm volatile ("inl %%dx, %%eax" : "=a" (l) : "d" (port)); \
+    l; \
+})
+
 /**  
  * Output a byte to a port.  
  * @param port Port to write to.  
@@ -85,6 +85,13 @@ typedef void InterruptHandler(CPUState *state, ulong param);
  */
 typedef struct InterruptHook
 {
+    /**
+     * Default constructor function.
+     */
+    InterruptHook() : handler(ZERO), param(0)
+    {
+    }
+
     /**
      * Constructor function.
      * @param h Handler function for the hook.
@@ -112,6 +119,22 @@ typedef struct InterruptHook
 }
 InterruptHook;
 
+/** Maximum number of hooks on one interrupt vector. */
+#define MAX_INTERRUPT_HOOKS 4
+
+/**
+ * Fixed size table of the hooks on one interrupt vector.
+ */
+typedef struct InterruptVector
+{
+    /** Hooks, executed in order. */
+    InterruptHook hooks[MAX_INTERRUPT_HOOKS];
+
+    /** Number of hooks in use. */
+    Size count;
+}
+InterruptVector;
+
 /**
  * Called by assembler routine invokeHandler() in boot.S.
  * @param state CPU registers pushed on the stack.
@@ -17,38 +17,50 @@
 
 #include <FreeNOS/API.h>
 #include <FreeNOS/Scheduler.h>
+#include <FreeNOS/Timer.h>
+#include <FreeNOS/KernelHeap.h>
 #include <Macros.h>
-#include <List.h>
-#include <ListIterator.h>
-#include <Array.h>
 #include "Kernel.h"
 #include "CPU.h"
 #include "Interrupt.h"
 #include "Memory.h"
 
-/** Interrupt handlers. */
-Array<List<InterruptHook> > interrupts(256);
+/** Interrupt handlers, indexed by vector. */
+InterruptVector interrupts[256];
 
 /** API handlers. */
-Array<APIHandler> apis(16);
+APIHandler *apis[MAX_APIS];
+
+/** API invocation counters. */
+APIStats apiStats[MAX_APIS];
+
+/** Physical page of the system clock. Must not be shared with other data. */
+static u8 clockPageFrame[PAGESIZE] ALIGN(PAGESIZE);
+
+/** System clock. */
+ClockPage *clockPage = (ClockPage *) clockPageFrame;
 
 void executeInterrupt(CPUState state)
 {
-    /* Fetch the list of interrupt hooks (for this vector). */
-    List<InterruptHook> *lst = interrupts[state.vector];
-        
-    /* Does at least one handler exist? */
-    if (!lst) return;
-    
-    /* Execute them all. */
-    for (ListIterator<InterruptHook> i(lst); i.hasNext(); i.next())
+    InterruptVector *vec = &interrupts[state.vector];
+    bool locked = lockKernel();
+
+    /* Execute all hooks of this vector. */
+    for (Size i = 0; i < vec->count; i++)
     {
-        i.current()->handler(&state, i.current()->param);
+        vec->hooks[i].handler(&state, vec->hooks[i].param);
     }
+    /* Keep the lock if it was held before the interrupt. */
+    if (locked)
+        unlockKernel();
 }
 
-X86Kernel::X86Kernel() : Kernel(), ticks(0)
+X86Kernel::X86Kernel() : Kernel(), sysEnter(false),
+                         tickless(smp->isEnabled()), bootTsc(0)
 {
+    /* Keep processes in their own cache. */
+    kernelHeap->addCache(sizeof(X86Process));
+
     /* ICW1: Initialize PIC's (Edge triggered, Cascade) */
     outb(PIC1_CMD, 0x11);
     outb(PIC2_CMD, 0x11);
@@ -74,9 +86,13 @@ X86Kernel::X86Kernel() : Kernel(), ticks(0)
     outb(PIT_CHAN0, PIT_DIVISOR & 0xff);
     outb(PIT_CHAN0, PIT_DIVISOR >> 8);
     
-    /* Make sure to enable PIC2 and the i8253. */
+    /* Make sure to enable PIC2, and the i8253 without local APICs. */
     enableIRQ(2, true);
-    enableIRQ(0, true);
+    enableIRQ(0, !tickless);
+
+    /* Start the system clock. */
+    clockPage->tickHz   = tickless ? 0 : PIT_HZ;
+    clockPage->bootTime = readTimeOfDay();
 
     /* Setup exception handlers. */
     for (int i = 0; i < 17; i++)
@@ -94,41 +110,204 @@ X86Kernel::X86Kernel() : Kernel(), ticks(0)
         else
             hookInterrupt(i, interrupt, 0);
     }
-    /* Install PIT (i8253) IRQ handler. */
-    hookInterrupt(IRQ(0), clocktick, 0);
+    /* Install the clock handler, of the i8253 or the local APIC timers. */
+    if (tickless)
+    {
+        hookInterrupt(APIC_TIMER_VECTOR, clocktick, 0);
+        hookInterrupt(APIC_IPI_VECTOR, reschedule, 0);
+    }
+    else
+        hookInterrupt(IRQ(0), clocktick, 0);
+
+    /* Prepare the boot core. */
+    initializeCore();
+
+    /* The tickless clock follows the timestamp counter. */
+    if (tickless)
+    {
+        smp->getAPIC()->calibrate();
+        clockPage->tscFrequency = smp->getAPIC()->getTscFrequency();
+        clockPage->tscBase      = bootTsc = timestamp();
+    }
+    /* Start the other cores. */
+    smp->startCores();
+}
+
+void X86Kernel::initializeCore()
+{
+    Size core = currentCore();
+    CoreInfo *info = smp->getCore(core);
+    Address tss = (Address) info->tss;
 
     /* Initialize TSS Segment. */
-    gdt[USER_TSS].limitLow    = sizeof(TSS) + (0xfff / 8);
-    gdt[USER_TSS].baseLow     = ((Address) &kernelTss) & 0xffff;
-    gdt[USER_TSS].baseMid     = (((Address) &kernelTss) >> 16) & 0xff;
-    gdt[USER_TSS].type        = 9;
-    gdt[USER_TSS].privilege  = 0;
-    gdt[USER_TSS].present     = 1;
-    gdt[USER_TSS].limitHigh   = 0;
-    gdt[USER_TSS].granularity = 8;
-    gdt[USER_TSS].baseHigh    = (((Address) &kernelTss) >> 24) & 0xff;
+    gdt[USER_TSS + core].limitLow    = sizeof(TSS) + (0xfff / 8);
+    gdt[USER_TSS + core].baseLow     = tss & 0xffff;
+    gdt[USER_TSS + core].baseMid     = (tss >> 16) & 0xff;
+    gdt[USER_TSS + core].type        = 9;
+    gdt[USER_TSS + core].privilege  = 0;
+    gdt[USER_TSS + core].present     = 1;
+    gdt[USER_TSS + core].limitHigh   = 0;
+    gdt[USER_TSS + core].granularity = 8;
+    gdt[USER_TSS + core].baseHigh    = (tss >> 24) & 0xff;
 
     /* Let TSS point to I/O bitmap page. */
-    kernelTss.bitmap = PAGESIZE << 16;
+    info->tss->ss0    = KERNEL_DS_SEL;
+    info->tss->bitmap = PAGESIZE << 16;
 
     /* Load Task State Register. */
-    ltr(USER_TSS_SEL);
+    ltr(USER_TSS_SEL + (core * sizeof(Segment)));
+
+    /* Use the fast system call entry, if possible. */
+    sysEnter = setupSysEnter(info);
+
+    /* Let the local APIC timer drive the clock. */
+    if (tickless)
+    {
+        smp->getAPIC()->enable(core == 0);
+    }
+}
+
+void X86Kernel::startSlice(Process *p)
+{
+    CoreInfo *core = smp->getCore(currentCore());
+
+    /* Count ticks without local APIC. */
+    if (!tickless)
+    {
+        core->ticks      = 0;
+        core->sliceTicks = p ? CEIL(p->getQuantum() * PIT_HZ, 1000000) : 1;
+        return;
+    }
+    /* The process may read the clock right away. */
+    updateClock();
+
+    if (!p || p == scheduler->getIdle())
+        core->sliceEnd = 0;
+    else
+        core->sliceEnd = timestamp() +
+            div64((u64) p->getQuantum() * clockPage->tscFrequency, 1000000);
+
+    armTimer(core);
+}
+
+bool X86Kernel::sliceExpired(CoreInfo *core)
+{
+    if (!tickless)
+        return ++core->ticks >= core->sliceTicks;
+    else
+        return core->sliceEnd && timestamp() >= core->sliceEnd;
 }
 
-void X86Kernel::hookInterrupt(int vec, InterruptHandler h, ulong p)
+void X86Kernel::armTimer(CoreInfo *core)
 {
+    u64 now = timestamp(), wait = ~((u64) 0), expiry, uptime;
+
+    if (!tickless)
+    {
+        return;
+    }
+    /* Microseconds until the end of the slice, if any. */
+    if (core->sliceEnd)
+    {
+        wait = core->sliceEnd <= now ? 0 :
+               udiv64((core->sliceEnd - now) * 1000000, clockPage->tscFrequency);
+    }
+    /* Or until the next timer, if sooner. */
+    if (timers->nextExpiry(&expiry))
+    {
+        uptime = getUptime();
+
+        if (expiry <= uptime)
+            wait = 0;
+        else if (expiry - uptime < wait)
+            wait = expiry - uptime;
+    }
+    /* Nothing to wait for: sleep until another interrupt. */
+    if (wait == ~((u64) 0))
+        smp->getAPIC()->setTimer(0);
+    else
+        smp->getAPIC()->setTimer(wait > APIC_TIMER_MAX ? APIC_TIMER_MAX :
+                                 wait ? (Size) wait : 1);
+}
+
+u64 X86Kernel::getUptime()
+{
+    u64 hz = clockPage->tscFrequency;
+    u64 elapsed, seconds;
+
+    /* Count i8253 ticks. */
+    if (!tickless)
+    {
+        return clockPage->ticks * (1000000 / PIT_HZ);
+    }
+    elapsed = timestamp() - bootTsc;
+    seconds = udiv64(elapsed, hz);
+
+    return seconds * 1000000 + udiv64((elapsed - seconds * hz) * 1000000, hz);
+}
+
+u64 systemTime()
+{
+    return kernel->getUptime();
+}
+
+bool X86Kernel::setupSysEnter(CoreInfo *core)
+{
+    u32 eax, ebx, ecx, edx;
+    u32 family, model, stepping;
+
+    /* Does the processor know SYSENTER? */
+    cpuid(1, eax, ebx, ecx, edx);
+    family   = (eax >> 8) & 0xf;
+    model    = (eax >> 4) & 0xf;
+    stepping = eax & 0xf;
+
+    if (!(edx & CPUID_SEP))
+	return false;
+
+    /* The Pentium Pro reports the flag, but has no SYSENTER. */
+    if (family == 6 && model < 3 && stepping < 3)
+	return false;
+
+    /* Enter at sysEnterHandler() in the kernel code segment. */
+    wrmsr(SYSENTER_CS_MSR,  KERNEL_CS_SEL);
+    wrmsr(SYSENTER_ESP_MSR, (Address) core);
+    wrmsr(SYSENTER_EIP_MSR, (Address) &sysEnterHandler);
+    return true;
+}
+
+Address sysEnterReturn(Address stack)
+{
+    Process *proc = scheduler->current();
+
+    /* Never follow a pointer into the kernel, or to unmapped memory. */
+    if (stack < PAGEUSERFROM || stack > (Address) -sizeof(Address) ||
+        !memory->access(proc, stack, sizeof(Address), PAGE_PRESENT) ||
+        !memory->access(proc, stack, sizeof(Address), PAGE_USER))
+    {
+	return ZERO;
+    }
+    return *(Address *) stack;
+}
+
+Error X86Kernel::hookInterrupt(int vec, InterruptHandler h, ulong p)
+{
+    InterruptVector *v = &interrupts[vec];
     InterruptHook hook(h, p);
 
-    /* Insert into interrupts; create List if neccessary. */
-    if (!interrupts[vec])
+    /* Only hook once. */
+    for (Size i = 0; i < v->count; i++)
     {
-        interrupts.insert(vec, new List<InterruptHook>());
+	if (v->hooks[i] == &hook)
+	    return ESUCCESS;
     }
-    /* Just append it. */
-    if (!interrupts[vec]->contains(&hook))
+    /* Append it, if there is room. */
+    if (v->count >= MAX_INTERRUPT_HOOKS)
     {
-	interrupts[vec]->insertTail(new InterruptHook(h, p));
+	return EBUSY;
     }
+    v->hooks[v->count++] = hook;
+    return ESUCCESS;
 }
 
 void X86Kernel::enableIRQ(uint irq, bool enabled)
@@ -154,15 +333,46 @@ Process * X86Kernel::createProcess(Address entry)
     return new X86Process(entry);
 }
 
+Process * X86Kernel::createThread(Address entry, Process *owner, Address stack)
+{
+    return new X86Process(entry, (X86Process *) owner, stack);
+}
+
 void X86Kernel::exception(CPUState *state, ulong param)
 {
     assert(scheduler->current() != ZERO);
-    delete scheduler->current();
+
+    if (state->vector == 14)
+    {
+        scheduler->current()->getStats()->pageFaults++;
+
+        /* First touch of a demand-zero page: retry with the page mapped. */
+        if (memory->populate(scheduler->current(), cr2()))
+            return;
+    }
+
+    /* A faulting thread exits: its joiner cleans up. */
+    if (scheduler->current()->getOwner() != scheduler->current()->getID())
+        scheduler->current()->exit(ZERO);
+    else
+        delete scheduler->current();
+
     scheduler->executeNext();
 }
 
 void X86Kernel::interrupt(CPUState *state, ulong param)
 {
+    /* Spurious interrupts need no End of Interrupt. */
+    if (state->vector == APIC_SPURIOUS_VECTOR)
+    {
+        return;
+    }
+    /* End of Interrupt to the local APIC. */
+    if (state->vector >= APIC_TIMER_VECTOR)
+    {
+        smp->getAPIC()->sendEOI();
+        return;
+    }
     /* End of Interrupt to slave. */
     if (IRQ(state->vector) >= 8)
     {
@@ -174,26 +384,136 @@ void X86Kernel::interrupt(CPUState *state, ulong param)
 
 void X86Kernel::trap(CPUState *state, ulong param)
 {
-    APIHandler *h = apis[state->eax];
+    ulong nr = state->eax;
+    APIHandler *h;
+    u64 t1;
     
-    if (h)
+    if (nr < MAX_APIS && (h = apis[nr]))
     {
+	t1 = timestamp();
 	state->eax = h(state->ecx, state->ebx, state->edx,
 		       state->esi, state->edi);
+
+	/* Account the call. */
+	apiStats[nr].calls++;
+	apiStats[nr].cycles += timestamp() - t1;
     }
 }
 
 void X86Kernel::clocktick(CPUState *state, ulong param)
 {
-    /* Quantum reached? */
-    if ((++kernel->ticks % 2) == 0)
+    CoreInfo *core = smp->getCore(currentCore());
+
+    /* Update the system clock, and wake up sleeping processes. */
+    kernel->updateClock();
+    timers->expire(systemTime());
+
+    /* Charge the tick to the running process. */
+    if (scheduler->current())
+	scheduler->current()->getStats()->ticks++;
+
+    /* Time slice used up? */
+    if (kernel->sliceExpired(core))
     {
-	/* Reset. */
-        kernel->ticks = 0;
+        /* Reschedule, and start over if nothing else runs. */
+	scheduler->executeNext(true);
+	kernel->startSlice(scheduler->current());
+    }
+    /* Interrupted early: wait for the rest. */
+    else
+	kernel->armTimer(core);
+}
+
+void X86Kernel::updateClock()
+{
+    static u64 calibrateStart = 0;
+    u64 elapsed, hz;
+
+    /* Update the system clock. */
+    clockPage->sequence++;
+    clockPage->ticks++;
+    clockPage->tscBase      = timestamp();
+
+    /*
+     * Tickless: convert the timestamp counter since boot.
+     * Assumes the same counter on all cores.
+     */
+    if (tickless)
+    {
+	hz      = clockPage->tscFrequency;
+	elapsed = clockPage->tscBase - bootTsc;
+
+	clockPage->seconds     = udiv64(elapsed, hz);
+	clockPage->nanoseconds = udiv64((elapsed - (u64) clockPage->seconds * hz) *
+					1000000000, hz);
+	clockPage->sequence++;
+	return;
+    }
+    /* Advance one i8253 tick. */
+    clockPage->nanoseconds += 1000000000 / PIT_HZ;
+
+    if (clockPage->nanoseconds >= 1000000000)
+    {
+	clockPage->nanoseconds -= 1000000000;
+	clockPage->seconds++;
+    }
+    /* Measure the timestamp counter against the timer. */
+    if (clockPage->ticks == 1)
+	calibrateStart = clockPage->tscBase;
+
+    else if (clockPage->ticks == TSC_CALIBRATE_TICKS + 1)
+	clockPage->tscFrequency = (clockPage->tscBase - calibrateStart) *
+				   PIT_HZ / TSC_CALIBRATE_TICKS;
+    clockPage->sequence++;
+}
+
+void X86Kernel::reschedule(CPUState *state, ulong param)
+{
+    scheduler->executeNext(true);
+}
+
+u32 X86Kernel::readTimeOfDay()
+{
+    u32 sec, min, hour, day, month, year;
+    u8 status;
+
+    /* Wait until the clock is not being updated. */
+    do
+    {
+	outb(CMOS_ADDR, 0x0a);
+    }
+    while (inb(CMOS_DATA) & 0x80);
 
-        /* Reschedule. */
-	scheduler->executeNext();
+    /* Read out the date and time registers. */
+    outb(CMOS_ADDR, 0x00); sec   = inb(CMOS_DATA);
+    outb(CMOS_ADDR, 0x02); min   = inb(CMOS_DATA);
+    outb(CMOS_ADDR, 0x04); hour  = inb(CMOS_DATA);
+    outb(CMOS_ADDR, 0x07); day   = inb(CMOS_DATA);
+    outb(CMOS_ADDR, 0x08); month = inb(CMOS_DATA);
+    outb(CMOS_ADDR, 0x09); year  = inb(CMOS_DATA);
+    outb(CMOS_ADDR, 0x0b); status = inb(CMOS_DATA);
+
+    /* Convert from binary coded decimal, if needed. */
+    if (!(status & 0x04))
+    {
+	sec   = (sec   & 0xf) + ((sec   >> 4) * 10);
+	min   = (min   & 0xf) + ((min   >> 4) * 10);
+	hour  = (hour  & 0xf) + ((hour  >> 4) * 10);
+	day   = (day   & 0xf) + ((day   >> 4) * 10);
+	month = (month & 0xf) + ((month >> 4) * 10);
+	year  = (year  & 0xf) + ((year  >> 4) * 10);
+    }
+    year += 2000;
+
+    /* Put February last, since it has the leap day. */
+    if (0 >= (int) (month -= 2))
+    {
+	month += 12;
+	year  -= 1;
     }
+    /* Seconds since the Epoch. */
+    return ((((year / 4 - year / 100 + year / 400 + 367 * month / 12 + day) +
+	       year * 365 - 719499) * 24 + hour) * 60 + min) * 60 + sec;
 }
 
 INITOBJ(X86Kernel, kernel, KERNEL)
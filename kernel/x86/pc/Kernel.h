@@ -21,10 +21,12 @@
 #ifndef __ASSEMBLY__
 
 #include <FreeNOS/Kernel.h>
+#include <FreeNOS/InfoPage.h>
 #include <Singleton.h>
 #include <Types.h>
 #include "Interrupt.h"
 #include "CPU.h"
+#include "SMP.h"
 
 /**   
  * @defgroup x86kernel kernel (x86)  
@@ -64,6 +66,21 @@
 /** PIT channel zero. */
 #define PIT_CHAN0       0x40
 
+/** PIT channel two, used for busy waiting. */
+#define PIT_CHAN2       0x42
+
+/** Gate of PIT channel two, and its output (bit 5). */
+#define PIT_GATE        0x61
+
+/** CMOS register select port. */
+#define CMOS_ADDR       0x70
+
+/** CMOS data port. */
+#define CMOS_DATA       0x71
+
+/** Number of timer interrupts over which the timestamp counter is measured. */
+#define TSC_CALIBRATE_TICKS 64
+
 /**
  * Implements an x86 compatible kernel.
  */
@@ -81,8 +98,10 @@ class X86Kernel : public Kernel, public Singleton<X86Kernel>
          * @param vec Interrupt vector to hook on.
          * @param h Handler function.
          * @param p Parameter to pass to the handler function.
+         * @return ESUCCESS, or EBUSY if the vector has
+         *         MAX_INTERRUPT_HOOKS hooks already.
          */
-        void hookInterrupt(int vec, InterruptHandler h, ulong p);
+        Error hookInterrupt(int vec, InterruptHandler h, ulong p);
 
         /** 
          * Uses the PIC to (un)mask an IRQ. 
@@ -98,6 +117,44 @@ class X86Kernel : public Kernel, public Singleton<X86Kernel>
          */
         Process * createProcess(Address entry);
 
+        /**
+         * Create a new thread.
+         * @param entry Entry point of the thread.
+         * @param owner Process whose address space is shared.
+         * @param stack Initial user stack pointer.
+         * @return X86Process on success or ZERO on failure.
+         */
+        Process * createThread(Address entry, Process *owner, Address stack);
+
+        /**
+         * Prepare the executing core for running processes.
+         * Loads its TSS, enables SYSENTER and its local APIC.
+         */
+        void initializeCore();
+
+        /**
+         * Start the time slice of a Process on the executing core.
+         * The idle process has no time slice: the core then only
+         * interrupts itself for the next timer, if any (tickless idle).
+         * @param p Process which is about to run.
+         */
+        void startSlice(Process *p);
+
+        /**
+         * Get the time since boot.
+         * @return Microseconds since boot.
+         */
+        u64 getUptime();
+
+        /**
+         * Check if system calls may enter using SYSENTER.
+         * @return True if SYSENTER is enabled, false otherwise.
+         */
+        bool hasSysEnter()
+        {
+            return sysEnter;
+        }
+
     private:
     
         /** 
@@ -122,19 +179,83 @@ class X86Kernel : public Kernel, public Singleton<X86Kernel>
         static void trap(CPUState *state, ulong param);
         
         /** 
-         * i8253 system clock interrupt handler. 
+         * System clock interrupt handler, of the i8253 or the local APIC timer.
          * @param state CPU registers on time of interrupt. 
          * @param param Not used.
          */
         static void clocktick(CPUState *state, ulong param);
+
+        /**
+         * Bring the system clock up to date.
+         * Without local APIC it advances by one i8253 tick, otherwise
+         * it follows the timestamp counter.
+         */
+        void updateClock();
+
+        /**
+         * Check if the time slice of the executing core is used up.
+         * @param core The executing core.
+         * @return True if it is time to reschedule.
+         */
+        bool sliceExpired(CoreInfo *core);
+
+        /**
+         * Program the local APIC timer for the end of the time slice
+         * or the next expiry of the timer wheel, whichever comes first.
+         * @param core The executing core.
+         */
+        void armTimer(CoreInfo *core);
+
+        /**
+         * Handler of the reschedule IPI from another core.
+         * @param state CPU registers on time of interrupt.
+         * @param param Not used.
+         */
+        static void reschedule(CPUState *state, ulong param);
+
+        /**
+         * Read the current time from the CMOS real time clock.
+         * @return Seconds since the Epoch.
+         */
+        static u32 readTimeOfDay();
         
-        /** Amount of i8253 ticks (interrupts) counted so far. */
-        Size ticks;
+        /**
+         * Enable SYSENTER, if the processor supports it.
+         * @param core Core to enter on, which holds the kernel stack in its TSS.
+         * @return True if enabled, false otherwise.
+         */
+        static bool setupSysEnter(CoreInfo *core);
+
+        /** True if SYSENTER is enabled. */
+        bool sysEnter;
+
+        /** True if the local APIC timers run one-shot, instead of the i8253. */
+        bool tickless;
+
+        /** Timestamp counter at boot, for the tickless clock. */
+        u64 bootTsc;
 };
 
 /** Points to the kernel. */
 extern X86Kernel *kernel;
 
+/** System clock, mapped read-only into every process. */
+extern ClockPage *clockPage;
+
+/**
+ * SYSENTER entry point of system calls.
+ * @see sysEnter.S
+ */
+extern C void sysEnterHandler();
+
+/**
+ * Fetch the return address of a SYSENTER system call.
+ * @param stack User stack pointer passed in EBP.
+ * @return Return address, or ZERO if the stack is not mapped user memory.
+ * @see sysEnter.S
+ */
+extern C Address sysEnterReturn(Address stack);
+
 /**
  * @}
  */
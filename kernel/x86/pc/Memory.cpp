@@ -16,15 +16,63 @@
  */
 
 #include "Memory.h"
+#include "CPU.h"
+#include "SMP.h"
 #include <FreeNOS/Kernel.h>
 #include <FreeNOS/Process.h>
+#include <FreeNOS/Scheduler.h>
 #include <MemoryBlock.h>
+#include <Assert.h>
 #include <Types.h>
 
-X86Memory::X86Memory() : Memory(), remPageDir(PAGEDIRADDR_REMOTE),
+/**
+ * Virtual addresses of the mapping slots, inside the kernel page table.
+ * The physical pages behind it are never used.
+ */
+static u8 slotWindow[MAPSLOT_COUNT * PAGESIZE] ALIGN(PAGESIZE);
+
+X86Memory::X86Memory() : Memory(), largePages(false), freeSlotCount(0),
+                         remPageDir(PAGEDIRADDR_REMOTE),
                          remPageTab(ZERO), myPageDir(PAGEDIRADDR),
                          myPageTab(ZERO)
 {
+    u32 eax, ebx, ecx, edx;
+
+    zeroStats.count  = 0;
+    zeroStats.hits   = 0;
+    zeroStats.misses = 0;
+
+    for (Size i = 0; i < MAX_CORES; i++)
+    {
+        remoteEntry[i] = ZERO;
+    }
+
+    cpuid(1, eax, ebx, ecx, edx);
+
+    /* Kernel pages are the same in every process: keep them in the TLB. */
+    if (edx & CPUID_PGE)
+    {
+        for (Size i = 0; i < PAGETAB_MAX; i++)
+        {
+            kernelPageTab[i] |= PAGE_GLOBAL;
+        }
+        cr4_set(CR4_PGE);
+    }
+    /* Allow 4MB pages. */
+    if (edx & CPUID_PSE)
+    {
+        cr4_set(CR4_PSE);
+        largePages = true;
+    }
+    /* Unmap the mapping slots. */
+    for (Size i = 0; i < MAPSLOT_COUNT; i++)
+    {
+        Address vaddr = (Address) slotWindow + (i * PAGESIZE);
+
+        kernelPageTab[TABENTRY(vaddr)] = ZERO;
+        tlb_flush(vaddr);
+        freeSlots[freeSlotCount++] = vaddr;
+    }
 }
 
 Address X86Memory::mapVirtual(Address paddr, Address vaddr, ulong prot)
@@ -40,16 +88,13 @@ Address X86Memory::mapVirtual(Address paddr, Address vaddr, ulong prot)
     /* Do we have the page table in memory? */
     if (!(myPageDir[DIRENTRY(vaddr)] & PAGE_PRESENT))
     {
-        /* Then first allocate new page table. */
-        Address newPageTab  = memory->allocatePhysical(PAGESIZE);
-        newPageTab |= PAGE_PRESENT | PAGE_RW | prot;
+        /* Then first allocate new (cleared) page table. */
+        Address newPageTab  = allocateZeroed();
+        newPageTab |= PAGE_PRESENT | PAGE_RW | (prot & ~PAGE_LAZY);
 
         /* Map the new page table into memory. */
         myPageDir[DIRENTRY(vaddr)] = newPageTab;
         tlb_flush(myPageTab);
-
-        /* Zero the new page table. */
-        MemoryBlock::set(myPageTab, 0, PAGESIZE);
     }
     /* Map physical to virtual address. */
     myPageTab[TABENTRY(vaddr)] = (paddr & PAGEMASK) | prot;
@@ -72,22 +117,24 @@ Address X86Memory::mapVirtual(Process *p, Address paddr,
     }
     /* Repoint to the correct (remote) page table. */
     remPageTab = PAGETABADDR_FROM(vaddr, PAGETABFROM_REMOTE);
-    
+
+    /* Mapping inside a large page: split it first. */
+    if (!splitLarge(vaddr))
+    {
+        return ZERO;
+    }
     /* Does the remote process have the page table in memory? */
     if (!(remPageDir[DIRENTRY(vaddr)] & PAGE_PRESENT))
     {
-        /* Nope, allocate a page table first. */
-        Address newPageTab  = memory->allocatePhysical(PAGESIZE);
-        newPageTab |= PAGE_PRESENT | PAGE_RW | prot;
+        /* Nope, allocate a (cleared) page table first. */
+        Address newPageTab  = allocateZeroed();
+        newPageTab |= PAGE_PRESENT | PAGE_RW | (prot & ~PAGE_LAZY);
         
         /* Map the new page table into remote memory. */
         remPageDir[DIRENTRY(vaddr)] = newPageTab;
         
         /* Update caches. */
         tlb_flush(remPageTab);
-        
-        /* Zero the new page. */
-        MemoryBlock::set(remPageTab, 0, PAGESIZE);
     }
     /* Map physical address to remote virtual address. */
     remPageTab[TABENTRY(vaddr)] = (paddr & PAGEMASK) | prot;
@@ -97,67 +144,288 @@ Address X86Memory::mapVirtual(Process *p, Address paddr,
     return (Address) vaddr;
 }
 
+Address X86Memory::mapSlot(Address paddr)
+{
+    Address vaddr;
+
+    assert(freeSlotCount > 0);
+
+    /* Take an unused slot. The kernel page table is identity mapped. */
+    vaddr = freeSlots[--freeSlotCount];
+    kernelPageTab[TABENTRY(vaddr)] = (paddr & PAGEMASK) | PAGE_PRESENT | PAGE_RW;
+
+    /* Another core may have used the slot last. */
+    tlb_flush(vaddr);
+    return vaddr;
+}
+
+void X86Memory::unmapSlot(Address vaddr)
+{
+    vaddr &= PAGEMASK;
+    kernelPageTab[TABENTRY(vaddr)] = ZERO;
+    tlb_flush(vaddr);
+    freeSlots[freeSlotCount++] = vaddr;
+}
+
+bool X86Memory::mapLarge(Process *p, Address paddr, Address vaddr, ulong prot)
+{
+    /* Both addresses must be aligned. */
+    if (!largePages || (paddr & ~LARGE_PAGEMASK) || (vaddr & ~LARGE_PAGEMASK))
+    {
+        return false;
+    }
+    /* Map remote pages. */
+    mapRemote((X86Process *)p, vaddr);
+
+    /* The whole page table must be unused. */
+    if (remPageDir[DIRENTRY(vaddr)] & PAGE_PRESENT)
+    {
+        return false;
+    }
+    remPageDir[DIRENTRY(vaddr)] = paddr | (prot & ~PAGEMASK) | PAGE_LARGE;
+    return true;
+}
+
+bool X86Memory::unmapLarge(Process *p, Address vaddr)
+{
+    if (vaddr & ~LARGE_PAGEMASK)
+    {
+        return false;
+    }
+    /* Map remote pages. */
+    mapRemote((X86Process *)p, vaddr);
+
+    if (!(remPageDir[DIRENTRY(vaddr)] & PAGE_LARGE))
+    {
+        return false;
+    }
+    remPageDir[DIRENTRY(vaddr)] = ZERO;
+    tlb_flush(PAGETABADDR_FROM(vaddr, PAGETABFROM_REMOTE));
+    tlb_flush(vaddr);
+    return true;
+}
+
+bool X86Memory::splitLarge(Address vaddr)
+{
+    Address entry = remPageDir[DIRENTRY(vaddr)], table;
+    ulong flags = entry & ~PAGEMASK & ~PAGE_LARGE;
+
+    if (!(entry & PAGE_LARGE))
+    {
+        return true;
+    }
+    /* Give the large page a page table of its own. */
+    if (!(table = allocateZeroed()))
+    {
+        return false;
+    }
+    remPageDir[DIRENTRY(vaddr)] = table | flags;
+    remPageTab = PAGETABADDR_FROM(vaddr, PAGETABFROM_REMOTE);
+    tlb_flush(remPageTab);
+
+    /* Map the same 4MB, one page at a time. */
+    for (Size i = 0; i < PAGETAB_MAX; i++)
+    {
+        remPageTab[i] = ((entry & LARGE_PAGEMASK) + (i * PAGESIZE)) | flags;
+    }
+    tlb_flush(vaddr);
+    return true;
+}
+
 Address X86Memory::findFree(Address pageTabFrom, Address *pageDirPtr)
 {
-    Address  vaddr = 0xa0000000;
-    Address *pageTabPtr = PAGETABADDR_FROM(vaddr, pageTabFrom);
+    Address vaddr = 0xa0000000;
 
     /* Find a free virtual address. */
-    while (pageDirPtr[DIRENTRY(vaddr)] & PAGE_PRESENT &&
-           pageTabPtr[TABENTRY(vaddr)] & PAGE_PRESENT)
+    while (pageEntry(pageDirPtr, pageTabFrom, vaddr) & PAGE_PRESENT)
     {
         /* Look for the next page in line. */
-        vaddr     += PAGESIZE;
-        pageTabPtr = PAGETABADDR_FROM(vaddr, pageTabFrom);
+        vaddr += PAGESIZE;
     }
     return vaddr;
 }
 
+Address X86Memory::pageEntry(Address *pageDir, Address pageTabFrom,
+                             Address vaddr)
+{
+    Address dir = pageDir[DIRENTRY(vaddr)];
+
+    if (!(dir & PAGE_PRESENT))
+    {
+        return ZERO;
+    }
+    /* A large page has no page table: make up the entry. */
+    if (dir & PAGE_LARGE)
+    {
+        return (dir & LARGE_PAGEMASK) | (vaddr & ~LARGE_PAGEMASK & PAGEMASK) |
+               (dir & ~PAGEMASK & ~PAGE_LARGE);
+    }
+    return (PAGETABADDR_FROM(vaddr, pageTabFrom))[TABENTRY(vaddr)];
+}
+
+Address X86Memory::allocateZeroed()
+{
+    Address paddr, tmp;
+
+    /* Prefer a page cleared by the idle process. */
+    if (zeroStats.count)
+    {
+        zeroStats.hits++;
+        return zeroPool[--zeroStats.count];
+    }
+    zeroStats.misses++;
+
+    /* Clear one ourselves. */
+    if ((paddr = allocatePhysical(PAGESIZE)))
+    {
+        tmp = mapSlot(paddr);
+        MemoryBlock::set((void *) tmp, 0, PAGESIZE);
+        unmapSlot(tmp);
+    }
+    return paddr;
+}
+
+bool X86Memory::refillZeroPool()
+{
+    Address paddr, tmp;
+
+    /* Is the pool full already? */
+    if (zeroStats.count >= ZEROPOOL_SIZE ||
+      !(paddr = allocatePhysical(PAGESIZE)))
+    {
+        return false;
+    }
+    /* Clear the page, then add it. */
+    tmp = mapSlot(paddr);
+    MemoryBlock::set((void *) tmp, 0, PAGESIZE);
+    unmapSlot(tmp);
+    zeroPool[zeroStats.count++] = paddr;
+
+    return true;
+}
+
+ZeroPoolStats X86Memory::getZeroPoolStats() const
+{
+    return zeroStats;
+}
+
+bool X86Memory::populate(Process *p, Address vaddr)
+{
+    Address entry, paddr;
+
+    /* Map remote pages. */
+    mapRemote((X86Process *)p, vaddr);
+
+    /* Only demand-zero entries are populated. */
+    entry = pageEntry(remPageDir, PAGETABFROM_REMOTE, vaddr);
+
+    if ((entry & (PAGE_PRESENT | PAGE_LAZY)) != PAGE_LAZY ||
+        !(paddr = allocateZeroed()))
+    {
+        return false;
+    }
+    /* Map it in place of the demand-zero entry. */
+    mapVirtual(p, paddr, vaddr & PAGEMASK,
+              (entry & ~PAGEMASK & ~PAGE_LAZY) | PAGE_PRESENT);
+    return true;
+}
+
 Address X86Memory::lookupVirtual(Process *p, Address vaddr)
 {
-    Address ret = ZERO;
+    Address ret;
 
+    /* The current process is reachable through its own page tables. */
+    if (p == scheduler->current())
+    {
+        ret = pageEntry(myPageDir, PAGETABFROM, vaddr);
+    }
     /* Map remote page tables. */
+    else
+    {
+        mapRemote((X86Process *)p, vaddr);
+        ret = pageEntry(remPageDir, PAGETABFROM_REMOTE, vaddr);
+    }
+    /* Only return the entry, if mapped. */
+    return ret & PAGE_PRESENT ? ret : ZERO;
+}
+
+void X86Memory::unmapVirtual(Process *p, Address vaddr)
+{
+    /* Map remote pages. */
     mapRemote((X86Process *)p, vaddr);
-    
-    /* Lookup the address, if mapped. */
-    if (remPageDir[DIRENTRY(vaddr)] & PAGE_PRESENT &&
-        remPageTab[TABENTRY(vaddr)] & PAGE_PRESENT)
+
+    /* Without a page table, there is nothing to clear. */
+    if (!(remPageDir[DIRENTRY(vaddr)] & PAGE_PRESENT) || !splitLarge(vaddr))
     {
-        ret = remPageTab[TABENTRY(vaddr)];
+        return;
     }
-    return ret;
+    remPageTab = PAGETABADDR_FROM(vaddr, PAGETABFROM_REMOTE);
+    remPageTab[TABENTRY(vaddr)] = ZERO;
+    tlb_flush(vaddr);
+}
+
+void X86Memory::shootdown(Process *p)
+{
+    smp->shootdown(((X86Process *)p)->getPageDirectory());
 }
 
 void X86Memory::mapRemote(X86Process *p, Address pageTabAddr,
                           Address pageDirAddr, ulong prot)
 {
-    /* Map remote page directory and page table. */
-    myPageDir[DIRENTRY(pageDirAddr)] =
-        p->getPageDirectory() | (PAGE_PRESENT|PAGE_RW|PAGE_PINNED|prot);
+    Address entry = p->getPageDirectory() |
+                    (PAGE_PRESENT|PAGE_RW|PAGE_PINNED|prot);
+
+    /* Point to the remote page table. */
     remPageTab = PAGETABADDR_FROM(pageTabAddr, PAGETABFROM_REMOTE);
-    
-    /* Refresh entire TLB cache. */
-    tlb_flush_all();
+
+    /* Map the remote page directory, unless it is already. */
+    if (myPageDir[DIRENTRY(pageDirAddr)] != entry ||
+        remoteEntry[currentCore()] != entry)
+    {
+        myPageDir[DIRENTRY(pageDirAddr)] = entry;
+        remoteEntry[currentCore()] = entry;
+
+        /* Refresh entire TLB cache. */
+        tlb_flush_all();
+    }
 }
 
 bool X86Memory::access(Process *p, Address vaddr, Size sz, ulong prot)
 {
     Size bytes = 0;
     Address vfrom = vaddr;
+    Address *pageDir, pageTabFrom, entry;
 
+    /* The current process is reachable through its own page tables. */
+    if (p == scheduler->current())
+    {
+        pageDir     = myPageDir;
+        pageTabFrom = PAGETABFROM;
+    }
     /* Map remote pages. */
-    mapRemote((X86Process *)p, vaddr);
-
+    else
+    {
+        mapRemote((X86Process *)p, vaddr);
+        pageDir     = remPageDir;
+        pageTabFrom = PAGETABFROM_REMOTE;
+    }
     /* Verify protection bits. */
-    while (bytes < sz &&
-           remPageDir[DIRENTRY(vaddr)] & prot &&
-           remPageTab[TABENTRY(vaddr)] & prot)
+    while (bytes < sz)
     {
+        entry = pageEntry(pageDir, pageTabFrom, vaddr);
+
+        /* Demand-zero pages are populated on first touch. */
+        if ((entry & (PAGE_PRESENT | PAGE_LAZY)) == PAGE_LAZY)
+        {
+            entry |= PAGE_PRESENT;
+        }
+        if (!(pageDir[DIRENTRY(vaddr)] & prot && entry & prot))
+        {
+            break;
+        }
         vaddr += PAGESIZE;
         bytes += ((vfrom & PAGEMASK) + PAGESIZE) - vfrom;
         vfrom  = vaddr & PAGEMASK;
-        remPageTab = PAGETABADDR_FROM(vaddr, PAGETABFROM_REMOTE);
     }
     /* Do we have a match? */
     return (bytes >= sz);
@@ -172,7 +440,8 @@ void X86Memory::releaseAll(Process *p)
     for (Size i = 0; i < 1024; i++)
     {
         /* May we release these physical pages? */
-        if ((remPageDir[i] & PAGE_PRESENT) && !(remPageDir[i] & PAGE_PINNED))
+        if ((remPageDir[i] & PAGE_PRESENT) &&
+           !(remPageDir[i] & (PAGE_PINNED | PAGE_LARGE)))
         {
             /* Repoint page table. */
             remPageTab = PAGETABADDR_FROM(i * PAGESIZE * 1024,
@@ -188,6 +457,14 @@ void X86Memory::releaseAll(Process *p)
             }
         }
     }
+    /* The page directory may be reused: forget the remote mapping. */
+    myPageDir[DIRENTRY(PAGEDIRADDR_REMOTE)] = ZERO;
+
+    for (Size i = 0; i < MAX_CORES; i++)
+    {
+        remoteEntry[i] = ZERO;
+    }
+    tlb_flush_all();
 }
 
 INITOBJ(X86Memory, memory, VMEMORY)
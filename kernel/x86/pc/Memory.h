@@ -49,6 +49,12 @@
 /** Mask to find the page. */
 #define PAGEMASK        0xfffff000 
 
+/** Size of a large page. */
+#define LARGE_PAGESIZE  (1024 * 1024 * 4)
+
+/** Mask to find the large page. */
+#define LARGE_PAGEMASK  0xffc00000
+
 /** Memory address alignment. */
 #define MEMALIGN        4
 
@@ -61,6 +67,21 @@
 /** Marks a page accessible by user programs (ring 3). */
 #define PAGE_USER       4
 
+/** Disables caching of the page, for memory mapped registers. */
+#define PAGE_UNCACHED   ((1 << 3) | (1 << 4))
+
+/**
+ * Page is allocated and zeroed on first access.
+ * Shares an available bit with PAGE_MARKED, which only appears in page directory entries.
+ */
+#define PAGE_LAZY       (1 << 10)
+
+/** Page directory entry maps a 4MB page. */
+#define PAGE_LARGE      (1 << 7)
+
+/** Page is the same in every address space, and survives TLB flushes. */
+#define PAGE_GLOBAL     (1 << 8)
+
 /** Pinned pages cannot be released. */
 #define PAGE_PINNED     (1 << 9)
 
@@ -79,6 +100,12 @@
 /** Address space for userspace pagetable mapping. */
 #define PAGEUSERFROM            ADDRESS (1024 * 1024 * 12)
 
+/** Number of temporary kernel mapping slots. */
+#define MAPSLOT_COUNT           16
+
+/** Number of cleared physical pages kept ready for allocation. */
+#define ZEROPOOL_SIZE           64
+
 /**
  * Entry inside the page directory of a given virtual address.
  * @param vaddr Virtual Address.
@@ -143,15 +170,32 @@
  * Flushes all Translation Lookaside Buffers (TLB).
  */
 #define tlb_flush_all() \
-    asm volatile("mov %cr3, %eax\n" \
-                 "mov %eax, %cr3\n")
+    asm volatile("mov %%cr3, %%eax\n" \
+                 "mov %%eax, %%cr3\n" ::: "eax", "memory")
 
 #include <FreeNOS/Memory.h>
+#include <FreeNOS/Scheduler.h>
 #include <Singleton.h>
 #include "Process.h"
 #include <Types.h>
 #include <Macros.h>
 
+/**
+ * Statistics of the pool of cleared pages.
+ */
+typedef struct ZeroPoolStats
+{
+    /** Number of cleared pages currently in the pool. */
+    Size count;
+
+    /** Allocations served from the pool. */
+    Size hits;
+
+    /** Allocations which had to clear a page themselves. */
+    Size misses;
+}
+ZeroPoolStats;
+
 /**
  * x86 Virtual Memory.
  */
@@ -185,6 +229,69 @@ class X86Memory : public Memory, public Singleton<X86Memory>
         Address mapVirtual(Process *p, Address paddr,
                            Address vaddr, ulong prot = PAGE_PRESENT | PAGE_RW);
 
+        /**
+         * Map 4MB of physical memory with one large page, if supported.
+         * @param p Process to map memory for.
+         * @param paddr Physical address, aligned on LARGE_PAGESIZE.
+         * @param vaddr Virtual address, aligned on LARGE_PAGESIZE.
+         * @param prot Page entry protection flags.
+         * @return True if mapped, false if 4K pages must be used instead.
+         */
+        bool mapLarge(Process *p, Address paddr, Address vaddr, ulong prot);
+
+        /**
+         * Unmap a whole large page.
+         * @param p Process to unmap memory for.
+         * @param vaddr Virtual address, aligned on LARGE_PAGESIZE.
+         * @return True if unmapped, false if vaddr is not a large page.
+         */
+        bool unmapLarge(Process *p, Address vaddr);
+
+        /**
+         * Temporarily map a physical page into the kernel.
+         *
+         * Slots are mapped the same in every process, and must be released
+         * with unmapSlot() before leaving the kernel.
+         *
+         * @param paddr Physical address.
+         * @return Virtual address of the slot.
+         */
+        Address mapSlot(Address paddr);
+
+        /**
+         * Release a slot from mapSlot().
+         * @param vaddr Virtual address of the slot.
+         */
+        void unmapSlot(Address vaddr);
+
+        /**
+         * Allocate a cleared physical page.
+         * Takes a page from the pool if possible, otherwise clears one.
+         * @return Physical address of the page, or ZERO if out of memory.
+         */
+        Address allocateZeroed();
+
+        /**
+         * Clear one more page for the pool of cleared pages.
+         * Called by the idle process, with interrupts disabled.
+         * @return True if a page was added, false if the pool is full.
+         */
+        bool refillZeroPool();
+
+        /**
+         * Retrieve statistics of the pool of cleared pages.
+         * @return Pool statistics.
+         */
+        ZeroPoolStats getZeroPoolStats() const;
+
+        /**
+         * Allocate and zero the page behind a demand-zero (PAGE_LAZY) entry.
+         * @param p Process which owns the entry.
+         * @param vaddr Virtual address inside the page.
+         * @return True if a page was mapped, false if the entry is not demand-zero.
+         */
+        bool populate(Process *p, Address vaddr);
+
         /**
          * Lookup a pagetable entry for the given (remote) virtual address.
          * @param p Target process.
@@ -193,8 +300,22 @@ class X86Memory : public Memory, public Singleton<X86Memory>
          */
         Address lookupVirtual(Process *p, Address vaddr);
 
+        /**
+         * Clear the page table entry of a (remote) virtual address.
+         * @param p Target process.
+         * @param vaddr Virtual address to unmap.
+         */
+        void unmapVirtual(Process *p, Address vaddr);
+
+        /**
+         * Flush the TLB of other cores which run the address space of a Process.
+         * @param p Process whose page tables changed.
+         */
+        void shootdown(Process *p);
+
         /**
          * Verify protection access flags in the page directory and page table.
+         * Demand-zero pages count as present, but are not populated here.
          * @param p Target process to verify protection bits for.
          * @param vaddr Virtual address.
          * @param sz Size of the byte range to check.
@@ -211,6 +332,8 @@ class X86Memory : public Memory, public Singleton<X86Memory>
 
         /**
          * Maps remote pages into the current process.
+         * The TLB is only flushed if the remote page directory changes,
+         * or if this core did not map it last.
          * @param p Other process for which we map tables.
          * @param pageTabAddr Point page table pointer for this address.
          * @param pageDirAddr Map the remote page remote directory on this address.
@@ -230,12 +353,50 @@ class X86Memory : public Memory, public Singleton<X86Memory>
          */
         Address findFree(Address pageTabFrom, Address *pageDir);
 
+        /**
+         * Find the entry describing a virtual page.
+         * @param pageDir Page directory to use.
+         * @param pageTabFrom Address of the first page table.
+         * @param vaddr Virtual address.
+         * @return Page table entry, or the equivalent for a large page.
+         */
+        Address pageEntry(Address *pageDir, Address pageTabFrom,
+                          Address vaddr);
+
+        /**
+         * Replace a remote large page by a page table mapping the same memory.
+         * The remote page directory must be mapped with mapRemote().
+         * @param vaddr Virtual address inside the page.
+         * @return True if vaddr is no longer inside a large page.
+         */
+        bool splitLarge(Address vaddr);
         
+        /** True if large pages are enabled. */
+        bool largePages;
+
+        /** Virtual addresses of the unused mapping slots. */
+        Address freeSlots[MAPSLOT_COUNT];
+
+        /** Number of unused mapping slots. */
+        Size freeSlotCount;
+
+        /** Physical addresses of cleared pages. */
+        Address zeroPool[ZEROPOOL_SIZE];
+
+        /** Pool statistics, including the number of pages in zeroPool. */
+        ZeroPoolStats zeroStats;
+
         /** Remote page directory and page tables. */
         Address *remPageDir, *remPageTab;
         
         /** Local (i.e. currently executing process) page directory and tables. */
         Address *myPageDir, *myPageTab;
+
+        /**
+         * Remote page directory entry last used per core. Threads of one
+         * process share the page directory on different cores.
+         */
+        Address remoteEntry[MAX_CORES];
 };
 
 /** Instance of Intel memory. */
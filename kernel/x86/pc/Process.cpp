@@ -16,28 +16,36 @@
  */
 
 #include <FreeNOS/Scheduler.h>
+#include <FreeNOS/InfoPage.h>
 #include <Types.h>
 #include <ListIterator.h>
 #include <MemoryBlock.h>
 #include "CPU.h"
 #include "Process.h"
 #include "Memory.h"
+#include "Kernel.h"
+#include "SMP.h"
+
+/** Kernel stack deferred on each core. */
+static DeadStack deadStacks[MAX_CORES];
+
+/** Number of context switches by each core. */
+static Size switches[MAX_CORES];
 
 X86Process::X86Process(Address entry) : Process(entry)
 {
-    Address *pageDir, *tmpStack, *ioMap;
-    CPUState *regs;
+    Address *pageDir, *ioMap;
+    ProcessPage *page;
 
-    /* Allocate page directory. */
-    pageDirAddr = memory->allocatePhysical(PAGESIZE);
-    pageDir     = (Address *) memory->mapVirtual(pageDirAddr);
+    /* Allocate (cleared) page directory. */
+    pageDirAddr = memory->allocateZeroed();
+    pageDir     = (Address *) memory->mapSlot(pageDirAddr);
 
     /* One page for the I/O bitmap. */
     ioMapAddr   = memory->allocatePhysical(PAGESIZE);
-    ioMap       = (Address *) memory->mapVirtual(ioMapAddr);
+    ioMap       = (Address *) memory->mapSlot(ioMapAddr);
 
-    /* Clear them first. */
-    MemoryBlock::set(pageDir,   0, PAGESIZE);
+    /* Deny all I/O ports by default. */
     MemoryBlock::set(ioMap,  0xff, PAGESIZE);
 
     /* Setup mappings. */
@@ -45,20 +53,64 @@ X86Process::X86Process(Address entry) : Process(entry)
     pageDir[DIRENTRY(PAGETABFROM) ] = pageDirAddr | PAGE_PRESENT | PAGE_RW;
     pageDir[DIRENTRY(PAGEUSERFROM)] = pageDirAddr | PAGE_PRESENT | PAGE_RW;
 
-    /* Point stacks. */
-    stackAddr       = 0xc0000000 - MEMALIGN;
-    kernelStackAddr = 0xd0000000 - MEMALIGN;
-
-    /* Allocate stacks. */
-    for (int i = 0; i < 4; i++)
+    /* Allocate user stack. */
+    for (Size i = 0; i < PROCESS_STACK_SIZE; i += PAGESIZE)
     {
-        memory->allocateVirtual(this, stackAddr - (i * PAGESIZE),
+        memory->allocateVirtual(this, USER_STACK_ADDR - MEMALIGN - i,
                                 PAGE_PRESENT | PAGE_USER | PAGE_RW);
-        memory->allocateVirtual(this, kernelStackAddr - (i * PAGESIZE),
+    }
+    /* Fill in our ProcessPage. */
+    processPageAddr = memory->allocateZeroed();
+    page = (ProcessPage *) memory->mapSlot(processPageAddr);
+    page->id     = getID();
+    page->parent = scheduler->current() ? scheduler->current()->getID() : 0;
+    page->fastSystemCall = kernel->hasSysEnter();
+    memory->unmapSlot((Address) page);
+
+    /* Map the ProcessPage and the system clock, read-only. The clock
+     * lives in the kernel image, shared through pageDir[0]: map its frame. */
+    memory->mapVirtual(this, processPageAddr, PROCESS_PAGE_ADDR,
+		       PAGE_PRESENT | PAGE_USER);
+    memory->mapVirtual(this,
+		       memory->lookupVirtual(this, (Address) clockPage) & PAGEMASK,
+		       CLOCK_PAGE_ADDR, PAGE_PRESENT | PAGE_USER | PAGE_PINNED);
+
+    /* Setup the kernel stack. */
+    kernelStackAddr = KERNEL_STACK_ADDR - MEMALIGN;
+    setupStack(entry, USER_STACK_ADDR - MEMALIGN);
+
+    /* Release temporary mappings. */
+    memory->unmapSlot((Address) pageDir);
+    memory->unmapSlot((Address) ioMap);
+}
+
+X86Process::X86Process(Address entry, X86Process *owner, Address stack)
+    : Process(entry, owner)
+{
+    /* Share the address space, I/O bitmap and ProcessPage. */
+    pageDirAddr     = owner->pageDirAddr;
+    ioMapAddr       = owner->ioMapAddr;
+    processPageAddr = owner->processPageAddr;
+
+    /* Each thread has a private kernel stack slot, selected by ID. */
+    kernelStackAddr = KERNEL_STACK_ADDR - MEMALIGN +
+                      ((getID() + 1) * PROCESS_STACK_SIZE);
+    setupStack(entry, stack);
+}
+
+void X86Process::setupStack(Address entry, Address userStack)
+{
+    Address *tmpStack;
+    CPUState *regs;
+
+    /* Allocate kernel stack. */
+    for (Size i = 0; i < PROCESS_STACK_SIZE; i += PAGESIZE)
+    {
+        memory->allocateVirtual(this, kernelStackAddr - i,
                                 PAGE_PRESENT | PAGE_RW);
     }
     /* Map kernel stack. */
-    tmpStack = (Address *) memory->mapVirtual(
+    tmpStack = (Address *) memory->mapSlot(
 				memory->lookupVirtual(this, kernelStackAddr) & PAGEMASK);
 	
     /* Setup initial registers. */
@@ -69,49 +121,149 @@ X86Process::X86Process(Address entry) : Process(entry)
     regs->gs     = USER_DS_SEL;
     regs->es     = USER_DS_SEL;
     regs->ds     = USER_DS_SEL;
-    regs->ebp    = stackAddr;
+    regs->ebp    = userStack;
     regs->esp0   = kernelStackAddr;
     regs->eip    = entry;
     regs->cs     = USER_CS_SEL;
     regs->eflags = 0x202;
-    regs->esp3   = stackAddr;
+    regs->esp3   = userStack;
     regs->ss3    = USER_DS_SEL;
     
     /* Repoint our stack. */
     stackAddr = kernelStackAddr - sizeof(CPUState) + MEMALIGN;
 
-    /* Release temporary mappings. */
-    memory->mapVirtual((Address) 0, (Address) pageDir, 0);
-    memory->mapVirtual((Address) 0, (Address) tmpStack, 0);
-    memory->mapVirtual((Address) 0, (Address) ioMap, 0);
+    /* Release temporary mapping. */
+    memory->unmapSlot((Address) tmpStack);
 }
 
 X86Process::~X86Process()
 {
+    Array<Process> *procs = getProcessTable();
+    Process *p;
+    Address page;
+    bool running = this == scheduler->current();
+
     /* Remove ourselves from the scheduler. */	
     scheduler->dequeue(this);
 
+    /* Threads only own their kernel stack. */
+    if (getOwner() != getID())
+    {
+	/* Running on it: free it after the next context switch. */
+	if (running)
+	{
+	    deferStack();
+	    return;
+	}
+
+	for (Size i = 0; i < PROCESS_STACK_SIZE; i += PAGESIZE)
+	{
+	    if ((page = memory->lookupVirtual(this, kernelStackAddr - i)))
+	    {
+		memory->releasePhysical(page & PAGEMASK);
+		memory->mapVirtual(this, ZERO, kernelStackAddr - i, 0);
+	    }
+	}
+	return;
+    }
+    /* Threads cannot outlive our address space. */
+    for (Size i = 0; i < procs->size(); i++)
+    {
+	if ((p = (*procs)[i]) && p != this && p->getOwner() == getID())
+	    delete p;
+    }
     /* Mark all our pages free. */
     memory->releaseAll(this);
 }
 
+void X86Process::deferStack()
+{
+    DeadStack *dead = &deadStacks[currentCore()];
+    Address page;
+
+    dead->stack    = kernelStackAddr;
+    dead->owner    = getOwner();
+    dead->pageDir  = pageDirAddr;
+    dead->switches = switches[currentCore()];
+
+    for (Size i = 0; i < PROCESS_STACK_SIZE; i += PAGESIZE)
+    {
+	if ((page = memory->lookupVirtual(this, kernelStackAddr - i)))
+	{
+	    /* Keep releaseAll() of the owner away from it. */
+	    memory->mapVirtual(this, page & PAGEMASK, kernelStackAddr - i,
+			       PAGE_PRESENT | PAGE_RW | PAGE_PINNED);
+	}
+	dead->pages[i / PAGESIZE] = page & PAGEMASK;
+    }
+}
+
+void X86Process::releaseStack(Size core)
+{
+    DeadStack *dead = &deadStacks[core];
+    X86Process *owner;
+
+    /* Nothing left, or still running on it? */
+    if (!dead->pages[0] || dead->switches == switches[core])
+    {
+	return;
+    }
+    /* The owner may have exited meanwhile, taking its page tables. */
+    owner = (X86Process *) Process::byID(dead->owner);
+
+    if (owner && owner->getPageDirectory() != dead->pageDir)
+    {
+	owner = ZERO;
+    }
+    for (Size i = 0; i < PROCESS_STACK_SIZE; i += PAGESIZE)
+    {
+	if (!dead->pages[i / PAGESIZE])
+	    continue;
+
+	if (owner)
+	    memory->unmapVirtual(owner, dead->stack - i);
+
+	memory->releasePhysical(dead->pages[i / PAGESIZE]);
+	dead->pages[i / PAGESIZE] = ZERO;
+    }
+}
+
+void X86Process::setParent(ProcessID id)
+{
+    ProcessPage *page = (ProcessPage *) memory->mapSlot(processPageAddr);
+    page->parent = id;
+    memory->unmapSlot((Address) page);
+}
+
 void X86Process::IOPort(u16 port, bool enabled)
 {
-    Address tmp = memory->mapVirtual(ioMapAddr);
+    Address tmp = memory->mapSlot(ioMapAddr);
     kernelTss.setPort(port, enabled, (u8 *) tmp);
-    memory->mapVirtual((Address) 0, tmp, 0);
+    memory->unmapSlot(tmp);
 }
 
 void X86Process::execute()
 {
-    /* Refresh I/O bitmap. */
-    memory->mapVirtual(ioMapAddr, (Address) &kernelioBitMap);
+    CoreInfo *core = smp->getCore(currentCore());
+
+    /* We leave the stack of a thread which was deleted on this core. */
+    releaseStack(currentCore());
+    switches[currentCore()]++;
+
+    /* Refresh I/O bitmap of this core. */
+    memory->mapVirtual(ioMapAddr, core->ioBitMap);
+
+    /* Give it a fresh time slice. */
+    kernel->startSlice(this);
+
+    /* Other cores flush our TLB when they change these page tables. */
+    core->pageDirectory = pageDirAddr;
 
     /* Perform a context switch. */
     contextSwitch( scheduler->old() ? &((X86Process *)scheduler->old())->stackAddr
 				    :  ZERO,
 		   pageDirAddr,
 		   stackAddr,
-		  &kernelTss,
+		   core->tss,
 		   kernelStackAddr);
 }
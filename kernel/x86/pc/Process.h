@@ -37,6 +37,41 @@ class ArchProcess;
 #include "Memory.h"
 #include <Types.h>
 
+/** Top of the user stack of a new Process. */
+#define USER_STACK_ADDR   0xc0000000
+
+/**
+ * Top of the kernel stack of a new Process. Threads get their kernel
+ * stack in a slot above this address, selected by their ID.
+ */
+#define KERNEL_STACK_ADDR 0xd0000000
+
+/** Size of the user and kernel stacks, in bytes. */
+#define PROCESS_STACK_SIZE (PAGESIZE * 4)
+
+/**
+ * Kernel stack of a thread deleted while its core still ran on it.
+ * The core releases it at its next context switch.
+ */
+typedef struct DeadStack
+{
+    /** Physical pages of the stack, or ZERO if released. */
+    Address pages[PROCESS_STACK_SIZE / PAGESIZE];
+
+    /** Top of the stack, in the address space of the owner. */
+    Address stack;
+
+    /** Owner of the thread. */
+    ProcessID owner;
+
+    /** Page directory of the owner. */
+    Address pageDir;
+
+    /** Context switches by the core before the thread was deleted. */
+    Size switches;
+}
+DeadStack;
+
 /**
  * Process which may execute on an Intel x86 CPU.
  */
@@ -50,6 +85,14 @@ class X86Process : public Process
          */
 	X86Process(Address entry);
 
+        /**
+         * Constructor function for threads.
+	 * @param entry Initial EIP register value.
+	 * @param owner Process whose address space we share.
+	 * @param stack Initial user stack pointer.
+         */
+	X86Process(Address entry, X86Process *owner, Address stack);
+
 	/**
 	 * Destructor function.
 	 */
@@ -94,7 +137,34 @@ class X86Process : public Process
 	    stackAddr = addr;
 	}
 
+	/**
+	 * Sets the parent in our ProcessPage.
+	 * @param id Identity of the parent process.
+	 * @see ProcessPage
+	 */
+	void setParent(ProcessID id);
+
     private:
+
+	/**
+	 * Allocate the kernel stack and fill in the initial registers.
+	 * @param entry Initial EIP register value.
+	 * @param userStack Initial user stack pointer.
+	 */
+	void setupStack(Address entry, Address userStack);
+
+	/**
+	 * Hand our kernel stack to the current core, which still runs on it.
+	 * @see releaseStack
+	 */
+	void deferStack();
+
+	/**
+	 * Release the kernel stack deferred on a core, once the
+	 * core switched away from it.
+	 * @param core Number of the core.
+	 */
+	static void releaseStack(Size core);
 	
 	/** Page Directory physical address. */
 	Address pageDirAddr;
@@ -107,6 +177,9 @@ class X86Process : public Process
 	
 	/** I/O bitmap physical address. */
 	Address ioMapAddr;
+
+	/** ProcessPage physical address. */
+	Address processPageAddr;
 };
 
 /**
@@ -0,0 +1,396 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/Scheduler.h>
+#include <FreeNOS/Spinlock.h>
+#include <FreeNOS/Kernel.h>
+#include <MemoryBlock.h>
+#include <String.h>
+#include "SMP.h"
+#include "CPU.h"
+#include "Interrupt.h"
+#include "Kernel.h"
+#include "Memory.h"
+
+/** Task State Segment and I/O bitmap page of the other cores. */
+static u8 coreTss[MAX_CORES][PAGESIZE * 2] ALIGN(PAGESIZE);
+
+/** Boot stacks of the other cores. */
+static u8 coreStacks[MAX_CORES][PAGESIZE * 4] ALIGN(PAGESIZE);
+
+/** Serializes the kernel between the cores. */
+static Spinlock kernelLock;
+
+/** Core holding kernelLock, or MAX_CORES if none. */
+static volatile Size kernelOwner = MAX_CORES;
+
+X86SMP::X86SMP() : coreCount(1), apicCount(0), enabled(false)
+{
+    u32 eax, ebx, ecx, edx;
+    Address apicAddr;
+
+    MemoryBlock::set(coreByAPIC, 0, sizeof(coreByAPIC));
+
+    /* The boot core keeps the TSS from boot.S. */
+    for (Size i = 0; i < MAX_CORES; i++)
+    {
+        cores[i].tss        = (TSS *) coreTss[i];
+        cores[i].ioBitMap   = (Address) (coreTss[i] + PAGESIZE);
+        cores[i].apicID     = 0;
+        cores[i].online     = false;
+        cores[i].ticks      = 0;
+        cores[i].sliceTicks = 0;
+        cores[i].sliceEnd   = 0;
+        cores[i].pageDirectory = ZERO;
+        cores[i].flushTLB      = false;
+    }
+    cores[0].tss      = &kernelTss;
+    cores[0].ioBitMap = (Address) kernelioBitMap;
+    cores[0].online   = true;
+
+    /* The boot core runs the kernel until it enters the first process. */
+    kernelLock.lock();
+    kernelOwner = 0;
+
+    /* Without local APIC, or without tables, stay on the boot core. */
+    cpuid(1, eax, ebx, ecx, edx);
+
+    if (!(edx & CPUID_APIC))
+        return;
+
+    if (!(apicAddr = parseMADT()) && !(apicAddr = parseMP()))
+        return;
+
+    apic.setAddress(apicAddr);
+    cores[0].apicID = apic.getID();
+    coreByAPIC[cores[0].apicID] = 0;
+    enabled = true;
+}
+
+Size X86SMP::current()
+{
+    return enabled ? coreByAPIC[apic.getID()] : 0;
+}
+
+void X86SMP::startCores()
+{
+    Size core;
+
+    if (!enabled)
+        return;
+
+    /* Copy the real mode entry code below 1MB. */
+    MemoryBlock::copy((void *) SMP_BOOT_ADDR, smpBoot16,
+                      smpBoot16End - smpBoot16);
+    asm volatile ("mov %%cr4, %0" : "=r"(smpBootCR4));
+
+    for (Size i = 0; i < apicCount && coreCount < MAX_CORES; i++)
+    {
+        if (apicIDs[i] == cores[0].apicID)
+            continue;
+
+        core = coreCount;
+        cores[core].apicID = apicIDs[i];
+        coreByAPIC[apicIDs[i]] = core;
+        smpBootStack = (Address) (coreStacks[core] + sizeof(coreStacks[core]));
+
+        /* INIT, then up to two STARTUP IPIs, as Intel prescribes. */
+        apic.sendIPI(apicIDs[i], APIC_IPI_INIT);
+        APIC::wait(10000);
+
+        for (Size j = 0; j < 2 && !cores[core].online; j++)
+        {
+            apic.sendIPI(apicIDs[i], APIC_IPI_STARTUP |
+                                     (SMP_BOOT_ADDR >> PAGESHIFT));
+            APIC::wait(200);
+        }
+        /* Give it 100 milliseconds to come up. */
+        for (Size j = 0; j < 100 && !cores[core].online; j++)
+        {
+            APIC::wait(1000);
+        }
+        if (cores[core].online)
+            coreCount++;
+    }
+    scheduler->setCoreCount(coreCount);
+}
+
+void X86SMP::wake(Size core)
+{
+    if (enabled && core != current())
+    {
+        apic.sendIPI(cores[core].apicID, APIC_IPI_FIXED | APIC_IPI_VECTOR);
+    }
+}
+
+void X86SMP::shootdown(Address pageDir)
+{
+    Size self = current();
+
+    if (!enabled)
+        return;
+
+    /* Other cores may cache entries of the page directory. */
+    for (Size i = 0; i < MAX_CORES; i++)
+    {
+        if (i != self && cores[i].online && cores[i].pageDirectory == pageDir)
+        {
+            cores[i].flushTLB = true;
+            apic.sendIPI(cores[i].apicID, APIC_IPI_FIXED | APIC_IPI_VECTOR);
+        }
+    }
+    /* They flush while waiting for the kernel lock, which we hold. */
+    for (Size i = 0; i < MAX_CORES; i++)
+    {
+        while (cores[i].flushTLB)
+            ;
+    }
+}
+
+void X86SMP::acknowledge()
+{
+    CoreInfo *core = &cores[current()];
+
+    if (core->flushTLB)
+    {
+        tlb_flush_all();
+        core->flushTLB = false;
+    }
+}
+
+void X86SMP::coreEntry()
+{
+    cores[current()].online = true;
+
+    /* Wait for the boot core to finish, then prepare ourselves. */
+    lockKernel();
+    kernel->initializeCore();
+
+    /* Run processes, or sleep until the next interrupt. */
+    while (true)
+    {
+        scheduler->executeNext();
+        unlockKernel();
+        irq_enable();
+        idle();
+        irq_disable();
+        lockKernel();
+    }
+}
+
+Address X86SMP::parseMADT()
+{
+    Address rsdp, ptr, entry, end;
+    RSDP root;
+    SDTHeader header;
+    MADTProcessor proc;
+    u32 apicAddr, table;
+    u16 ebda;
+
+    /* The RSDP is in the first KB of the EBDA, or in the BIOS area. */
+    readPhysical(0x40e, &ebda, sizeof(ebda));
+
+    if (!(rsdp = find("RSD PTR ", ebda << 4, 1024)) &&
+        !(rsdp = find("RSD PTR ", 0xe0000, 0x20000)))
+    {
+        return ZERO;
+    }
+    readPhysical(rsdp, &root, sizeof(root));
+    readPhysical(root.rsdtAddress, &header, sizeof(header));
+
+    /* Look for the APIC table in the RSDT. */
+    ptr = root.rsdtAddress + sizeof(header);
+    end = root.rsdtAddress + header.length;
+
+    for (; ptr < end; ptr += sizeof(u32))
+    {
+        readPhysical(ptr, &table, sizeof(table));
+        readPhysical(table, &header, sizeof(header));
+
+        if (String::strncmp(header.signature, "APIC", 4) == 0)
+            break;
+    }
+    if (ptr >= end)
+    {
+        return ZERO;
+    }
+    /* The local APIC address is followed by flags and the entries. */
+    readPhysical(table + sizeof(header), &apicAddr, sizeof(apicAddr));
+    end = table + header.length;
+
+    for (entry = table + sizeof(header) + 8; entry < end; entry += proc.length)
+    {
+        readPhysical(entry, &proc, sizeof(proc));
+
+        if (!proc.length)
+            break;
+
+        /* Enabled processor. */
+        if (proc.type == 0 && (proc.flags & 1))
+            addCore(proc.apicID);
+    }
+    return apicCount ? apicAddr : ZERO;
+}
+
+Address X86SMP::parseMP()
+{
+    Address ptr, entry;
+    MPFloat mpf;
+    MPConfig config;
+    MPProcessor proc;
+    u16 ebda;
+
+    /* Search the EBDA, the top of base memory and the BIOS ROM. */
+    readPhysical(0x40e, &ebda, sizeof(ebda));
+
+    if (!(ptr = find("_MP_", ebda << 4, 1024)) &&
+        !(ptr = find("_MP_", 0x9fc00, 1024)) &&
+        !(ptr = find("_MP_", 0xf0000, 0x10000)))
+    {
+        return ZERO;
+    }
+    readPhysical(ptr, &mpf, sizeof(mpf));
+
+    /* Default configurations have no table. */
+    if (!mpf.configAddress || mpf.features[0])
+    {
+        return ZERO;
+    }
+    readPhysical(mpf.configAddress, &config, sizeof(config));
+
+    if (String::strncmp(config.signature, "PCMP", 4) != 0)
+    {
+        return ZERO;
+    }
+    entry = mpf.configAddress + sizeof(config);
+
+    for (Size i = 0; i < config.entryCount; i++)
+    {
+        readPhysical(entry, &proc, sizeof(proc));
+
+        /* Processors have 20 byte entries, all others 8. */
+        if (proc.type == 0)
+        {
+            if (proc.flags & 1)
+                addCore(proc.apicID);
+
+            entry += sizeof(proc);
+        }
+        else
+            entry += 8;
+    }
+    return apicCount ? config.apicAddress : ZERO;
+}
+
+Address X86SMP::find(const char *signature, Address from, Size size)
+{
+    Size len = String::strlen(signature);
+    Address vaddr, addr;
+
+    for (Address page = from & PAGEMASK; page < from + size; page += PAGESIZE)
+    {
+        vaddr = memory->mapSlot(page);
+        addr  = page > from ? page : (from & ~0xf);
+
+        for (; addr < page + PAGESIZE && addr < from + size; addr += 16)
+        {
+            if (String::strncmp((char *) vaddr + (addr - page),
+                                signature, len) == 0)
+            {
+                memory->unmapSlot(vaddr);
+                return addr;
+            }
+        }
+        memory->unmapSlot(vaddr);
+    }
+    return ZERO;
+}
+
+void X86SMP::readPhysical(Address paddr, void *buffer, Size size)
+{
+    u8 *dst = (u8 *) buffer;
+    Address vaddr;
+    Size count;
+
+    /* One page at a time, through a mapping slot. */
+    while (size)
+    {
+        count = PAGESIZE - (paddr & ~PAGEMASK);
+        count = count < size ? count : size;
+        vaddr = memory->mapSlot(paddr & PAGEMASK);
+
+        MemoryBlock::copy(dst, (void *) (vaddr + (paddr & ~PAGEMASK)), count);
+        memory->unmapSlot(vaddr);
+
+        dst   += count;
+        paddr += count;
+        size  -= count;
+    }
+}
+
+void X86SMP::addCore(u8 apicID)
+{
+    if (apicCount < MAX_CORES)
+    {
+        apicIDs[apicCount++] = apicID;
+    }
+}
+
+extern C void smpEntry()
+{
+    smp->coreEntry();
+}
+
+Size currentCore()
+{
+    return smp ? smp->current() : 0;
+}
+
+void wakeCore(Size core)
+{
+    if (smp)
+    {
+        smp->wake(core);
+    }
+}
+
+extern C bool lockKernel()
+{
+    Size core = currentCore();
+
+    /* Entered the kernel again, while running kernel code. */
+    if (kernelOwner == core)
+    {
+        return false;
+    }
+    /* Another core may hold the lock, waiting for us to flush the TLB. */
+    while (!kernelLock.tryLock())
+    {
+        if (smp)
+            smp->acknowledge();
+    }
+    kernelOwner = core;
+    return true;
+}
+
+extern C void unlockKernel()
+{
+    kernelOwner = MAX_CORES;
+    kernelLock.unlock();
+}
+
+INITOBJ(X86SMP, smp, CORES)
@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __X86_SMP_H
+#define __X86_SMP_H
+
+/**   
+ * @defgroup x86kernel kernel (x86)  
+ * @{   
+ */
+
+/** Physical address where other cores start, in real mode. */
+#define SMP_BOOT_ADDR   0x7000
+
+#ifndef __ASSEMBLER__
+
+#include <FreeNOS/Scheduler.h>
+#include <Singleton.h>
+#include <Types.h>
+#include <Macros.h>
+#include "APIC.h"
+#include "CPU.h"
+
+/**
+ * ACPI Root System Description Pointer.
+ */
+typedef struct RSDP
+{
+    char signature[8];
+    u8 checksum;
+    char oem[6];
+    u8 revision;
+    u32 rsdtAddress;
+}
+RSDP;
+
+/**
+ * Header of ACPI System Description Tables.
+ */
+typedef struct SDTHeader
+{
+    char signature[4];
+    u32 length;
+    u8 revision;
+    u8 checksum;
+    char oem[6];
+    char oemTable[8];
+    u32 oemRevision;
+    u32 creator;
+    u32 creatorRevision;
+}
+SDTHeader;
+
+/**
+ * Processor entry in the ACPI Multiple APIC Description Table.
+ */
+typedef struct MADTProcessor
+{
+    u8 type;
+    u8 length;
+    u8 processorID;
+    u8 apicID;
+    u32 flags;
+}
+MADTProcessor;
+
+/**
+ * Intel MultiProcessor floating pointer structure.
+ */
+typedef struct MPFloat
+{
+    char signature[4];
+    u32 configAddress;
+    u8 length;
+    u8 revision;
+    u8 checksum;
+    u8 features[5];
+}
+MPFloat;
+
+/**
+ * Header of the Intel MultiProcessor configuration table.
+ */
+typedef struct MPConfig
+{
+    char signature[4];
+    u16 length;
+    u8 revision;
+    u8 checksum;
+    char oem[8];
+    char product[12];
+    u32 oemTable;
+    u16 oemTableSize;
+    u16 entryCount;
+    u32 apicAddress;
+    u16 extendedLength;
+    u8 extendedChecksum;
+    u8 reserved;
+}
+MPConfig;
+
+/**
+ * Processor entry in the Intel MultiProcessor configuration table.
+ */
+typedef struct MPProcessor
+{
+    u8 type;
+    u8 apicID;
+    u8 apicVersion;
+    u8 flags;
+    u32 signature;
+    u32 features;
+    u32 reserved[2];
+}
+MPProcessor;
+
+/**
+ * Per core state of the x86 kernel.
+ */
+typedef struct CoreInfo
+{
+    /** Task State Segment of the core. Must be first: see sysEnter.S. */
+    TSS *tss;
+
+    /** Virtual address of the I/O bitmap, the page behind the TSS. */
+    Address ioBitMap;
+
+    /** Local APIC identifier. */
+    u8 apicID;
+
+    /** Set by the core once it runs kernel code. */
+    volatile bool online;
+
+    /** Timer interrupts counted in the current slice, without local APIC. */
+    Size ticks;
+
+    /** Length of the current slice in timer interrupts, without local APIC. */
+    Size sliceTicks;
+
+    /** Timestamp counter at the end of the current slice, or zero if none. */
+    u64 sliceEnd;
+
+    /** Page directory loaded by the core. */
+    volatile Address pageDirectory;
+
+    /** Set by another core which changed the page tables in use here. */
+    volatile bool flushTLB;
+}
+CoreInfo;
+
+/**
+ * Discovers and starts the processor cores.
+ *
+ * The cores are listed by the ACPI MADT, or else by the Intel
+ * MultiProcessor table. Without either, or without a local APIC,
+ * only the boot core is used.
+ */
+class X86SMP : public Singleton<X86SMP>
+{
+    public:
+
+        /**
+         * Constructor function.
+         */
+        X86SMP();
+
+        /**
+         * Check if the local APICs are in use.
+         * @return True if enabled, false for a uniprocessor kernel.
+         */
+        bool isEnabled()
+        {
+            return enabled;
+        }
+
+        /**
+         * Get the local APIC.
+         * @return Pointer to the APIC.
+         */
+        APIC * getAPIC()
+        {
+            return &apic;
+        }
+
+        /**
+         * Get the state of a core.
+         * @param core Core number.
+         * @return Pointer to the CoreInfo.
+         */
+        CoreInfo * getCore(Size core)
+        {
+            return &cores[core];
+        }
+
+        /**
+         * Get the number of the executing core.
+         * @return Core number.
+         */
+        Size current();
+
+        /**
+         * Start all other cores. They wait for the kernel lock.
+         */
+        void startCores();
+
+        /**
+         * Interrupt another core, to let it reschedule.
+         * @param core Core number.
+         */
+        void wake(Size core);
+
+        /**
+         * Flush the TLB of the other cores running a page directory.
+         * Waits until they did, so the caller may reuse released pages.
+         * @param pageDir Physical address of the page directory.
+         */
+        void shootdown(Address pageDir);
+
+        /**
+         * Flush the TLB of the executing core, if another core asked for it.
+         */
+        void acknowledge();
+
+        /**
+         * First kernel code executed by the other cores.
+         */
+        void coreEntry();
+
+    private:
+
+        /**
+         * Find the cores in the ACPI Multiple APIC Description Table.
+         * @return Physical address of the local APICs, or ZERO if not found.
+         */
+        Address parseMADT();
+
+        /**
+         * Find the cores in the Intel MultiProcessor configuration table.
+         * @return Physical address of the local APICs, or ZERO if not found.
+         */
+        Address parseMP();
+
+        /**
+         * Search physical memory for a signature on a 16 byte boundary.
+         * @param signature Signature string to find.
+         * @param from Physical start address.
+         * @param size Number of bytes to search.
+         * @return Physical address of the signature, or ZERO if not found.
+         */
+        Address find(const char *signature, Address from, Size size);
+
+        /**
+         * Copy from physical memory.
+         * @param paddr Physical address.
+         * @param buffer Output buffer.
+         * @param size Number of bytes to copy.
+         */
+        void readPhysical(Address paddr, void *buffer, Size size);
+
+        /**
+         * Remember a core found in the tables.
+         * @param apicID Local APIC identifier of the core.
+         */
+        void addCore(u8 apicID);
+
+        /** State per core. */
+        CoreInfo cores[MAX_CORES];
+
+        /** Number of cores online. */
+        Size coreCount;
+
+        /** Local APIC identifiers found in the tables. */
+        u8 apicIDs[MAX_CORES];
+
+        /** Number of entries in apicIDs. */
+        Size apicCount;
+
+        /** Core number by local APIC identifier. */
+        u8 coreByAPIC[256];
+
+        /** True if the local APICs are in use. */
+        bool enabled;
+
+        /** The local APIC. */
+        APIC apic;
+};
+
+/** Processor cores. */
+extern X86SMP *smp;
+
+/**
+ * Real mode entry code of the other cores, copied to SMP_BOOT_ADDR.
+ * @see smpBoot.S
+ */
+extern C u8 smpBoot16[], smpBoot16End[];
+
+/** Control register 4 for the other cores. */
+extern C u32 smpBootCR4;
+
+/** Initial stack pointer of the starting core. */
+extern C Address smpBootStack;
+
+/**
+ * Called by smpBoot.S on the starting core.
+ */
+extern C void smpEntry();
+
+#endif /* __ASSEMBLER__ */
+
+/**
+ * @}
+ */
+
+#endif /* __X86_SMP_H */
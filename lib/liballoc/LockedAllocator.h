@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBALLOC_LOCKED_ALLOCATOR_H
+#define __LIBALLOC_LOCKED_ALLOCATOR_H
+
+#include <Types.h>
+#include "Allocator.h"
+
+/** 
+ * @defgroup liballoc liballoc 
+ * @{ 
+ */
+
+/**
+ * Lets threads of one process share a parent Allocator.
+ *
+ * Each call to the parent runs with a lock held. A thread which
+ * finds the lock taken gives up the CPU until the holder releases it.
+ */
+class LockedAllocator : public Allocator
+{
+    public:
+
+	/**
+	 * Class constructor.
+	 * @param p Allocator to serialize.
+	 */
+	LockedAllocator(Allocator *p);
+
+        /**
+         * Allocate memory from the parent.
+	 * @param size Amount of memory in bytes to allocate on input. 
+	 *             On output, the amount of memory in bytes actually allocated.
+         * @return New memory block on success and ZERO on failure.
+         */
+        Address allocate(Size *size);
+
+        /**
+         * Release memory to the parent.
+         * @param addr Points to memory previously returned by allocate().
+         * @see allocate
+         */
+        void release(Address addr);
+
+    private:
+
+	/**
+	 * Wait until we hold the lock.
+	 */
+	void lock();
+
+	/**
+	 * Release the lock.
+	 */
+	void unlock();
+
+	/** Non-zero while a thread uses the parent. */
+	volatile ulong locked;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __LIBALLOC_LOCKED_ALLOCATOR_H */
@@ -54,7 +54,7 @@ Address PageAllocator::allocate(Size *size)
     /* Fill in the message. */
     msg.action = CreatePrivate;
     msg.bytes  = bytes;
-    msg.protection      = PAGE_RW | PAGE_RESERVED;
+    msg.protection      = PAGE_RW | PAGE_RESERVED | PAGE_LAZY;
     msg.virtualAddress  = (1024 * 1024 * 16) + allocated;
     msg.physicalAddress = ZERO;
     msg.ipc(MEMSRV_PID, SendReceive, sizeof(msg));
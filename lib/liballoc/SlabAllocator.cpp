@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SlabAllocator.h"
+
+SlabAllocator::SlabAllocator(Size size)
+    : partial(ZERO), full(ZERO), empty(ZERO), objects(0), slabs(0)
+{
+    /* Free objects must be able to hold a pointer. */
+    objectSize = aligned(size < sizeof(Address) ? sizeof(Address) : size);
+}
+
+Address SlabAllocator::allocate(Size *size)
+{
+    Slab *slab;
+    Address *obj;
+
+    /* Does it fit? */
+    if (*size > objectSize)
+    {
+	return ZERO;
+    }
+    /* Prefer partially used slabs, then the empty one. */
+    if (!(slab = partial))
+    {
+	if (!(slab = empty) && !(slab = createSlab()))
+	{
+	    return ZERO;
+	}
+	move(slab, &empty, &partial);
+    }
+    /* Take the first free object. */
+    obj        = slab->free;
+    slab->free = (Address *) *obj;
+    slab->used++;
+    objects++;
+
+    /* Slab full now? */
+    if (!slab->free)
+    {
+	move(slab, &partial, &full);
+    }
+    *size = objectSize;
+    return (Address) obj;
+}
+
+void SlabAllocator::release(Address addr)
+{
+    Slab *slab = (Slab *) (addr & PAGEMASK);
+    Address *obj = (Address *) addr;
+
+    /* Put the object back on the free list of its slab. */
+    if (!slab->free)
+    {
+	move(slab, &full, &partial);
+    }
+    *obj       = (Address) slab->free;
+    slab->free = obj;
+    slab->used--;
+    objects--;
+
+    /* Keep one empty slab. Return any other to the parent. */
+    if (!slab->used)
+    {
+	if (empty)
+	{
+	    move(slab, &partial, ZERO);
+	    parent->release((Address) slab);
+	    slabs--;
+	}
+	else
+	    move(slab, &partial, &empty);
+    }
+}
+
+Size SlabAllocator::getObjectSize() const
+{
+    return objectSize;
+}
+
+Size SlabAllocator::getObjectCount() const
+{
+    return objects;
+}
+
+Size SlabAllocator::getSlabCount() const
+{
+    return slabs;
+}
+
+Slab * SlabAllocator::createSlab()
+{
+    Size size = PAGESIZE, count;
+    Address first;
+    Slab *slab;
+
+    /* Ask for a new page. */
+    if (!parent || !(slab = (Slab *) parent->allocate(&size)))
+    {
+	return ZERO;
+    }
+    first = aligned((Address) (slab + 1));
+    count = (PAGESIZE - (first - (Address) slab)) / objectSize;
+    slab->cache = this;
+    slab->prev  = ZERO;
+    slab->next  = empty;
+    slab->free  = ZERO;
+    slab->used  = 0;
+
+    /* Chain all objects behind the slab together, lowest first. */
+    while (count--)
+    {
+	*(Address *) (first + (count * objectSize)) = (Address) slab->free;
+	slab->free = (Address *) (first + (count * objectSize));
+    }
+    /* Put it on the empty list. */
+    if (empty)
+    {
+	empty->prev = slab;
+    }
+    empty = slab;
+    slabs++;
+
+    return slab;
+}
+
+void SlabAllocator::move(Slab *slab, Slab **from, Slab **to)
+{
+    /* Unlink. */
+    if (slab->prev)
+	slab->prev->next = slab->next;
+    else
+	*from = slab->next;
+
+    if (slab->next)
+	slab->next->prev = slab->prev;
+
+    /* Insert at the head of the new list, if any. */
+    if (to)
+    {
+	slab->prev = ZERO;
+	slab->next = *to;
+
+	if (*to)
+	    (*to)->prev = slab;
+	*to = slab;
+    }
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBALLOC_SLABALLOCATOR_H
+#define __LIBALLOC_SLABALLOCATOR_H
+
+#include <Arch/Memory.h>
+#include <Types.h>
+#include "Allocator.h"
+
+/**
+ * @defgroup liballoc liballoc
+ * @{
+ */
+
+/** Forward declaration. */
+class SlabAllocator;
+
+/**
+ * One page of equally sized objects.
+ * The Slab itself is stored at the start of the page.
+ */
+typedef struct Slab
+{
+    /** Cache owning this slab. Must be the first member. */
+    SlabAllocator *cache;
+
+    /** Previous and next slab on the same list. */
+    Slab *prev, *next;
+
+    /** First free object. Each free object points to the next. */
+    Address *free;
+
+    /** Number of objects handed out. */
+    Size used;
+}
+Slab;
+
+/**
+ * Allocates objects of a single size from page sized slabs.
+ *
+ * The parent Allocator must return page aligned memory of PAGESIZE bytes.
+ * Each slab keeps its own free list. One empty slab is kept around, to
+ * avoid returning and requesting pages all the time.
+ */
+class SlabAllocator : public Allocator
+{
+    public:
+
+	/**
+	 * Class constructor.
+	 * @param objectSize Size of each object in bytes.
+	 */
+	SlabAllocator(Size objectSize = sizeof(Address));
+
+	/**
+	 * Allocate one object.
+	 * @param size Must be at most the object size. On output, the object size.
+	 * @return Address of the object on success and ZERO on failure.
+	 */
+	Address allocate(Size *size);
+
+	/**
+	 * Release an object.
+	 * @param addr Points to memory previously returned by allocate().
+	 */
+	void release(Address addr);
+
+	/**
+	 * Size of the objects in this cache.
+	 * @return Size in bytes.
+	 */
+	Size getObjectSize() const;
+
+	/**
+	 * Number of objects handed out.
+	 * @return Object count.
+	 */
+	Size getObjectCount() const;
+
+	/**
+	 * Number of pages in use by this cache.
+	 * @return Slab count.
+	 */
+	Size getSlabCount() const;
+
+    private:
+
+	/**
+	 * Get a new slab from the parent Allocator.
+	 * @return Pointer to the slab on success and ZERO on failure.
+	 */
+	Slab * createSlab();
+
+	/**
+	 * Move a slab from one list to another.
+	 * @param slab Slab to move.
+	 * @param from List containing the slab.
+	 * @param to List to insert the slab into.
+	 */
+	static void move(Slab *slab, Slab **from, Slab **to);
+
+	/** Slabs with free and used objects, only used, and only free objects. */
+	Slab *partial, *full, *empty;
+
+	/** Size of each object. */
+	Size objectSize;
+
+	/** Number of objects handed out. */
+	Size objects;
+
+	/** Number of slabs. */
+	Size slabs;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __LIBALLOC_SLABALLOCATOR_H */
@@ -51,6 +51,7 @@ Address VMCtlAllocator::allocate(Size *size)
 	range.virtualAddress  = ret + bytes;
 	range.physicalAddress = ZERO;
 	range.bytes = PAGESIZE;
+	range.protection = PAGE_PRESENT | PAGE_USER | PAGE_RW | PAGE_LAZY;
     
 	VMCtl(SELF, Map, &range);
     }
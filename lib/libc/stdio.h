@@ -51,6 +51,51 @@
  * @{
  */
 
+/** End-of-file return value. */
+#define EOF		-1
+
+/** Default size of stream buffers, in bytes. */
+#define BUFSIZ		1024
+
+/** Input/output fully buffered. */
+#define _IOFBF		0
+
+/** Input/output line buffered. */
+#define _IOLBF		1
+
+/** Input/output unbuffered. */
+#define _IONBF		2
+
+/**
+ * @brief Stream state flags
+ * @{
+ */
+
+/** Stream is opened for reading. */
+#define __SRD		(1 << 0)
+
+/** Stream is opened for writing. */
+#define __SWR		(1 << 1)
+
+/** Stream buffer currently holds unwritten output. */
+#define __SOUT		(1 << 2)
+
+/** End-of-file was encountered. */
+#define __SEOF		(1 << 3)
+
+/** An I/O error occurred. */
+#define __SERR		(1 << 4)
+
+/** Buffer was allocated by the library and must be freed. */
+#define __SMBF		(1 << 5)
+
+/** Pick line or full buffering with isatty() at first use. */
+#define __STTY		(1 << 6)
+
+/**
+ * @}
+ */
+
 /**
  * A structure containing information about a file.
  */
@@ -58,9 +103,78 @@ typedef struct FILE
 {
     /** File descriptor. */
     int fd;
+
+    /** Stream state flags. */
+    int flags;
+
+    /** Buffering mode: _IOFBF, _IOLBF or _IONBF. */
+    int mode;
+
+    /** Stream buffer, allocated on first use. */
+    char *buffer;
+
+    /** Size of the stream buffer. */
+    size_t size;
+
+    /** Number of valid bytes in the buffer. */
+    size_t count;
+
+    /** Read position inside the buffer. */
+    size_t position;
+
+    /** Next stream in the list of open streams. */
+    struct FILE *next;
 }
 FILE;
 
+/** Standard input stream. */
+extern C FILE *stdin;
+
+/** Standard output stream. */
+extern C FILE *stdout;
+
+/** Standard error output stream. */
+extern C FILE *stderr;
+
+/** List of all open streams, used by fflush(NULL). */
+extern C FILE *__streams;
+
+/**
+ * Retrieve the buffer of a stream, allocating it if needed.
+ * @param stream File stream.
+ * @return Pointer to the buffer or NULL if the stream is unbuffered.
+ */
+extern C char * __sbuffer(FILE *stream);
+
+/**
+ * Write bytes directly to the file descriptor of a stream.
+ * @param stream File stream.
+ * @param buf Input buffer.
+ * @param size Number of bytes to write.
+ * @return Zero on success and EOF on failure.
+ */
+extern C int __swrite(FILE *stream, const char *buf, size_t size);
+
+/**
+ * Refill the buffer of an input stream.
+ * @param stream File stream.
+ * @return Zero on success and EOF on end-of-file or error.
+ */
+extern C int __srefill(FILE *stream);
+
+/**
+ * Format a string into a buffer, as vsnprintf() does.
+ * @param stream If not NULL, the buffer is written to this stream
+ *               each time it fills up, so output is never truncated.
+ * @param buffer String buffer to write to.
+ * @param size Size of the buffer.
+ * @param fmt Formatted string.
+ * @param args Argument list.
+ * @return Number of bytes formatted, or -1 if writing to the stream failed.
+ */
+extern C int __vformat(FILE *stream, char *buffer, unsigned int size,
+		       const char *fmt, va_list args);
+
 /**
  * @brief Open a stream.
  *
@@ -133,6 +247,132 @@ extern C size_t fread(void *ptr, size_t size,
  */
 extern C int fclose(FILE *stream);
 
+/**
+ * @brief Binary output.
+ *
+ * The fwrite() function shall write, from the array pointed to by ptr,
+ * up to nitems elements whose size is specified by size, to the stream
+ * pointed to by stream. The file-position indicator for the stream
+ * (if defined) shall be advanced by the number of bytes successfully
+ * written. If an error occurs, the resulting value of the file-position
+ * indicator for the stream is unspecified.
+ *
+ * @param ptr Input buffer.
+ * @param size Size of each item to write.
+ * @param nitems Number of items to write.
+ * @param stream FILE pointer to write to.
+ * @return The fwrite() function shall return the number of elements
+ *         successfully written, which may be less than nitems if a
+ *         write error is encountered. If size or nitems is 0, fwrite()
+ *         shall return 0 and the state of the stream remains unchanged.
+ */
+extern C size_t fwrite(const void *ptr, size_t size,
+		       size_t nitems, FILE *stream);
+
+/**
+ * @brief Flush a stream.
+ *
+ * If stream points to an output stream or an update stream in which
+ * the most recent operation was not input, fflush() shall cause any
+ * unwritten data for that stream to be written to the file. If stream
+ * is a null pointer, fflush() shall perform this flushing action on
+ * all streams for which the behavior is defined above.
+ *
+ * For a stream open for reading, buffered input is discarded and the
+ * file offset is moved back to the first unread byte, if the file is
+ * capable of seeking.
+ *
+ * @param stream File stream to flush, or NULL for all streams.
+ * @return Upon successful completion, fflush() shall return 0; otherwise,
+ *         it shall set the error indicator for the stream, return EOF,
+ *         and set errno to indicate the error.
+ */
+extern C int fflush(FILE *stream);
+
+/**
+ * @brief Assign buffering to a stream.
+ *
+ * The setvbuf() function may be used after the stream pointed to by
+ * stream is associated with an open file but before any other operation
+ * is performed on the stream. The argument type determines how stream
+ * shall be buffered: _IOFBF causes input/output to be fully buffered,
+ * _IOLBF causes input/output to be line buffered and _IONBF causes
+ * input/output to be unbuffered. If buf is not a null pointer, the
+ * array it points to may be used instead of a buffer allocated by setvbuf().
+ *
+ * @param stream File stream to modify.
+ * @param buf Buffer to use, or NULL to let the library allocate one.
+ * @param type Buffering mode.
+ * @param size Size of the buffer.
+ * @return Upon successful completion, setvbuf() shall return 0.
+ *         Otherwise, it shall return a non-zero value if an invalid
+ *         value is given for type or if the request cannot be honored.
+ */
+extern C int setvbuf(FILE *stream, char *buf, int type, size_t size);
+
+/**
+ * @brief Put a byte on a stream.
+ *
+ * The fputc() function shall write the byte specified by c (converted
+ * to an unsigned char) to the output stream pointed to by stream.
+ *
+ * @param c Byte to write.
+ * @param stream File stream to write to.
+ * @return Upon successful completion, fputc() shall return the value it
+ *         has written. Otherwise, it shall return EOF and the error
+ *         indicator for the stream shall be set.
+ */
+extern C int fputc(int c, FILE *stream);
+
+/**
+ * @brief Put a string on a stream.
+ *
+ * The fputs() function shall write the null-terminated string pointed
+ * to by s to the stream pointed to by stream. The terminating null byte
+ * shall not be written.
+ *
+ * @param s String to write.
+ * @param stream File stream to write to.
+ * @return Upon successful completion, fputs() shall return a non-negative
+ *         number. Otherwise, it shall return EOF and set errno to
+ *         indicate the error.
+ */
+extern C int fputs(const char *s, FILE *stream);
+
+/**
+ * @brief Get a byte from a stream.
+ *
+ * If the end-of-file indicator for the input stream pointed to by stream
+ * is not set and a next byte is present, the fgetc() function shall obtain
+ * the next byte as an unsigned char converted to an int, from the input
+ * stream pointed to by stream.
+ *
+ * @param stream File stream to read from.
+ * @return Upon successful completion, fgetc() shall return the next byte
+ *         from the input stream. If the end-of-file indicator for the
+ *         stream is set, or if the stream is at end-of-file, fgetc()
+ *         shall return EOF. If a read error occurs, the error indicator
+ *         for the stream shall be set and fgetc() shall return EOF.
+ */
+extern C int fgetc(FILE *stream);
+
+/**
+ * @brief Get a string from a stream.
+ *
+ * The fgets() function shall read bytes from stream into the array
+ * pointed to by s, until n-1 bytes are read, or a <newline> is read and
+ * transferred to s, or an end-of-file condition is encountered. The
+ * string is then terminated with a null byte.
+ *
+ * @param s Output buffer.
+ * @param n Size of the output buffer.
+ * @param stream File stream to read from.
+ * @return Upon successful completion, fgets() shall return s. If the
+ *         stream is at end-of-file before any bytes are read, or a read
+ *         error occurs, fgets() shall return a null pointer.
+ */
+extern C char * fgets(char *s, int n, FILE *stream);
+
 /**
  * @}
  */
@@ -152,7 +392,9 @@ extern C int fclose(FILE *stream);
  * @param size Maximum number of bytes to write.
  * @param fmt Formatted string.
  * @param ... Argument list.
- * @return Number of bytes written to the buffer.
+ * @return Number of bytes written to the buffer, excluding the
+ *         terminating zero.
+ * @see vsnprintf
  */
 extern C int snprintf(char *buffer, unsigned int size, const char *fmt, ...);
 
@@ -162,7 +404,12 @@ extern C int snprintf(char *buffer, unsigned int size, const char *fmt, ...);
  * @param size Maximum number of bytes to write.
  * @param fmt Formatted string.
  * @param args Argument list.
- * @return Number of bytes written to the buffer.
+ * @return Number of bytes written to the buffer, excluding the
+ *         terminating zero. Output is truncated to fit.
+ *
+ * Supports the flags '-', '0', '+', ' ' and '#', field width and
+ * precision (including '*'), the length modifiers hh, h, l, ll, j, z
+ * and t, and the conversions d, i, u, o, x, X, p, c, s and %.
  */
 extern C int vsnprintf(char *buffer, unsigned int size, const char *fmt, va_list args);
 
@@ -182,6 +429,24 @@ extern C int printf(const char *format, ...);
  */
 extern C int vprintf(const char *format, va_list args);
 
+/**
+ * Output a formatted string to a stream.
+ * @param stream File stream to write to.
+ * @param format Formatted string.
+ * @param ... Argument list.
+ * @return Number of bytes written or error code on failure.
+ */
+extern C int fprintf(FILE *stream, const char *format, ...);
+
+/**
+ * Output a formatted string to a stream, using a variable argument list.
+ * @param stream File stream to write to.
+ * @param format Formatted string.
+ * @param args Argument list.
+ * @return Number of bytes written or error code on failure.
+ */
+extern C int vfprintf(FILE *stream, const char *format, va_list args);
+
 /**
  * @}
  */
@@ -22,11 +22,32 @@
 
 int fclose(FILE *stream)
 {
-    /* Close and free. */
-    close(stream->fd);
-    free(stream);
-    
-    /* Success. */
-    errno = 0;
-    return 0;
+    FILE **f;
+    int ret;
+
+    /* Write out pending output and close. */
+    ret = fflush(stream);
+
+    if (close(stream->fd) != 0)
+	ret = EOF;
+
+    /* Remove from the list of open streams. */
+    for (f = &__streams; *f; f = &(*f)->next)
+    {
+	if (*f == stream)
+	{
+	    *f = stream->next;
+	    break;
+	}
+    }
+    /* Release buffer. */
+    if (stream->flags & __SMBF)
+	free(stream->buffer);
+
+    /* Standard streams are statically allocated. */
+    if (stream != stdin && stream != stdout && stream != stderr)
+	free(stream);
+
+    /* Done. */
+    return ret;
 }
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <unistd.h>
+#include "stdio.h"
+#include "stdlib.h"
+#include "errno.h"
+
+int fflush(FILE *stream)
+{
+    FILE *f;
+    int ret = 0;
+
+    /* Flush all streams. */
+    if (!stream)
+    {
+	for (f = __streams; f; f = f->next)
+	{
+	    if (f->flags & __SOUT && fflush(f) != 0)
+		ret = EOF;
+	}
+	return ret;
+    }
+    /* Write out pending output. */
+    if (stream->flags & __SOUT)
+    {
+	ret = __swrite(stream, stream->buffer, stream->count);
+	stream->flags &= ~__SOUT;
+    }
+    /* Give back unread input, so the descriptor is where the reader is. */
+    else if (stream->count > stream->position)
+    {
+	lseek(stream->fd, -(off_t) (stream->count - stream->position), SEEK_CUR);
+    }
+    /* Reset buffer. */
+    stream->count    = 0;
+    stream->position = 0;
+    return ret;
+}
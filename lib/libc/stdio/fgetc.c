@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <unistd.h>
+#include "stdio.h"
+
+int fgetc(FILE *stream)
+{
+    unsigned char ch;
+
+    /* Must be opened for reading. */
+    if (!(stream->flags & __SRD))
+    {
+	stream->flags |= __SERR;
+	return EOF;
+    }
+    /* Unbuffered streams read a single byte. */
+    if (!__sbuffer(stream))
+    {
+	if (fflush(stream) != 0)
+	    return EOF;
+
+	switch (read(stream->fd, &ch, 1))
+	{
+	    case -1:
+		stream->flags |= __SERR;
+		return EOF;
+
+	    case 0:
+		stream->flags |= __SEOF;
+		return EOF;
+
+	    default:
+		return ch;
+	}
+    }
+    /* Refill the buffer when exhausted. */
+    if (stream->position >= stream->count && __srefill(stream) != 0)
+	return EOF;
+
+    return (unsigned char) stream->buffer[stream->position++];
+}
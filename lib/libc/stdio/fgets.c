@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdio.h"
+
+char * fgets(char *s, int n, FILE *stream)
+{
+    int c, i = 0;
+
+    /* Only room for the terminator. */
+    if (n == 1)
+    {
+	s[0] = ZERO;
+	return s;
+    }
+    /* Read until newline, end-of-file or a full buffer. */
+    while (i < n - 1 && (c = fgetc(stream)) != EOF)
+    {
+	s[i++] = c;
+
+	if (c == '\n')
+	    break;
+    }
+    /* Nothing read at all? */
+    if (i == 0 || stream->flags & __SERR)
+	return NULL;
+
+    s[i] = ZERO;
+    return s;
+}
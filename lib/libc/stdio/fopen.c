@@ -25,21 +25,57 @@ FILE * fopen(const char *filename,
              const char *mode)
 {
     FILE *f;
+    int flags, oflag;
 
     /* Handle the file stream request. */
     switch (*mode)
     {
 	/* Read. */
 	case 'r':
-	    f = malloc(sizeof(FILE));
-	    f->fd = open(filename, ZERO);
-	    return f;
+	    flags = __SRD;
+	    oflag = O_RDONLY;
+	    break;
+
+	/* Write and append. */
+	case 'w':
+	case 'a':
+	    flags = __SWR;
+	    oflag = O_WRONLY | O_CREAT | (*mode == 'w' ? O_TRUNC : O_APPEND);
+	    break;
 
 	/* Unsupported. */	
 	default:
-	    break;
+	    errno = ENOTSUP;
+	    return NULL;
+    }
+    /* Update mode. */
+    if (mode[1] == '+' || (mode[1] && mode[2] == '+'))
+    {
+	flags = __SRD | __SWR;
+	oflag = (oflag & ~(O_RDONLY | O_WRONLY)) | O_RDWR;
     }
-    /* Sorry, not available yet! */
-    errno = ENOTSUP;
-    return NULL;
+    /* Allocate the stream. */
+    if (!(f = malloc(sizeof(FILE))))
+    {
+	errno = ENOMEM;
+	return NULL;
+    }
+    /* Open the file. */
+    if ((f->fd = open(filename, oflag)) < 0)
+    {
+	free(f);
+	return NULL;
+    }
+    /* Regular files are fully buffered. The buffer is allocated on first use. */
+    f->flags    = flags;
+    f->mode     = _IOFBF;
+    f->buffer   = NULL;
+    f->size     = 0;
+    f->count    = 0;
+    f->position = 0;
+
+    /* Add to the list of open streams. */
+    f->next   = __streams;
+    __streams = f;
+    return f;
 }
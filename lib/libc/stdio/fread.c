@@ -16,6 +16,7 @@
  */
 
 #include <unistd.h>
+#include <string.h>
 #include <sys/types.h>
 #include "stdio.h"
 #include "stdlib.h"
@@ -24,15 +25,60 @@
 size_t fread(void *ptr, size_t size,
              size_t nitems, FILE *stream)
 {
-    size_t num = 0, i;
     char *buf = (char *) ptr;
-    
-    /* Read items. */
-    for (i = 0; i < nitems; i++)
+    size_t total = size * nitems, left = total, num;
+    ssize_t e;
+
+    /* Nothing to do? */
+    if (!total)
+	return 0;
+
+    /* Must be opened for reading. */
+    if (!(stream->flags & __SRD))
     {
-	num += read(stream->fd, buf, size);
-	buf += size;
+	stream->flags |= __SERR;
+	errno = EBADF;
+	return 0;
+    }
+    /* Write out any pending output first. */
+    if (stream->flags & __SOUT && fflush(stream) != 0)
+	return 0;
+
+    /* Consume buffered input. */
+    num = stream->count - stream->position;
+    num = num < left ? num : left;
+
+    if (num)
+    {
+	memcpy(buf, stream->buffer + stream->position, num);
+	stream->position += num;
+	buf  += num;
+	left -= num;
+    }
+    while (left > 0)
+    {
+	/* Read large or unbuffered requests directly into the caller's buffer. */
+	if (!__sbuffer(stream) || left >= stream->size)
+	{
+	    if ((e = read(stream->fd, buf, left)) <= 0)
+	    {
+		stream->flags |= e == 0 ? __SEOF : __SERR;
+		break;
+	    }
+	    buf  += e;
+	    left -= e;
+	    continue;
+	}
+	/* Refill the buffer. */
+	if (__srefill(stream) != 0)
+	    break;
+
+	num = stream->count < left ? stream->count : left;
+	memcpy(buf, stream->buffer, num);
+	stream->position = num;
+	buf  += num;
+	left -= num;
     }
     /* Done. */
-    return num;
+    return (total - left) / size;
 }
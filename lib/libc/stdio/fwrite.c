@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "stdio.h"
+#include "stdlib.h"
+#include "errno.h"
+
+size_t fwrite(const void *ptr, size_t size,
+              size_t nitems, FILE *stream)
+{
+    const char *buf = (const char *) ptr;
+    size_t total = size * nitems, left = total, num;
+
+    /* Nothing to do? */
+    if (!total)
+	return 0;
+
+    /* Must be opened for writing. */
+    if (!(stream->flags & __SWR))
+    {
+	stream->flags |= __SERR;
+	errno = EBADF;
+	return 0;
+    }
+    /* Discard any buffered input, writing where the reader stopped. */
+    if (!(stream->flags & __SOUT))
+    {
+	fflush(stream);
+    }
+    /* Unbuffered streams write through immediately. */
+    if (!__sbuffer(stream))
+    {
+	return __swrite(stream, buf, total) == 0 ? nitems : 0;
+    }
+    /* Fill the buffer, flushing it when full. */
+    while (left > 0)
+    {
+	if (stream->count == stream->size && fflush(stream) != 0)
+	    break;
+
+	/* Large writes bypass an empty buffer. */
+	if (stream->count == 0 && left >= stream->size)
+	{
+	    if (__swrite(stream, buf, left) == 0)
+		left = 0;
+	    break;
+	}
+	num = stream->size - stream->count;
+	num = num < left ? num : left;
+
+	memcpy(stream->buffer + stream->count, buf, num);
+	stream->count += num;
+	stream->flags |= __SOUT;
+	buf  += num;
+	left -= num;
+    }
+    /* Line buffered streams flush on newline. */
+    if (stream->mode == _IOLBF && stream->flags & __SOUT &&
+        memchr(ptr, '\n', total - left) && fflush(stream) != 0)
+    {
+	return 0;
+    }
+    return (total - left) / size;
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "errno.h"
+
+int setvbuf(FILE *stream, char *buf, int type, size_t size)
+{
+    /* Validate the buffering mode. */
+    if (type != _IOFBF && type != _IOLBF && type != _IONBF)
+    {
+	errno = EINVAL;
+	return -1;
+    }
+    /* Write out anything pending in the old buffer. */
+    if (fflush(stream) != 0)
+	return -1;
+
+    /* Release the old buffer. */
+    if (stream->flags & __SMBF)
+    {
+	free(stream->buffer);
+	stream->flags &= ~__SMBF;
+    }
+    /* Apply the new buffer. When buf is NULL, it is allocated on first use. */
+    stream->flags &= ~__STTY;
+    stream->mode   = type;
+    stream->buffer = type == _IONBF ? NULL : buf;
+    stream->size   = type == _IONBF ? 0    : size;
+    return 0;
+}
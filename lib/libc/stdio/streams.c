@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <unistd.h>
+#include "stdio.h"
+#include "stdlib.h"
+#include "errno.h"
+
+/** Standard error output, unbuffered. */
+static FILE __stderr = { 2, __SWR, _IONBF, NULL, 0, 0, 0, NULL };
+
+/** Standard output, line buffered on a terminal, else fully buffered. */
+static FILE __stdout = { 1, __SWR | __STTY, _IOLBF, NULL, 0, 0, 0, &__stderr };
+
+/** Standard input, line buffered on a terminal, else fully buffered. */
+static FILE __stdin  = { 0, __SRD | __STTY, _IOLBF, NULL, 0, 0, 0, &__stdout };
+
+FILE *stdin  = &__stdin;
+FILE *stdout = &__stdout;
+FILE *stderr = &__stderr;
+FILE *__streams = &__stdin;
+
+char * __sbuffer(FILE *stream)
+{
+    /* Only interactive streams need to be line buffered. */
+    if (stream->flags & __STTY)
+    {
+	stream->flags &= ~__STTY;
+	stream->mode   = isatty(stream->fd) ? _IOLBF : _IOFBF;
+    }
+    /* Unbuffered streams bypass the buffer entirely. */
+    if (stream->mode == _IONBF)
+	return NULL;
+
+    /* Allocate the buffer on first use. */
+    if (!stream->buffer)
+    {
+	if (!stream->size)
+	    stream->size = BUFSIZ;
+
+	if (!(stream->buffer = malloc(stream->size)))
+	{
+	    stream->size = 0;
+	    stream->mode = _IONBF;
+	    return NULL;
+	}
+	stream->flags |= __SMBF;
+    }
+    return stream->buffer;
+}
+
+int __swrite(FILE *stream, const char *buf, size_t size)
+{
+    ssize_t e;
+
+    /* Keep writing until all bytes are out. */
+    while (size > 0)
+    {
+	if ((e = write(stream->fd, buf, size)) <= 0)
+	{
+	    stream->flags |= __SERR;
+	    return EOF;
+	}
+	buf  += e;
+	size -= e;
+    }
+    return 0;
+}
+
+int __srefill(FILE *stream)
+{
+    FILE *f;
+    ssize_t e;
+
+    /* Flush pending output first. */
+    if (stream->flags & __SOUT && fflush(stream) != 0)
+	return EOF;
+
+    /* Reading from an interactive stream flushes line buffered output. */
+    if (stream->mode != _IOFBF)
+    {
+	for (f = __streams; f; f = f->next)
+	{
+	    if (f->mode == _IOLBF && f->flags & __SOUT)
+		fflush(f);
+	}
+    }
+    /* Fill the buffer. */
+    stream->position = 0;
+    stream->count    = 0;
+
+    switch ((e = read(stream->fd, stream->buffer, stream->size)))
+    {
+	case -1:
+	    stream->flags |= __SERR;
+	    return EOF;
+
+	case 0:
+	    stream->flags |= __SEOF;
+	    return EOF;
+
+	default:
+	    stream->count = e;
+	    return 0;
+    }
+}
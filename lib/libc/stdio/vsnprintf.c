@@ -17,94 +17,449 @@
 
 #include "stdarg.h"
 #include "stdio.h"
-#include "stdlib.h"
+#include "string.h"
 
-int vsnprintf(char *buffer, unsigned int size, const char *fmt, va_list args)
+/**
+ * @name Conversion flags.
+ * @{
+ */
+
+/** Left justify within the field width. */
+#define FMT_LEFT	(1 << 0)
+
+/** Pad the field width with zeroes. */
+#define FMT_ZERO	(1 << 1)
+
+/** Always print a sign for signed conversions. */
+#define FMT_PLUS	(1 << 2)
+
+/** Print a space in place of a plus sign. */
+#define FMT_SPACE	(1 << 3)
+
+/** Alternate form: 0x for hexadecimal, leading 0 for octal. */
+#define FMT_ALT		(1 << 4)
+
+/** Use uppercase hexadecimal digits. */
+#define FMT_UPPER	(1 << 5)
+
+/**
+ * @}
+ */
+
+/** Size of the scratch buffer for digits. Holds a 64-bit octal number. */
+#define FMT_DIGITS	24
+
+/** Two decimal digits for each value below 100. */
+static const char digitPairs[] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+/** Hexadecimal digits, lowercase followed by uppercase. */
+static const char hexDigits[] = "0123456789abcdef0123456789ABCDEF";
+
+/**
+ * Divide a 64-bit number by a 32-bit divisor.
+ *
+ * Libgcc is not linked in, so the compiler's 64-bit division
+ * helpers are unavailable. The upper word is divided directly, and
+ * the lower word is shifted in one bit at a time.
+ *
+ * @param number Number to divide. Replaced by the quotient.
+ * @param divisor Divisor.
+ * @return Remainder of the division.
+ */
+static u32 divide64(u64 *number, u32 divisor)
+{
+    u32 high = *number >> 32, low = *number;
+    u64 remainder = high % divisor;
+    u32 quotient = 0;
+    int i;
+
+    for (i = 31; i >= 0; i--)
+    {
+	remainder = (remainder << 1) | ((low >> i) & 1);
+	quotient <<= 1;
+
+	if (remainder >= divisor)
+	{
+	    remainder -= divisor;
+	    quotient  |= 1;
+	}
+    }
+    *number = ((u64)(high / divisor) << 32) | quotient;
+    return remainder;
+}
+
+/**
+ * Convert a 32-bit number to decimal, two digits per step.
+ * @param end Points just past the last digit to write.
+ * @param value Number to convert.
+ * @param minimum Minimum number of digits, padded with zeroes.
+ * @return Pointer to the first digit written.
+ */
+static char * decimal32(char *end, u32 value, int minimum)
+{
+    char *ptr = end;
+    u32 pair;
+
+    while (value >= 100)
+    {
+	pair    = (value % 100) * 2;
+	value  /= 100;
+	*--ptr  = digitPairs[pair + 1];
+	*--ptr  = digitPairs[pair];
+    }
+    if (value >= 10)
+    {
+	*--ptr = digitPairs[value * 2 + 1];
+	*--ptr = digitPairs[value * 2];
+    }
+    else
+	*--ptr = '0' + value;
+
+    while (end - ptr < minimum)
+	*--ptr = '0';
+
+    return ptr;
+}
+
+/**
+ * Convert a number to digits in the given base.
+ * @param end Points just past the last digit to write.
+ * @param value Number to convert.
+ * @param base Either 8, 10 or 16.
+ * @param flags Conversion flags.
+ * @return Pointer to the first digit written.
+ */
+static char * digits(char *end, u64 value, int base, int flags)
 {
-    char buf[20], *ptr;
-    int ch, length = -1, i;
-    unsigned int written = 0;
-    
+    const char *table = hexDigits + ((flags & FMT_UPPER) ? 16 : 0);
+    char *ptr = end;
+
+    switch (base)
+    {
+	case 10:
+	    /* Peel off nine digits at a time until 32 bits are left. */
+	    while (value >> 32)
+		ptr = decimal32(ptr, divide64(&value, 1000000000), 9);
+
+	    return decimal32(ptr, value, 0);
+
+	case 16:
+	    do
+	    {
+		*--ptr  = table[value & 0xf];
+		value >>= 4;
+	    }
+	    while (value);
+	    return ptr;
+
+	default:
+	    do
+	    {
+		*--ptr  = '0' + (value & 7);
+		value >>= 3;
+	    }
+	    while (value);
+	    return ptr;
+    }
+}
+
+int __vformat(FILE *stream, char *buffer, unsigned int size,
+	      const char *fmt, va_list args)
+{
+    char scratch[FMT_DIGITS], *end = scratch + sizeof(scratch);
+    const char *str, *prefix;
+    unsigned int written = 0, total = 0, limit = size ? size - 1 : 0;
+    int flags, width, precision, length, base, pad, zeroes;
+    int isSigned;
+    u64 value;
+
+/* Store a character. A full buffer first goes out to the stream, if any. */
+#define PUT(c) \
+    do { \
+	if (written == limit && stream && limit) \
+	{ \
+	    if (fwrite(buffer, 1, written, stream) != written) \
+		return -1; \
+	    total  += written; \
+	    written = 0; \
+	} \
+	if (written < limit) \
+	    buffer[written++] = (c); \
+    } while (0)
+
+/* Can we store another character? */
+#define ROOM() ((stream && limit) || written < limit)
+
     /* Loop formatted message. */
-    while ((ch = *fmt++) && written < size)
+    while (*fmt && ROOM())
     {
-	if (ch != '%')
+	if (*fmt != '%')
 	{
-	    *buffer++ = ch;
-	    written++;
+	    PUT(*fmt);
+	    fmt++;
+	    continue;
 	}
-	else
+	fmt++;
+	flags     = 0;
+	width     = 0;
+	precision = -1;
+	length    = 0;
+	isSigned  = 0;
+	base      = 10;
+	prefix    = "";
+
+	/* Flags. */
+	for (;; fmt++)
+	{
+	    if      (*fmt == '-') flags |= FMT_LEFT;
+	    else if (*fmt == '0') flags |= FMT_ZERO;
+	    else if (*fmt == '+') flags |= FMT_PLUS;
+	    else if (*fmt == ' ') flags |= FMT_SPACE;
+	    else if (*fmt == '#') flags |= FMT_ALT;
+	    else break;
+	}
+	/* Field width. */
+	if (*fmt == '*')
 	{
-	switch_again:
-	
-	    switch (*fmt)
+	    width = va_arg(args, int);
+	    fmt++;
+
+	    if (width < 0)
 	    {
-		/* Length modifier. */
-	        case '0' ... '9':
-	    
-		    for (i = 0; i < 19 && *fmt >= '0' && *fmt <= '9'; i++)
-		    {
-			buf[i]   = *fmt++;
-		        buf[i+1] = ZERO;
-		    }
-		    length = atoi(buf);
-		    goto switch_again;
-	
-		/* Integer. */    
-	        case 'd':
-	        case 'u':
-		    itoa(buf, 10, va_arg(args, int));
-		    ptr = buf;
-		    goto string;
-	
-		/* Long integer. */
-		case 'l':
-		    itoa(buf, 10, va_arg(args, long));
-		    ptr = buf;
-		    goto string;
-	
-		/* Hexadecimal. */
-	        case 'x':
-		    itoa(buf, 16, va_arg(args, int));
-		    ptr = buf;
-		    goto string;
-	
-		/* Character. */
-		case 'c':
-		    buf[0] = va_arg(args, int);
-		    buf[1] = ZERO;
-		    ptr    = buf;
-		    goto string;
-	
-		/* String. */
-		case 's':
-		    ptr = va_arg(args, char *);
-	
-		string:
-		    while( ((length == -1 && *ptr) ||
-			    (length > 0 && length--)) && written++ < size)
-		    {
-			if (*ptr)
-			{
-			    *buffer++ = *ptr++;
-			}
-			else
-			    *buffer++ = ' ';
-		    }
-		    break;
-	
-		/* Unsupported. */
-	        default:
-	    	    *buffer++ = ch;
-		    written++;
-		    break;
+		flags |= FMT_LEFT;
+		width  = -width;
 	    }
+	}
+	else
+	    while (*fmt >= '0' && *fmt <= '9')
+		width = (width * 10) + (*fmt++ - '0');
+
+	/* Precision. */
+	if (*fmt == '.')
+	{
 	    fmt++;
-	    length = -1;
+	    precision = 0;
+
+	    if (*fmt == '*')
+	    {
+		precision = va_arg(args, int);
+		fmt++;
+	    }
+	    else
+		while (*fmt >= '0' && *fmt <= '9')
+		    precision = (precision * 10) + (*fmt++ - '0');
+	}
+	/* Length modifier. Counts the number of 'l's; 2 means 64-bit. */
+	switch (*fmt)
+	{
+	    case 'h':
+		length = (fmt[1] == 'h') ? -2 : -1;
+		fmt   += (fmt[1] == 'h') ? 2 : 1;
+		break;
+
+	    case 'l':
+		length = (fmt[1] == 'l') ? 2 : 1;
+		fmt   += length;
+		break;
+
+	    case 'j':
+		length = 2;
+		fmt++;
+		break;
+
+	    case 'z':
+	    case 't':
+		length = sizeof(size_t) > sizeof(int) ? 2 : 1;
+		fmt++;
+		break;
 	}
+	switch (*fmt)
+	{
+	    /* Signed integer. */
+	    case 'd':
+	    case 'i':
+		isSigned = 1;
+		goto number;
+
+	    /* Unsigned integers. */
+	    case 'o':
+		base = 8;
+		goto number;
+
+	    case 'X':
+		flags |= FMT_UPPER;
+		/* Fall through. */
+
+	    case 'x':
+		base = 16;
+		goto number;
+
+	    case 'u':
+		goto number;
+
+	    /* Pointer. */
+	    case 'p':
+		value  = (unsigned long) va_arg(args, void *);
+		base   = 16;
+		flags |= FMT_ALT;
+		goto convert;
+
+	    /* Character. */
+	    case 'c':
+		scratch[0] = va_arg(args, int);
+		str        = scratch;
+		length     = 1;
+		goto string;
+
+	    /* String. */
+	    case 's':
+		str = va_arg(args, const char *);
+
+		if (!str)
+		    str = "(null)";
+
+		/* Never read past the precision. */
+		if (precision >= 0)
+		{
+		    const char *nul = (const char *) memchr(str, 0, precision);
+		    length = nul ? nul - str : precision;
+		}
+		else
+		    length = strlen(str);
+
+	    string:
+		pad = width > length ? width - length : 0;
+
+		if (!(flags & FMT_LEFT))
+		    for (; pad > 0; pad--)
+			PUT(' ');
+
+		while (length-- > 0 && ROOM())
+		{
+		    PUT(*str);
+		    str++;
+		}
+
+		for (; pad > 0; pad--)
+		    PUT(' ');
+		break;
+
+	    /* Literal percent sign. */
+	    case '%':
+		PUT('%');
+		break;
+
+	    /* Unsupported: echo the conversion character. */
+	    default:
+		if (*fmt)
+		    PUT(*fmt);
+		else
+		    fmt--;
+		break;
+	}
+	fmt++;
+	continue;
+
+    number:
+	/* Fetch the argument according to its length modifier. */
+	if (length == 2)
+	    value = va_arg(args, u64);
+	else if (length == 1)
+	    value = isSigned ? (u64) va_arg(args, long)
+			     : (u64) va_arg(args, unsigned long);
+	else
+	    value = isSigned ? (u64) va_arg(args, int)
+			     : (u64) va_arg(args, unsigned int);
+
+	/* Narrow char and short arguments. */
+	if (length == -1)
+	    value = isSigned ? (u64)(short) value : (u16) value;
+	else if (length == -2)
+	    value = isSigned ? (u64)(signed char) value : (u8) value;
+
+	/* Determine the sign. */
+	if (isSigned)
+	{
+	    if ((long long) value < 0)
+	    {
+		prefix = "-";
+		value  = -value;
+	    }
+	    else if (flags & FMT_PLUS)
+		prefix = "+";
+	    else if (flags & FMT_SPACE)
+		prefix = " ";
+	}
+
+    convert:
+	/* Precision zero with a zero value prints no digits. */
+	if (precision == 0 && value == 0)
+	    str = end;
+	else
+	    str = digits(end, value, base, flags);
+
+	length = end - str;
+
+	/* Alternate forms. */
+	if (flags & FMT_ALT)
+	{
+	    if (base == 16 && (value || *fmt == 'p'))
+		prefix = (flags & FMT_UPPER) ? "0X" : "0x";
+	    else if (base == 8 && (length == 0 || *str != '0') &&
+		     precision <= length)
+		precision = length + 1;
+	}
+	/* Leading zeroes from the precision, or from zero padding. */
+	zeroes = precision > length ? precision - length : 0;
+
+	if ((flags & FMT_ZERO) && !(flags & FMT_LEFT) && precision < 0)
+	{
+	    pad = width - length - (int) strlen(prefix);
+	    zeroes = pad > 0 ? pad : 0;
+	}
+	pad = width - length - zeroes - (int) strlen(prefix);
+
+	if (!(flags & FMT_LEFT))
+	    for (; pad > 0; pad--)
+		PUT(' ');
+
+	while (*prefix)
+	    PUT(*prefix++);
+
+	for (; zeroes > 0; zeroes--)
+	    PUT('0');
+
+	while (str < end && ROOM())
+	{
+	    PUT(*str);
+	    str++;
+	}
+
+	for (; pad > 0; pad--)
+	    PUT(' ');
+
+	fmt++;
     }
-    /* Null terminate. */
-    if (written < size)
-	*buffer = 0;
-    return (written);
+#undef PUT
+#undef ROOM
+
+    /* Write out the rest, or null terminate. */
+    if (stream)
+    {
+	if (written && fwrite(buffer, 1, written, stream) != written)
+	    return -1;
+    }
+    else if (size)
+	buffer[written] = ZERO;
+
+    return (total + written);
+}
+
+int vsnprintf(char *buffer, unsigned int size, const char *fmt, va_list args)
+{
+    return __vformat(NULL, buffer, size, fmt, args);
 }
@@ -19,11 +19,15 @@
 #include <ProcessMessage.h>
 #include <ProcessID.h>
 #include "stdlib.h"
+#include "stdio.h"
 
 void exit(int status)
 {
     ProcessMessage msg;
 
+    /* Write out buffered output. */
+    fflush(ZERO);
+
     /* Request immediate termination. */
     msg.action = ExitProcess;
     msg.number = status;
@@ -106,6 +106,15 @@ extern C void * memset(void *dest, int ch, size_t count);
  */
 extern C void * memcpy(void *dest, const void *src, size_t count);
 
+/**
+ * Find a byte in memory.
+ * @param s Memory to search.
+ * @param ch Byte to look for.
+ * @param count Number of bytes to search.
+ * @return Pointer to the first occurrence of ch, or NULL if not found.
+ */
+extern C void * memchr(const void *s, int ch, size_t count);
+
 /**
  * Calculate the length of a string.
  * @param str String to calculate length for.
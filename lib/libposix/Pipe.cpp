@@ -0,0 +1,335 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/ProcessCtl.h>
+#include <Arch/CPU.h>
+#include <ProcessID.h>
+#include <Error.h>
+#include <string.h>
+#include <stdio.h>
+#include "Pipe.h"
+#include "poll.h"
+
+/** Pipe rings mapped by this process. */
+static PipeMapping mappings[PIPE_MAX];
+
+/** Pipes created by this process, mixed into new secrets. */
+static u32 pipeCount = 0;
+
+/**
+ * Wake the thread waiting on the other end of a pipe, if any.
+ * @param waiter PipeRing::reader or PipeRing::writer.
+ */
+static void wakeWaiter(volatile ProcessID *waiter)
+{
+    ProcessID pid;
+
+    /* Order our ring update before looking for a waiter. */
+    __sync_synchronize();
+
+    if (*waiter != ANY && (pid = __sync_lock_test_and_set(waiter, ANY)) != ANY)
+    {
+	ProcessCtl(pid, Wakeup);
+    }
+}
+
+/**
+ * Find an entry in the mappings table for a new ring.
+ * Rings of other processes, closed everywhere, may be forgotten.
+ * @param self ProcessID of this process.
+ * @return Pointer to the entry, or ZERO if all are in use.
+ */
+static PipeMapping * pipeUnused(ProcessID self)
+{
+    PipeMapping *m;
+
+    for (Size i = 0; i < PIPE_MAX; i++)
+    {
+	m = &mappings[i];
+
+	if (!m->ring)
+	    return m;
+
+	if (m->creator != self && !m->ring->get()->ends)
+	{
+	    delete m->ring;
+	    m->ring = ZERO;
+	    return m;
+	}
+    }
+    return ZERO;
+}
+
+/**
+ * Map the ring of a pipe.
+ * @param m Entry in the mappings table.
+ * @param creator ProcessID of the creator.
+ * @param secret Secret of the pipe key.
+ * @return True if mapped, false otherwise.
+ */
+static bool pipeMap(PipeMapping *m, ProcessID creator, u32 secret)
+{
+    char key[64];
+
+    snprintf(key, sizeof(key), "%s%u/%x", PIPE_KEY, creator, secret);
+
+    m->creator = creator;
+    m->secret  = secret;
+    m->ring    = new Shared<PipeRing>();
+
+    if (!m->ring->load(key, 1))
+    {
+	delete m->ring;
+	m->ring = ZERO;
+	return false;
+    }
+    return true;
+}
+
+PipeRing * pipeLookup(FileDescriptor *fd)
+{
+    ProcessID creator = fd->position;
+    u32 secret = PIPE_SECRET(fd->identifier);
+    PipeMapping *m;
+
+    for (Size i = 0; i < PIPE_MAX; i++)
+    {
+	m = &mappings[i];
+
+	if (m->ring && m->creator == creator && m->secret == secret)
+	{
+	    return m->ring->get();
+	}
+    }
+    /* Map it now. A ring without open ends does not exist. */
+    if (!(m = pipeUnused(ProcessCtl(SELF, GetPID))) ||
+        !pipeMap(m, creator, secret))
+    {
+	return ZERO;
+    }
+    return m->ring->get()->ends ? m->ring->get() : ZERO;
+}
+
+Error pipeCreate(u32 *secret)
+{
+    ProcessID self = ProcessCtl(SELF, GetPID);
+    PipeMapping *m = ZERO;
+    PipeRing *ring;
+
+    /* Reuse a ring we created before, once closed everywhere. */
+    for (Size i = 0; i < PIPE_MAX && !m; i++)
+    {
+	if (mappings[i].ring && mappings[i].creator == self &&
+	    __sync_bool_compare_and_swap(&mappings[i].ring->get()->ends, 0,
+					 PIPE_READER | PIPE_WRITER))
+	{
+	    m = &mappings[i];
+	}
+    }
+    /* Otherwise create a new ring, under a new secret. */
+    if (!m)
+    {
+	if (!(m = pipeUnused(self)))
+	{
+	    return EMFILE;
+	}
+	pipeCount++;
+	*secret = ((u32) timestamp() ^ (self << 20) ^ (pipeCount * 0x9e3779b9))
+		  & PIPE_SECRET_MASK;
+
+	if (!pipeMap(m, self, *secret))
+	{
+	    return ENFILE;
+	}
+	m->ring->get()->ends = PIPE_READER | PIPE_WRITER;
+    }
+    ring = m->ring->get();
+    ring->head   = 0;
+    ring->tail   = 0;
+    ring->reader = ANY;
+    ring->writer = ANY;
+    *secret = m->secret;
+    return ESUCCESS;
+}
+
+void pipeRetain(FileDescriptor *fd)
+{
+    PipeRing *ring = pipeLookup(fd);
+
+    if (ring)
+    {
+	__sync_add_and_fetch(&ring->ends, PIPE_IS_WRITER(fd->identifier) ?
+					  PIPE_WRITER : PIPE_READER);
+    }
+}
+
+void pipeRelease(FileDescriptor *fd)
+{
+    PipeRing *ring = pipeLookup(fd);
+
+    if (ring)
+    {
+	__sync_sub_and_fetch(&ring->ends, PIPE_IS_WRITER(fd->identifier) ?
+					  PIPE_WRITER : PIPE_READER);
+
+	/* Let the other end see end-of-file or a broken pipe. */
+	wakeWaiter(&ring->reader);
+	wakeWaiter(&ring->writer);
+    }
+}
+
+ssize_t pipeRead(FileDescriptor *fd, void *buf, size_t nbyte)
+{
+    PipeRing *ring = pipeLookup(fd);
+    u8 *dst = (u8 *) buf;
+    Size count, offset, chunk;
+    u32 head;
+
+    if (!ring || PIPE_IS_WRITER(fd->identifier))
+    {
+	return EBADF;
+    }
+    /* Sleep while empty, unless no writer remains to fill it. */
+    while ((head = ring->head) == ring->tail)
+    {
+	if (ring->ends < PIPE_WRITER)
+	{
+	    return 0;
+	}
+	ring->reader = ProcessCtl(SELF, GetPID);
+	__sync_synchronize();
+
+	/* The writer may have filled it before seeing us. */
+	if (ring->head == ring->tail && ring->ends >= PIPE_WRITER)
+	{
+	    ProcessCtl(SELF, Sleep, PIPE_POLL);
+	}
+	ring->reader = ANY;
+    }
+    count  = head - ring->tail;
+    count  = count < nbyte ? count : nbyte;
+    offset = ring->tail & (PIPE_SIZE - 1);
+    chunk  = count < PIPE_SIZE - offset ? count : PIPE_SIZE - offset;
+
+    /* Copy out, wrapping around the end of the ring. */
+    memcpy(dst, ring->data + offset, chunk);
+    memcpy(dst + chunk, ring->data, count - chunk);
+
+    /* Hand the space back to the writer. */
+    __sync_synchronize();
+    ring->tail += count;
+    wakeWaiter(&ring->writer);
+    return count;
+}
+
+ssize_t pipeWrite(FileDescriptor *fd, const void *buf, size_t nbyte)
+{
+    PipeRing *ring = pipeLookup(fd);
+    const u8 *src = (const u8 *) buf;
+    Size done = 0, count, offset, chunk;
+    u32 head;
+
+    if (!ring || !PIPE_IS_WRITER(fd->identifier))
+    {
+	return EBADF;
+    }
+    while (done < nbyte)
+    {
+	if (!(ring->ends & (PIPE_WRITER - 1)))
+	{
+	    return done ? (ssize_t) done : EPIPE;
+	}
+	head  = ring->head;
+	count = PIPE_SIZE - (head - ring->tail);
+
+	/* Sleep while full, unless no reader remains to drain it. */
+	if (!count)
+	{
+	    ring->writer = ProcessCtl(SELF, GetPID);
+	    __sync_synchronize();
+
+	    /* The reader may have drained it before seeing us. */
+	    if (ring->head - ring->tail == PIPE_SIZE &&
+	        ring->ends & (PIPE_WRITER - 1))
+	    {
+		ProcessCtl(SELF, Sleep, PIPE_POLL);
+	    }
+	    ring->writer = ANY;
+	    continue;
+	}
+	count  = count < nbyte - done ? count : nbyte - done;
+	offset = head & (PIPE_SIZE - 1);
+	chunk  = count < PIPE_SIZE - offset ? count : PIPE_SIZE - offset;
+
+	/* Copy in, wrapping around the end of the ring. */
+	memcpy(ring->data + offset, src + done, chunk);
+	memcpy(ring->data, src + done + chunk, count - chunk);
+
+	/* Publish the bytes to the reader. */
+	__sync_synchronize();
+	ring->head = head + count;
+	done += count;
+	wakeWaiter(&ring->reader);
+    }
+    return done;
+}
+
+/**
+ * Check which events are ready on a pipe end.
+ * @param ring Shared ring of the pipe.
+ * @param writer True for the write end.
+ * @return Ready events.
+ */
+static short pipeReady(PipeRing *ring, bool writer)
+{
+    if (writer)
+    {
+	if (!(ring->ends & (PIPE_WRITER - 1)))
+	    return POLLERR;
+	else
+	    return ring->head - ring->tail < PIPE_SIZE ? POLLOUT : 0;
+    }
+    else if (ring->head != ring->tail)
+	return POLLIN;
+    else
+	return ring->ends < PIPE_WRITER ? POLLHUP : 0;
+}
+
+short pipePoll(FileDescriptor *fd, short events)
+{
+    PipeRing *ring = pipeLookup(fd);
+    bool writer = PIPE_IS_WRITER(fd->identifier);
+    short ready;
+
+    if (!ring)
+    {
+	return POLLNVAL;
+    }
+    /* Ask the other end to wake us, then look again in case it just did. */
+    if (!(ready = pipeReady(ring, writer)) &&
+        (events & (writer ? POLLOUT : POLLIN)))
+    {
+	if (writer)
+	    ring->writer = ProcessCtl(SELF, GetPID);
+	else
+	    ring->reader = ProcessCtl(SELF, GetPID);
+
+	__sync_synchronize();
+	ready = pipeReady(ring, writer);
+    }
+    return ready & (events | POLLHUP | POLLERR);
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBPOSIX_PIPE_H
+#define __LIBPOSIX_PIPE_H
+
+#include <FileDescriptor.h>
+#include <Shared.h>
+#include <Macros.h>
+#include <Types.h>
+#include "sys/types.h"
+
+/**
+ * @defgroup libposix libposix (POSIX.1-2008)
+ * @{
+ */
+
+/** Key prefix of a pipe ring, followed by its creator and secret. */
+#define PIPE_KEY	"Pipe/"
+
+/**
+ * Maximum number of pipes mapped by one process.
+ * The process server maps every pipe end which is inherited.
+ */
+#define PIPE_MAX	64
+
+/** Bytes buffered by a pipe. Must be a power of two. */
+#define PIPE_SIZE	4096
+
+/** Longest sleep of a blocked end before it checks the ring again. */
+#define PIPE_POLL	100000
+
+/** Open end counted in PipeRing::ends for a reader. */
+#define PIPE_READER	1
+
+/** Open end counted in PipeRing::ends for a writer. */
+#define PIPE_WRITER	0x10000
+
+/** Bits of the secret in a pipe key. */
+#define PIPE_SECRET_MASK	0x7fffffff
+
+/**
+ * FileDescriptor::identifier of an end of the given pipe.
+ * FileDescriptor::position holds the ProcessID of its creator.
+ */
+#define PIPE_IDENT(secret,writer) (((secret) << 1) | ((writer) ? 1 : 0))
+
+/** Secret of the pipe in a FileDescriptor::identifier. */
+#define PIPE_SECRET(ident)	((ident) >> 1)
+
+/** True if the FileDescriptor::identifier is the write end. */
+#define PIPE_IS_WRITER(ident)	((ident) & 1)
+
+/**
+ * Single producer, single consumer ring buffer shared by both ends.
+ *
+ * The writer only advances head and the reader only advances tail, so
+ * data moves without locks or IPC. An end sleeps only when it finds the
+ * ring empty (reader) or full (writer), after publishing its thread in
+ * reader or writer; the other end then wakes it once it made progress.
+ */
+typedef struct PipeRing
+{
+    /** Total bytes written, modulo 2^32. */
+    volatile u32 head;
+
+    /** Total bytes read, modulo 2^32. */
+    volatile u32 tail;
+
+    /** Open ends in units of PIPE_READER and PIPE_WRITER. Zero if free. */
+    volatile u32 ends;
+
+    /** Thread sleeping until the ring is not empty, or ANY. */
+    volatile ProcessID reader;
+
+    /** Thread sleeping until the ring is not full, or ANY. */
+    volatile ProcessID writer;
+
+    /** Buffered bytes, at head and tail modulo PIPE_SIZE. */
+    u8 data[PIPE_SIZE];
+}
+PipeRing;
+
+/**
+ * Pipe ring mapped into this process.
+ *
+ * Every ring has its own shared memory key, which includes a secret.
+ * Only processes given a FileDescriptor of the pipe know the key.
+ */
+typedef struct PipeMapping
+{
+    /** Process which created the pipe. */
+    ProcessID creator;
+
+    /** Secret part of the key. */
+    u32 secret;
+
+    /** Shared ring, or ZERO if the entry is unused. */
+    Shared<PipeRing> *ring;
+}
+PipeMapping;
+
+/**
+ * Retrieve the ring of a pipe end, mapping it on first use.
+ * @param fd FileDescriptor of the pipe end.
+ * @return Pointer to the ring, or ZERO if the pipe does not exist.
+ */
+PipeRing * pipeLookup(FileDescriptor *fd);
+
+/**
+ * Allocate a pipe with one reader and one writer.
+ * A free ring created earlier by this process is reused first.
+ * @param secret Receives the secret of the pipe key.
+ * @return ESUCCESS, EMFILE if this process maps too many pipes,
+ *         or ENFILE if no ring could be created.
+ */
+Error pipeCreate(u32 *secret);
+
+/**
+ * Count an extra reference to a pipe end, such as an inherited copy.
+ * @param fd FileDescriptor of the pipe end.
+ */
+void pipeRetain(FileDescriptor *fd);
+
+/**
+ * Drop a reference to a pipe end, and wake the other end.
+ * The pipe is free once both ends are released.
+ * @param fd FileDescriptor of the pipe end.
+ */
+void pipeRelease(FileDescriptor *fd);
+
+/**
+ * Read from a pipe. Waits until at least one byte is buffered.
+ * @param fd FileDescriptor of the read end.
+ * @param buf Output buffer.
+ * @param nbyte Maximum number of bytes to read.
+ * @return Bytes read, zero if no writer remains, or an error code.
+ */
+ssize_t pipeRead(FileDescriptor *fd, void *buf, size_t nbyte);
+
+/**
+ * Write to a pipe. Waits until all bytes are buffered.
+ * @param fd FileDescriptor of the write end.
+ * @param buf Input buffer.
+ * @param nbyte Number of bytes to write.
+ * @return Bytes written, or an error code if no reader remains.
+ */
+ssize_t pipeWrite(FileDescriptor *fd, const void *buf, size_t nbyte);
+
+/**
+ * Check which poll() events are ready on a pipe end. If none, the other
+ * end wakes us with ProcessCtl once that may have changed.
+ * @param fd FileDescriptor of the pipe end.
+ * @param events Events of interest.
+ * @return Ready events, including POLLHUP or POLLERR once the other
+ *         end is closed.
+ */
+short pipePoll(FileDescriptor *fd, short events);
+
+/**
+ * @}
+ */
+
+#endif /* __LIBPOSIX_PIPE_H */
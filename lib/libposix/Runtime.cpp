@@ -32,6 +32,9 @@ Shared<FileSystemMount> mounts;
 Shared<FileDescriptor> files;
 Shared<UserProcess> procs;
 
+/** Stacks of threads started by pthread_create(). */
+u8 *threadStacks[MAX_PROCS];
+
 /** List of constructors. */
 extern void (*CTOR_LIST)();
 
@@ -80,7 +83,7 @@ void setupHeap()
     Size parentSize;
 
     /* Only the memory server allocates directly. */
-    if (ProcessCtl(SELF, GetPID) == MEMSRV_PID)
+    if (getpid() == MEMSRV_PID)
     {
         VMCtlAllocator alloc(PAGESIZE * 4);
 
@@ -188,6 +191,31 @@ Shared<FileDescriptor> * getFiles()
     return &files;
 }
 
+int insertFile(ProcessID mount, Address ident)
+{
+    FileDescriptor *fd;
+
+    for (Size i = 0; i < FILE_DESCRIPTOR_MAX; i++)
+    {
+        fd = files[i];
+
+        /* Claim the entry, if the mount field is ZERO. */
+        if (__sync_bool_compare_and_swap(&fd->mount, 0, mount))
+        {
+            fd->identifier = ident;
+            fd->position   = ZERO;
+            fd->flags      = ZERO;
+            return i;
+        }
+    }
+    return -1;
+}
+
+u8 ** getThreadStacks()
+{
+    return threadStacks;
+}
+
 extern C void SECTION(".entry") _entry() 
 {
     int ret, argc;
@@ -69,6 +69,20 @@ Shared<UserProcess> * getProcesses();
  */
 Shared<FileDescriptor> * getFiles();
 
+/**
+ * Fill the lowest free entry of our FileDescriptor table.
+ * @param mount ProcessID of the filesystem server, or FILE_DESCRIPTOR_PIPE.
+ * @param ident Unique identifier.
+ * @return FileDescriptor number, or -1 if the table is full.
+ */
+int insertFile(ProcessID mount, Address ident);
+
+/**
+ * Retrieve the stacks allocated by pthread_create().
+ * @return Stack pointers, indexed by thread ID.
+ */
+u8 ** getThreadStacks();
+
 /**
  * @}
  */
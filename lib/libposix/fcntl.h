@@ -89,6 +89,15 @@
 /** Open for writing only. */
 #define O_WRONLY	(1 << 14)
 
+/** Get the file descriptor flags. */
+#define F_GETFD		1
+
+/** Set the file descriptor flags. */
+#define F_SETFD		2
+
+/** Close the file descriptor upon execution of a new program. */
+#define FD_CLOEXEC	(1 << 0)
+
 /**
  * @}
  */
@@ -105,6 +114,16 @@
  */
 extern C int open(const char *path, int oflag, ...);
 
+/**
+ * File control.
+ * @param fildes File descriptor.
+ * @param cmd F_GETFD to retrieve the file descriptor flags, or F_SETFD
+ *            to set them to the third argument. Only FD_CLOEXEC exists.
+ * @return The flags for F_GETFD, zero for F_SETFD. Otherwise, -1 shall be
+ *         returned and errno set to indicate the error.
+ */
+extern C int fcntl(int fildes, int cmd, ...);
+
 /**
  * @}
  */
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FileDescriptor.h>
+#include "Runtime.h"
+#include <errno.h>
+#include <stdarg.h>
+#include "fcntl.h"
+
+int fcntl(int fildes, int cmd, ...)
+{
+    FileDescriptor *fd = getFiles()->get(fildes);
+    va_list args;
+    int arg;
+
+    if (!fd || !fd->mount)
+    {
+	errno = EBADF;
+	return -1;
+    }
+    switch (cmd)
+    {
+	case F_GETFD:
+	    return fd->flags & FILE_DESCRIPTOR_CLOEXEC ? FD_CLOEXEC : 0;
+
+	case F_SETFD:
+	    va_start(args, cmd);
+	    arg = va_arg(args, int);
+	    va_end(args);
+
+	    if (arg & FD_CLOEXEC)
+		fd->flags |= FILE_DESCRIPTOR_CLOEXEC;
+	    else
+		fd->flags &= ~FILE_DESCRIPTOR_CLOEXEC;
+	    return 0;
+
+	default:
+	    errno = EINVAL;
+	    return -1;
+    }
+}
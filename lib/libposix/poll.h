@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBPOSIX_POLL_H
+#define __LIBPOSIX_POLL_H
+
+#include <Macros.h>
+#include "sys/types.h"
+
+/**
+ * @defgroup libposix libposix (POSIX.1-2008)
+ * @{
+ */
+
+/**
+ * @brief Constants
+ * @{
+ */
+
+/** Data other than high-priority data may be read without blocking. */
+#define POLLIN		(1 << 0)
+
+/** High priority data may be read without blocking. */
+#define POLLPRI		(1 << 1)
+
+/** Normal data may be written without blocking. */
+#define POLLOUT		(1 << 2)
+
+/** An error has occurred (revents only). */
+#define POLLERR		(1 << 3)
+
+/** Device has been disconnected (revents only). */
+#define POLLHUP		(1 << 4)
+
+/** Invalid fd member (revents only). */
+#define POLLNVAL	(1 << 5)
+
+/**
+ * @}
+ */
+
+/** Number of entries in the fds argument of poll(). */
+typedef unsigned int nfds_t;
+
+/**
+ * File descriptor to poll, and the events of interest.
+ */
+struct pollfd
+{
+    /** The following descriptor being polled. */
+    int fd;
+
+    /** The input event flags. */
+    short events;
+
+    /** The output event flags. */
+    short revents;
+};
+
+/**
+ * @brief Input/output multiplexing.
+ *
+ * The poll() function provides applications with a mechanism for
+ * multiplexing input/output over a set of file descriptors. For each
+ * member of the array pointed to by fds, poll() shall examine the given
+ * file descriptor for the event(s) specified in events. A negative fd
+ * is ignored.
+ *
+ * Servers of the files remember the caller while nothing is ready, and
+ * wake it once something may be: the caller sleeps in the kernel without
+ * retrying in between.
+ *
+ * @param fds File descriptors to examine.
+ * @param nfds Number of entries in fds.
+ * @param timeout Milliseconds to wait, zero to return immediately,
+ *                or -1 to wait until an event occurs.
+ * @return Number of entries with non-zero revents, zero on timeout.
+ *         Otherwise, -1 shall be returned and errno set to indicate
+ *         the error.
+ */
+extern C int poll(struct pollfd fds[], nfds_t nfds, int timeout);
+
+/**
+ * @}
+ */
+
+#endif /* __LIBPOSIX_POLL_H */
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/IPCMessage.h>
+#include <API/ProcessCtl.h>
+#include <FileSystemMessage.h>
+#include <ProcessID.h>
+#include "Runtime.h"
+#include "Pipe.h"
+#include <errno.h>
+#include <time.h>
+#include "poll.h"
+
+/** Longest single sleep of poll(), in milliseconds. */
+#define POLL_SLEEP_MAX 1000000
+
+/**
+ * Milliseconds since boot.
+ */
+static u64 milliseconds()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((u64) ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+/**
+ * Check which events are ready on a file descriptor.
+ * @param pfd File descriptor and events of interest.
+ * @return Ready events.
+ */
+static short pollFile(struct pollfd *pfd)
+{
+    FileDescriptor *fd = getFiles()->get(pfd->fd);
+    FileSystemMessage msg;
+
+    if (!fd || !fd->mount)
+    {
+	return POLLNVAL;
+    }
+    /* Pipes are checked directly on the ring. */
+    if (fd->mount == FILE_DESCRIPTOR_PIPE)
+    {
+	return pipePoll(fd, pfd->events);
+    }
+    /* Otherwise, the server knows. Older ones reply unmodified: ready. */
+    msg.action = PollFile;
+    msg.fd     = pfd->fd;
+    msg.size   = pfd->events;
+    msg.result = pfd->events & (POLLIN | POLLOUT);
+    IPCMessage(fd->mount, SendReceive, &msg, sizeof(msg));
+
+    return msg.result >= 0 ? (short) msg.result : POLLERR;
+}
+
+int poll(struct pollfd fds[], nfds_t nfds, int timeout)
+{
+    u64 deadline = timeout > 0 ? milliseconds() + timeout : 0, now;
+    Size usec;
+    int ready;
+
+    while (true)
+    {
+	ready = 0;
+
+	/* Collect the ready events. Servers remember us if none. */
+	for (nfds_t i = 0; i < nfds; i++)
+	{
+	    fds[i].revents = fds[i].fd >= 0 ? pollFile(&fds[i]) : 0;
+
+	    if (fds[i].revents)
+	    {
+		ready++;
+	    }
+	}
+	if (ready || !timeout)
+	{
+	    return ready;
+	}
+	/* Sleep until a server or pipe end wakes us, or the timeout. */
+	if (timeout < 0)
+	    usec = 0;
+	else if ((now = milliseconds()) >= deadline)
+	    return 0;
+	else
+	    usec = (deadline - now < POLL_SLEEP_MAX ?
+		    deadline - now : POLL_SLEEP_MAX) * 1000;
+
+	ProcessCtl(SELF, Sleep, usec);
+    }
+}
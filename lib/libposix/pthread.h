@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBPOSIX_PTHREAD_H
+#define __LIBPOSIX_PTHREAD_H
+
+#include <Macros.h>
+#include "sys/types.h"
+
+/**
+ * @defgroup libposix libposix (POSIX.1-2008)
+ * @{
+ */
+
+/** Size of the stack of a new thread, in bytes. */
+#define PTHREAD_STACK_SIZE (1024 * 64)
+
+/** Initializes a mutex with default attributes. */
+#define PTHREAD_MUTEX_INITIALIZER { 0 }
+
+/**
+ * Thread creation.
+ *
+ * The pthread_create() function shall create a new thread, with
+ * attributes specified by attr, within a process. The thread is created
+ * executing start_routine with arg as its sole argument.
+ *
+ * @param thread Receives the ID of the new thread.
+ * @param attr Thread attributes. Must be ZERO: attributes are not supported.
+ * @param start_routine Function executed by the new thread.
+ * @param arg Argument passed to start_routine.
+ * @return Zero on success, or an error number on failure.
+ */
+extern C int pthread_create(pthread_t *thread, const pthread_attr_t *attr,
+			    void *(*start_routine)(void *), void *arg);
+
+/**
+ * Thread termination.
+ *
+ * The pthread_exit() function shall terminate the calling thread and make
+ * the value value_ptr available to any successful join with the
+ * terminating thread. Called from the initial thread, it terminates the
+ * whole process.
+ *
+ * @param value_ptr Exit value of the thread.
+ */
+extern C void pthread_exit(void *value_ptr);
+
+/**
+ * Wait for thread termination.
+ *
+ * The pthread_join() function shall suspend execution of the calling
+ * thread until the target thread terminates, unless the target thread has
+ * already terminated.
+ *
+ * @param thread Thread to wait for.
+ * @param value_ptr If not a null pointer, receives the exit value.
+ * @return Zero on success, or an error number on failure.
+ */
+extern C int pthread_join(pthread_t thread, void **value_ptr);
+
+/**
+ * Get the calling thread ID.
+ *
+ * @return Thread ID of the calling thread.
+ */
+extern C pthread_t pthread_self(void);
+
+/**
+ * Initialize a mutex.
+ *
+ * @param mutex Mutex to initialize.
+ * @param attr Mutex attributes. Ignored: only the default type is supported.
+ * @return Zero on success, or an error number on failure.
+ */
+extern C int pthread_mutex_init(pthread_mutex_t *mutex,
+				const pthread_mutexattr_t *attr);
+
+/**
+ * Destroy a mutex.
+ *
+ * @param mutex Mutex to destroy.
+ * @return Zero on success, or EBUSY if the mutex is locked.
+ */
+extern C int pthread_mutex_destroy(pthread_mutex_t *mutex);
+
+/**
+ * Lock a mutex.
+ *
+ * If the mutex is already locked, the calling thread shall block until
+ * the mutex becomes available. Waiting threads give up the CPU.
+ *
+ * @param mutex Mutex to lock.
+ * @return Zero on success, or an error number on failure.
+ */
+extern C int pthread_mutex_lock(pthread_mutex_t *mutex);
+
+/**
+ * Try to lock a mutex.
+ *
+ * @param mutex Mutex to lock.
+ * @return Zero on success, or EBUSY if the mutex is already locked.
+ */
+extern C int pthread_mutex_trylock(pthread_mutex_t *mutex);
+
+/**
+ * Unlock a mutex.
+ *
+ * @param mutex Mutex to unlock.
+ * @return Zero on success, or an error number on failure.
+ */
+extern C int pthread_mutex_unlock(pthread_mutex_t *mutex);
+
+/**
+ * @}
+ */
+
+#endif /* __LIBPOSIX_PTHREAD_H */
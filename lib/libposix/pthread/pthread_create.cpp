@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/ThreadCtl.h>
+#include <LockedAllocator.h>
+#include <ProcessID.h>
+#include <Types.h>
+#include <errno.h>
+#include "Runtime.h"
+#include "pthread.h"
+
+/** Set once the heap is shared by threads. */
+static bool heapLocked = false;
+
+/**
+ * First function executed by a new thread.
+ * @param start_routine Function to execute.
+ * @param arg Argument for start_routine.
+ */
+static void pthreadStart(void *(*start_routine)(void *), void *arg)
+{
+    pthread_exit(start_routine(arg));
+}
+
+int pthread_create(pthread_t *thread, const pthread_attr_t *attr,
+		   void *(*start_routine)(void *), void *arg)
+{
+    u8 *stack;
+    Address *sp;
+    Error id;
+
+    /* Serialize the heap before a second thread can use it. */
+    if (!heapLocked)
+    {
+	Allocator::setDefault(new LockedAllocator(Allocator::getDefault()));
+	heapLocked = true;
+    }
+    stack = new u8[PTHREAD_STACK_SIZE];
+    sp    = (Address *) (stack + PTHREAD_STACK_SIZE);
+
+    /* Arguments for pthreadStart(), below an unused return address. */
+    *(--sp) = (Address) arg;
+    *(--sp) = (Address) start_routine;
+    *(--sp) = ZERO;
+
+    /* Ask the kernel for a new thread. */
+    if ((id = ThreadCtl(SELF, CreateThread, (Address) pthreadStart,
+			(Address) sp)) < 0)
+    {
+	delete[] stack;
+	return EAGAIN;
+    }
+    /* Remember the stack for pthread_join(). */
+    getThreadStacks()[id] = stack;
+    *thread = id;
+    return 0;
+}
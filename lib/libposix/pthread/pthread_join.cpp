@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/ThreadCtl.h>
+#include <Types.h>
+#include "Runtime.h"
+#include "pthread.h"
+
+int pthread_join(pthread_t thread, void **value_ptr)
+{
+    Error result;
+
+    /* Wait for the thread to exit. */
+    if ((result = ThreadCtl(thread, JoinThread, (Address) value_ptr)) < 0)
+    {
+	return result;
+    }
+    /* Release its stack. */
+    if (thread < MAX_PROCS)
+    {
+	delete[] getThreadStacks()[thread];
+	getThreadStacks()[thread] = ZERO;
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LIBPOSIX_SELECT_H
+#define __LIBPOSIX_SELECT_H
+
+#include <Macros.h>
+#include <string.h>
+#include "types.h"
+
+/**
+ * @defgroup libposix libposix (POSIX.1-2008)
+ * @{
+ */
+
+/** Maximum number of file descriptors in an fd_set. */
+#define FD_SETSIZE	1024
+
+/** Bits in one word of an fd_set. */
+#define FD_BITS		(sizeof(ulong) * 8)
+
+/**
+ * Set of file descriptors.
+ */
+typedef struct fd_set
+{
+    /** One bit per file descriptor. */
+    ulong bits[FD_SETSIZE / FD_BITS];
+}
+fd_set;
+
+/**
+ * Time interval.
+ */
+struct timeval
+{
+    /** Seconds. */
+    time_t tv_sec;
+
+    /** Microseconds. */
+    suseconds_t tv_usec;
+};
+
+/** Clear the bit for the file descriptor fd in the file descriptor set. */
+#define FD_CLR(fd, set)	  ((set)->bits[(fd) / FD_BITS] &= ~(1UL << ((fd) % FD_BITS)))
+
+/** Return non-zero if the bit for fd is set in the file descriptor set. */
+#define FD_ISSET(fd, set) ((set)->bits[(fd) / FD_BITS] & (1UL << ((fd) % FD_BITS)))
+
+/** Set the bit for the file descriptor fd in the file descriptor set. */
+#define FD_SET(fd, set)	  ((set)->bits[(fd) / FD_BITS] |= (1UL << ((fd) % FD_BITS)))
+
+/** Initialize the descriptor set to the null set. */
+#define FD_ZERO(set)	  memset((set), 0, sizeof(fd_set))
+
+/**
+ * @brief Synchronous I/O multiplexing.
+ *
+ * The select() function shall examine the file descriptor sets whose
+ * addresses are passed in the readfds, writefds, and errorfds parameters
+ * to see whether some of their descriptors are ready for reading, are
+ * ready for writing, or have an exceptional condition pending. It is
+ * implemented with poll().
+ *
+ * @param nfds Examine descriptors 0 through nfds-1 in each set.
+ * @param readfds On return, the descriptors ready for reading.
+ * @param writefds On return, the descriptors ready for writing.
+ * @param errorfds On return, the descriptors with an error pending.
+ * @param timeout Time to wait, or a null pointer to wait forever.
+ * @return Total number of bits set in the sets on success. Otherwise,
+ *         -1 shall be returned and errno set to indicate the error.
+ */
+extern C int select(int nfds, fd_set *readfds, fd_set *writefds,
+		    fd_set *errorfds, struct timeval *timeout);
+
+/**
+ * @}
+ */
+
+#endif /* __LIBPOSIX_SELECT_H */
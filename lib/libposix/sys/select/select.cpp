@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include "poll.h"
+#include "sys/select.h"
+
+int select(int nfds, fd_set *readfds, fd_set *writefds,
+	   fd_set *errorfds, struct timeval *timeout)
+{
+    struct pollfd *fds;
+    int count = 0, ready;
+
+    if (nfds < 0 || nfds > FD_SETSIZE)
+    {
+	errno = EINVAL;
+	return -1;
+    }
+    fds = new struct pollfd[nfds ? nfds : 1];
+
+    /* Translate the sets to poll() events. */
+    for (int i = 0; i < nfds; i++)
+    {
+	fds[i].fd      = -1;
+	fds[i].events  = 0;
+	fds[i].revents = 0;
+
+	if (readfds && FD_ISSET(i, readfds))
+	    fds[i].events |= POLLIN;
+
+	if (writefds && FD_ISSET(i, writefds))
+	    fds[i].events |= POLLOUT;
+
+	if (fds[i].events || (errorfds && FD_ISSET(i, errorfds)))
+	    fds[i].fd = i;
+    }
+    ready = poll(fds, nfds, timeout ? (timeout->tv_sec * 1000) +
+				      (timeout->tv_usec + 999) / 1000 : -1);
+
+    /* And the ready events back to the sets. */
+    for (int i = 0; i < nfds && ready >= 0; i++)
+    {
+	if (readfds && FD_ISSET(i, readfds) &&
+	  !(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+	    FD_CLR(i, readfds);
+
+	if (writefds && FD_ISSET(i, writefds) &&
+	  !(fds[i].revents & (POLLOUT | POLLERR)))
+	    FD_CLR(i, writefds);
+
+	if (errorfds && FD_ISSET(i, errorfds) &&
+	  !(fds[i].revents & (POLLERR | POLLNVAL)))
+	    FD_CLR(i, errorfds);
+
+	count += (readfds  && FD_ISSET(i, readfds)  ? 1 : 0) +
+		 (writefds && FD_ISSET(i, writefds) ? 1 : 0) +
+		 (errorfds && FD_ISSET(i, errorfds) ? 1 : 0);
+    }
+    delete[] fds;
+    return ready >= 0 ? count : -1;
+}
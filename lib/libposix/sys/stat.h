@@ -248,6 +248,18 @@ struct stat
  */
 extern C int stat(const char *path, struct stat *buf);
 
+/**
+ * Get file status of an open file.
+ * @param fildes File descriptor of the file.
+ * @param buf The buf argument is a pointer to a stat structure,
+ *            as defined in the <sys/stat.h> header, into which
+ *            information is placed concerning the file.
+ * @return Upon successful completion, 0 shall be returned.
+ *         Otherwise, -1 shall be returned and errno set to
+ *         indicate the error.
+ */
+extern C int fstat(int fildes, struct stat *buf);
+
 /**
  * Make directory, special file, or regular file
  * @param path The mknod() function shall create a new file
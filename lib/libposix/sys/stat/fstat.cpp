@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/IPCMessage.h>
+#include <FileSystemMessage.h>
+#include <ProcessID.h>
+#include "Runtime.h"
+#include <errno.h>
+#include "sys/stat.h"
+
+int fstat(int fildes, struct stat *buf)
+{
+    FileSystemMessage msg;
+    FileStat st;
+    ProcessID mnt = findMount(fildes);
+
+    /* Pipes are not known to any filesystem. */
+    if (mnt == FILE_DESCRIPTOR_PIPE)
+    {
+	st.type    = FIFOFile;
+	st.access  = OwnerRW;
+	st.size    = 0;
+	st.userID  = 0;
+	st.groupID = 0;
+	st.deviceID.major = 0;
+	st.deviceID.minor = 0;
+	buf->fromFileStat(&st);
+	return 0;
+    }
+    /* Fill message. */
+    msg.action = StatFileDescriptor;
+    msg.fd     = fildes;
+    msg.stat   = &st;
+    
+    /* Ask the FileSystem for the information. */
+    if (mnt)
+    {
+	IPCMessage(mnt, SendReceive, &msg, sizeof(msg));
+
+        /* Copy information into buf. */
+	if (msg.result == ESUCCESS)
+	{
+	    buf->fromFileStat(&st);
+	}
+	/* Set errno. */
+	errno = msg.result;
+    }
+    else
+	errno = msg.result = EBADF;
+    
+    /* Success. */
+    return msg.result == ESUCCESS ? 0 : -1;
+}
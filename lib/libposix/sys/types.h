@@ -65,6 +65,32 @@ typedef sint blksize_t;
 /** Used for time in seconds. */
 typedef ulong time_t;
 
+/** Used for time in microseconds. */
+typedef u32 useconds_t;
+
+/** Used for time in microseconds, possibly negative. */
+typedef slong suseconds_t;
+
+/** Used for clock ID type in the clock and timer functions. */
+typedef uint clockid_t;
+
+/** Used to identify a thread. */
+typedef ProcessID pthread_t;
+
+/** Used to identify a thread attribute object. */
+typedef uint pthread_attr_t;
+
+/** Used for mutexes. */
+typedef struct pthread_mutex
+{
+    /** Non-zero while held. */
+    volatile ulong locked;
+}
+pthread_mutex_t;
+
+/** Used to identify a mutex attribute object. */
+typedef uint pthread_mutexattr_t;
+
 /**
  * @}
  */
@@ -38,6 +38,58 @@ struct timespec
     long tv_nsec;
 };
 
+/**
+ * The identifier of the system-wide clock measuring real time.
+ */
+#define CLOCK_REALTIME  0
+
+/**
+ * The identifier for the system-wide monotonic clock, which is defined
+ * as a clock measuring real time, whose value cannot be set and cannot
+ * have negative clock jumps.
+ */
+#define CLOCK_MONOTONIC 1
+
+/**
+ * Get time.
+ *
+ * The time() function shall return the value of time in seconds
+ * since the Epoch.
+ *
+ * @param tloc If not a null pointer, the return value is also
+ *             stored in the object it points to.
+ * @return Value of time on success. Otherwise, (time_t)-1.
+ */
+extern C time_t time(time_t *tloc);
+
+/**
+ * Clock and timer functions.
+ *
+ * The clock_gettime() function shall return the current value tp
+ * for the specified clock, clock_id.
+ *
+ * @param clock_id Clock to read.
+ * @param tp Receives the current value of the clock.
+ * @return Return 0 on success, or -1 and set errno on failure.
+ */
+extern C int clock_gettime(clockid_t clock_id, struct timespec *tp);
+
+/**
+ * High resolution sleep.
+ *
+ * The nanosleep() function shall cause the current thread to be
+ * suspended from execution until the time interval specified by
+ * the rqtp argument has elapsed. The suspension time is rounded up
+ * to the resolution of the system timers.
+ *
+ * @param rqtp Time interval to sleep.
+ * @param rmtp If not a null pointer, receives the remaining time,
+ *             which is always zero: sleeps are not interrupted.
+ * @return 0 if the requested time has elapsed. Otherwise -1
+ *         and errno set to indicate the error.
+ */
+extern C int nanosleep(const struct timespec *rqtp, struct timespec *rmtp);
+
 extern unsigned long mktime(const unsigned int year, const unsigned int month,
                             const unsigned int day, const unsigned int hour,
                             const unsigned int min, const unsigned int sec);
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FreeNOS/InfoPage.h>
+#include <Arch/CPU.h>
+#include <errno.h>
+#include "time.h"
+
+int clock_gettime(clockid_t clock_id, struct timespec *tp)
+{
+    volatile ClockPage *clock = (volatile ClockPage *) CLOCK_PAGE_ADDR;
+    u32 sequence, seconds, nanoseconds, tickHz, extra;
+    u64 base, now, whole, hz;
+
+    /* Read a consistent snapshot of the system clock. */
+    do
+    {
+	sequence    = clock->sequence;
+	seconds     = clock->seconds;
+	nanoseconds = clock->nanoseconds;
+	base        = clock->tscBase;
+	hz          = clock->tscFrequency;
+	tickHz      = clock->tickHz;
+	now         = timestamp();
+    }
+    while ((sequence & 1) || sequence != clock->sequence);
+
+    /* Add the time since the last update, using the timestamp counter. */
+    if (hz && now > base)
+    {
+	now  -= base;
+	whole = udiv64(now, hz);
+	extra = udiv64((now - whole * hz) * 1000000000, hz);
+
+	/* A periodic clock moves by whole ticks: never pass the next one. */
+	if (tickHz && (whole || extra > 1000000000 / tickHz))
+	{
+	    whole = 0;
+	    extra = 1000000000 / tickHz;
+	}
+	seconds     += whole;
+	nanoseconds += extra;
+
+	if (nanoseconds >= 1000000000)
+	{
+	    nanoseconds -= 1000000000;
+	    seconds++;
+	}
+    }
+    switch (clock_id)
+    {
+	case CLOCK_REALTIME:
+	    seconds += clock->bootTime;
+	    break;
+
+	case CLOCK_MONOTONIC:
+	    break;
+
+	default:
+	    errno = EINVAL;
+	    return -1;
+    }
+    tp->tv_sec  = seconds;
+    tp->tv_nsec = nanoseconds;
+    return 0;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/TimerCtl.h>
+#include <Macros.h>
+#include <errno.h>
+#include "time.h"
+
+int nanosleep(const struct timespec *rqtp, struct timespec *rmtp)
+{
+    time_t seconds = rqtp->tv_sec;
+    Size usec;
+
+    if (rqtp->tv_nsec < 0 || rqtp->tv_nsec >= 1000000000)
+    {
+	errno = EINVAL;
+	return -1;
+    }
+    /* Sleep whole seconds in steps, to stay within 32-bit. */
+    while (seconds)
+    {
+	usec     = seconds < 1000 ? seconds : 1000;
+	seconds -= usec;
+	TimerCtl(0, SleepTimer, usec * 1000000);
+    }
+    TimerCtl(0, SleepTimer, CEIL(rqtp->tv_nsec, 1000));
+
+    if (rmtp)
+    {
+	rmtp->tv_sec  = 0;
+	rmtp->tv_nsec = 0;
+    }
+    return 0;
+}
@@ -15,6 +15,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "time.h"
+
 /**
  * Returns an unsigned long containing the timestamp of converted from
  * the given values. I copied this code from the linux source in
@@ -40,3 +42,18 @@ unsigned long mktime(const unsigned int year0, const unsigned int month0,
         )*60 + min /* now have minutes */
     )*60 + sec; /* finally seconds */
 }
+
+time_t time(time_t *tloc)
+{
+    struct timespec now;
+
+    if (clock_gettime(CLOCK_REALTIME, &now) != 0)
+    {
+        return (time_t) -1;
+    }
+    if (tloc)
+    {
+        *tloc = now.tv_sec;
+    }
+    return now.tv_sec;
+}
@@ -49,6 +49,15 @@
  */
 extern C pid_t getpid();
 
+/**
+ * Get the parent process ID.
+ * The getppid() function shall return the parent process ID of the
+ * calling process.
+ * @return The getppid() function shall always be successful and no
+ *         return value is reserved to indicate an error.
+ */
+extern C pid_t getppid();
+
 /**
  * Read from a file
  * @param fildes The read() function shall attempt to read nbyte bytes from the file
@@ -81,6 +90,36 @@ extern C ssize_t read(int fildes, void *buf, size_t nbyte);
  */
 extern C ssize_t write(int fildes, const void *buf, size_t nbyte);
 
+/**
+ * @brief Read from a file at a given offset.
+ *
+ * Like read(), but starts at offset and leaves the file offset
+ * unchanged. Safe to use on the same fildes from several threads.
+ *
+ * @param fildes File descriptor.
+ * @param buf Output buffer.
+ * @param nbyte Maximum number of bytes to read.
+ * @param offset Offset in the file to read from.
+ * @return Number of bytes read on success. Otherwise, -1 shall be
+ *         returned and errno set to indicate the error.
+ */
+extern C ssize_t pread(int fildes, void *buf, size_t nbyte, off_t offset);
+
+/**
+ * @brief Write on a file at a given offset.
+ *
+ * Like write(), but starts at offset and leaves the file offset
+ * unchanged. Safe to use on the same fildes from several threads.
+ *
+ * @param fildes File descriptor.
+ * @param buf Input buffer.
+ * @param nbyte Maximum number of bytes to write.
+ * @param offset Offset in the file to write to.
+ * @return Number of bytes written on success. Otherwise, -1 shall be
+ *         returned and errno set to indicate the error.
+ */
+extern C ssize_t pwrite(int fildes, const void *buf, size_t nbyte, off_t offset);
+
 /**
  * Close a file descriptor
  * @param fildes The close() function shall deallocate the file descriptor indicated by fildes.
@@ -110,6 +149,55 @@ extern C int close(int fildes);
  */
 extern C off_t lseek(int fildes, off_t offset, int whence);
 
+/**
+ * @brief Test for a terminal device.
+ *
+ * @param fildes File descriptor to test.
+ * @return 1 if fildes refers to a terminal; otherwise, 0 shall be
+ *         returned and errno set to indicate the error.
+ */
+extern C int isatty(int fildes);
+
+/**
+ * @brief Create an interprocess channel.
+ *
+ * The pipe() function shall create a pipe and place two file
+ * descriptors, one each into the arguments fildes[0] and fildes[1],
+ * that refer to the open file descriptions for the read and write ends
+ * of the pipe. Data written to fildes[1] appears on fildes[0].
+ *
+ * @param fildes Receives the read and write end.
+ * @return Upon successful completion, 0 shall be returned; otherwise, -1
+ *         shall be returned and errno set to indicate the error.
+ */
+extern C int pipe(int fildes[2]);
+
+/**
+ * @brief Duplicate an open file descriptor.
+ *
+ * The dup() function shall return the lowest numbered available file
+ * descriptor, referring to the same file as fildes.
+ *
+ * @param fildes File descriptor to duplicate.
+ * @return A new file descriptor on success; otherwise, -1 shall be
+ *         returned and errno set to indicate the error.
+ */
+extern C int dup(int fildes);
+
+/**
+ * @brief Duplicate an open file descriptor to a given number.
+ *
+ * The dup2() function shall cause fildes2 to refer to the same file
+ * as fildes, closing fildes2 first if open. FD_CLOEXEC is cleared
+ * on fildes2.
+ *
+ * @param fildes File descriptor to duplicate.
+ * @param fildes2 File descriptor number to use.
+ * @return fildes2 on success; otherwise, -1 shall be returned and errno
+ *         set to indicate the error.
+ */
+extern C int dup2(int fildes, int fildes2);
+
 /**
  * @brief Execute a file.
  *
@@ -279,6 +367,18 @@ extern C char *getcwd(char *buf, size_t size);
  */
 extern C int chdir(const char *path);
 
+/**
+ * Suspend execution for an interval.
+ *
+ * The usleep() function shall cause the calling thread to be
+ * suspended from execution until at least the number of
+ * microseconds specified by usec has elapsed.
+ *
+ * @param usec Microseconds to sleep.
+ * @return 0 on success.
+ */
+extern C int usleep(useconds_t usec);
+
 /**
  * @}
  */
@@ -19,6 +19,8 @@
 #include <FileSystemMessage.h>
 #include <ProcessID.h>
 #include "Runtime.h"
+#include "Pipe.h"
+#include <string.h>
 #include <errno.h>
 #include "unistd.h"
 
@@ -31,8 +33,15 @@ int close(int fildes)
     msg.action = CloseFile;
     msg.fd     = fildes;
     
+    /* Release our end of a pipe. */
+    if (mnt == FILE_DESCRIPTOR_PIPE)
+    {
+	pipeRelease(getFiles()->get(fildes));
+	memset(getFiles()->get(fildes), 0, sizeof(FileDescriptor));
+	errno = ESUCCESS;
+    }
     /* Ask the FileSystem. */
-    if (mnt)
+    else if (mnt)
     {
 	IPCMessage(mnt, SendReceive, &msg, sizeof(msg));
     
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FileDescriptor.h>
+#include "Runtime.h"
+#include "Pipe.h"
+#include <errno.h>
+#include "unistd.h"
+
+int dup2(int fildes, int fildes2)
+{
+    FileDescriptor *fd = getFiles()->get(fildes);
+    FileDescriptor *copy = getFiles()->get(fildes2);
+
+    if (!fd || !fd->mount || !copy)
+    {
+	errno = EBADF;
+	return -1;
+    }
+    if (fildes == fildes2)
+    {
+	return fildes2;
+    }
+    /* Replace whatever fildes2 refers to now. */
+    if (copy->mount)
+    {
+	close(fildes2);
+    }
+    if (fd->mount == FILE_DESCRIPTOR_PIPE)
+    {
+	pipeRetain(fd);
+    }
+    copy->identifier = fd->identifier;
+    copy->position   = fd->position;
+    copy->flags      = ZERO;
+    copy->mount      = fd->mount;
+    return fildes2;
+}
@@ -21,12 +21,16 @@
 #include <ProcessID.h>
 #include "Runtime.h"
 #include <errno.h>
+#include <stdio.h>
 #include "unistd.h"
 
 pid_t fork(void)
 {
     ProcessMessage msg;
     char key[64];
+
+    /* Avoid duplicating buffered output in the child. */
+    fflush(ZERO);
     
     /* Fill in the message. */
     msg.action = CloneProcess;
@@ -23,6 +23,7 @@
 #include <Types.h>
 #include <string.h>
 #include <errno.h>
+#include <stdio.h>
 #include "unistd.h"
 
 int forkexec(const char *path, const char *argv[])
@@ -31,6 +32,9 @@ int forkexec(const char *path, const char *argv[])
     char *arguments = new char[PAGESIZE];
     uint count = 0;
 
+    /* Write out buffered output before the new program starts. */
+    fflush(ZERO);
+
     /* Fill in arguments. */
     while (argv[count] && count < PAGESIZE / ARGV_SIZE)
     {
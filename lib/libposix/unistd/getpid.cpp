@@ -15,11 +15,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <API/ProcessCtl.h>
-#include <ProcessID.h>
+#include <FreeNOS/InfoPage.h>
 #include "unistd.h"
 
 pid_t getpid()
 {
-    return ProcessCtl(SELF, GetPID);
+    return ((ProcessPage *) PROCESS_PAGE_ADDR)->id;
 }
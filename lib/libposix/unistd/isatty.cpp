@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include "sys/stat.h"
+#include "unistd.h"
+
+int isatty(int fildes)
+{
+    struct stat st;
+
+    /* Terminals are the character devices. */
+    if (fstat(fildes, &st) == 0 && S_ISCHR(st.st_mode))
+    {
+	return 1;
+    }
+    errno = ENOTTY;
+    return 0;
+}
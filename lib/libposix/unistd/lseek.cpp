@@ -27,13 +27,17 @@ off_t lseek(int fildes, off_t offset, int whence)
     FileSystemMessage msg;
     ProcessID mnt = findMount(fildes);
     
+    /* Pipes have no file offset. */
+    if (mnt == FILE_DESCRIPTOR_PIPE)
+	errno = ESPIPE;
+
     /* Ask for the seek. */
-    if (mnt)
+    else if (mnt)
     {
-	// TODO: use the whence argument.
 	msg.action = SeekFile;
 	msg.fd     = fildes;
 	msg.offset = offset;
+	msg.size   = whence;
 	IPCMessage(mnt, SendReceive, &msg, sizeof(msg));
 	
 	/* Set error number. */
@@ -43,5 +47,5 @@ off_t lseek(int fildes, off_t offset, int whence)
 	errno = ENOENT;
     
     /* Done. */
-    return errno == ESUCCESS ? 0 : (off_t) -1;
+    return errno == ESUCCESS ? (off_t) msg.offset : (off_t) -1;
 }
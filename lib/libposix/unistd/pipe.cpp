@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <FileDescriptor.h>
+#include "Runtime.h"
+#include "Pipe.h"
+#include <errno.h>
+#include <string.h>
+#include "unistd.h"
+
+int pipe(int fildes[2])
+{
+    Error result;
+    u32 secret;
+
+    if ((result = pipeCreate(&secret)) != ESUCCESS)
+    {
+	errno = result;
+	return -1;
+    }
+    FileDescriptor reader(FILE_DESCRIPTOR_PIPE, PIPE_IDENT(secret, false));
+    FileDescriptor writer(FILE_DESCRIPTOR_PIPE, PIPE_IDENT(secret, true));
+
+    /* The creator is part of the key. */
+    reader.position = getpid();
+    writer.position = reader.position;
+
+    /* Both ends live in our own FileDescriptor table. */
+    if ((fildes[0] = insertFile(reader.mount, reader.identifier)) < 0 ||
+        (fildes[1] = insertFile(writer.mount, writer.identifier)) < 0)
+    {
+	if (fildes[0] >= 0)
+	{
+	    memset(getFiles()->get(fildes[0]), 0, sizeof(FileDescriptor));
+	}
+	pipeRelease(&reader);
+	pipeRelease(&writer);
+	errno = EMFILE;
+	return -1;
+    }
+    getFiles()->get(fildes[0])->position = reader.position;
+    getFiles()->get(fildes[1])->position = writer.position;
+    return 0;
+}
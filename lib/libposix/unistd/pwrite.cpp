@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/IPCMessage.h>
+#include <FileSystemMessage.h>
+#include "Runtime.h"
+#include <ProcessID.h>
+#include <errno.h>
+#include "unistd.h"
+
+ssize_t pwrite(int fildes, const void *buf, size_t nbyte, off_t offset)
+{
+    FileSystemMessage msg;
+    ProcessID mnt = findMount(fildes);
+
+    /* Pipes have no file offset. */
+    if (mnt == FILE_DESCRIPTOR_PIPE)
+	errno = ESPIPE;
+
+    /* Write at the offset, in one round trip. */
+    else if (mnt)
+    {
+	msg.action = WriteFileAt;
+        msg.fd     = fildes;
+        msg.buffer = (char *) buf;
+        msg.size   = nbyte;
+        msg.offset = offset;
+        IPCMessage(mnt, SendReceive, &msg, sizeof(msg));
+
+        /* Set error number. */
+	errno = msg.result;
+    }
+    else
+	errno = ENOENT;
+
+    /* Give the result back. */
+    return errno >= 0 ? errno : (ssize_t) -1;
+}
@@ -18,6 +18,7 @@
 #include <API/IPCMessage.h>
 #include <FileSystemMessage.h>
 #include "Runtime.h"
+#include "Pipe.h"
 #include <ProcessID.h>
 #include <errno.h>
 #include "unistd.h"
@@ -27,8 +28,12 @@ ssize_t read(int fildes, void *buf, size_t nbyte)
     FileSystemMessage msg;
     ProcessID mnt = findMount(fildes);
 
+    /* Pipes are read directly from the ring. */
+    if (mnt == FILE_DESCRIPTOR_PIPE)
+	errno = pipeRead(getFiles()->get(fildes), buf, nbyte);
+
     /* Read the file. */
-    if (mnt)
+    else if (mnt)
     {
 	msg.action = ReadFile;
         msg.fd     = fildes;
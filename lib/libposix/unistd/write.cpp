@@ -18,6 +18,7 @@
 #include <API/IPCMessage.h>
 #include <FileSystemMessage.h>
 #include "Runtime.h"
+#include "Pipe.h"
 #include <ProcessID.h>
 #include <errno.h>
 #include "unistd.h"
@@ -26,9 +27,13 @@ ssize_t write(int fildes, const void *buf, size_t nbyte)
 {
     FileSystemMessage msg;
     ProcessID mnt = findMount(fildes);
+
+    /* Pipes are written directly to the ring. */
+    if (mnt == FILE_DESCRIPTOR_PIPE)
+	errno = pipeWrite(getFiles()->get(fildes), buf, nbyte);
     
     /* Write the file. */
-    if (mnt)
+    else if (mnt)
     {
 	msg.action = WriteFile;
         msg.fd     = fildes;
@@ -20,6 +20,7 @@
 
 #include <Types.h>
 #include <Error.h>
+#include <poll.h>
 
 /**
  * Represents a device attached to the system.
@@ -74,6 +75,46 @@ class Device
 	    return ENOTSUP;
 	}
 	
+	/**
+	 * Read bytes, for a request which may be retried.
+	 *
+	 * Devices which return EAGAIN while the transfer is in progress
+	 * recognize the retries of a request by its identity.
+	 *
+	 * @param buffer Buffer to store bytes to read.
+	 * @param size Number of bytes to read.
+	 * @param offset Offset in the device.
+	 * @param request Identity of the request, the same for each retry.
+	 * @return Number of bytes on success and an error code on failure.
+	 */
+	virtual Error read(s8 *buffer, Size size, Size offset, u64 request)
+	{
+	    return read(buffer, size, offset);
+	}
+
+	/**
+	 * Write bytes, for a request which may be retried.
+	 * @param buffer Buffer containing bytes to write.
+	 * @param size Number of bytes to write.
+	 * @param offset Offset in the device.
+	 * @param request Identity of the request, the same for each retry.
+	 * @return Number of bytes on success and an error code on failure.
+	 */
+	virtual Error write(s8 *buffer, Size size, Size offset, u64 request)
+	{
+	    return write(buffer, size, offset);
+	}
+
+	/**
+	 * Check which operations would complete without waiting.
+	 * @return Bitmask of POLLIN and POLLOUT. Devices which do not
+	 *         know are always ready.
+	 */
+	virtual short poll()
+	{
+	    return POLLIN | POLLOUT;
+	}
+
 	/**
 	 * Called when an interrupt has been triggered for this device.
 	 * @param vector Vector number of the interrupt.
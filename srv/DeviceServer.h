@@ -73,6 +73,11 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 	    addIPCHandler(WriteFile, &DeviceServer::ioHandler, false);
 	    addIPCHandler(SeekFile,  &DeviceServer::ioHandler, false);
 	    addIPCHandler(CloseFile, &DeviceServer::ioHandler, false);
+	    addIPCHandler(PollFile,  &DeviceServer::ioHandler, false);
+	    addIPCHandler(ReadFileAt,  &DeviceServer::ioHandler, false);
+	    addIPCHandler(WriteFileAt, &DeviceServer::ioHandler, false);
+	    addIPCHandler(StatFileDescriptor, &DeviceServer::ioHandler, false);
+	    setWakeupHandler(&DeviceServer::wakeupHandler);
 	}
 
 	/**
@@ -141,7 +146,10 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 		    if (interrupts[i])
 		    {
 		    	/* Register to kernel. */
-			ProcessCtl(SELF, WatchIRQ, i);
+			if (ProcessCtl(SELF, WatchIRQ, i) != ESUCCESS)
+			{
+			    return EXIT_FAILURE;
+			}
 	    
 			/* Register interrupt handler. */
 			addIRQHandler(i, &DeviceServer::interruptHandler);
@@ -216,6 +224,31 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 
     private:
 
+	/**
+	 * @brief Describe the device file opened by a request.
+	 * @param msg Request with the FileStat to fill in.
+	 * @return Error code status.
+	 */
+	Error statDevice(FileSystemMessage *msg)
+	{
+	    FileStat st;
+
+	    st.type    = type;
+	    st.access  = mode;
+	    st.size    = ZERO;
+	    st.userID  = ZERO;
+	    st.groupID = ZERO;
+	    st.deviceID.major = getpid();
+	    st.deviceID.minor = msg->deviceID.minor;
+
+	    if (VMCopy(msg->from, Write, (Address) &st,
+		       (Address) msg->stat, sizeof(st)) <= 0)
+	    {
+		return EFAULT;
+	    }
+	    return ESUCCESS;
+	}
+
 	/**
 	 * @brief Input/Output request handler.
 	 */    
@@ -229,7 +262,7 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
             if (!fd)
 	    {
 		msg->result = EBADF;
-		msg->ipc(msg->from, Send, sizeof(*msg));
+		msg->ipc(msg->thread, Send, sizeof(*msg));
 		return;
 	    }
 	    /* Read out values from the FileDescriptor. */
@@ -238,7 +271,8 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 		dev = devices[fd->identifier];
 		msg->deviceID.minor = fd->identifier;
 		
-		if (msg->action != SeekFile)
+		if (msg->action != SeekFile && msg->action != ReadFileAt &&
+		    msg->action != WriteFileAt)
 		    msg->offset = fd->position;
 	    }
 	    
@@ -248,23 +282,47 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 		switch (msg->action)
 		{
 		    case ReadFile:
+		    case ReadFileAt:
 			result = performRead(msg);
 			break;
 		
 		    case WriteFile:
+		    case WriteFileAt:
 			result = performWrite(msg);
 			break;
 			
 		    case SeekFile:
-			fd->position = msg->offset;
-			msg->result  = ESUCCESS;
-			msg->ipc(msg->from, Send, sizeof(*msg));
+			/* Devices have no end to seek from. */
+			if (msg->size == SEEK_END)
+			    msg->result = EINVAL;
+			else
+			{
+			    if (msg->size == SEEK_CUR)
+				msg->offset += fd->position;
+			    fd->position = msg->offset;
+			    msg->result  = ESUCCESS;
+			}
+			msg->ipc(msg->thread, Send, sizeof(*msg));
+			return;
+
+		    case StatFileDescriptor:
+			msg->result = statDevice(msg);
+			msg->ipc(msg->thread, Send, sizeof(*msg));
 			return;
 		
 		    case CloseFile:
 	                memset(fd, 0, sizeof(*fd));
 			msg->result = ESUCCESS;
-			msg->ipc(msg->from, Send, sizeof(*msg));
+			msg->ipc(msg->thread, Send, sizeof(*msg));
+			return;
+
+		    case PollFile:
+			/* Wake the poller later, if nothing is ready now. */
+			if (!(msg->result = dev->poll() & msg->size))
+			{
+			    addPoller(msg);
+			}
+			msg->ipc(msg->thread, Send, sizeof(*msg));
 			return;
 		
 		    default:
@@ -281,7 +339,7 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 	    else
 	    {
 		msg->result = ENODEV;
-		msg->ipc(msg->from, Send, sizeof(*msg));
+		msg->ipc(msg->thread, Send, sizeof(*msg));
 	    }
 	}
 	
@@ -310,16 +368,36 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 		    i.current()->interrupt(msg->vector);
 		}
 	    }
-	    /*
-	     * Retry any requests in the queue.
-	     * Remove them once processed.
-	     */
+	    retryRequests();
+	    wakePollers();
+	}
+
+	/**
+	 * @brief Wakeup handler.
+	 *
+	 * Called when a file polled by one of our Devices, such
+	 * as the input of a Terminal, may have become ready.
+	 */
+	void wakeupHandler()
+	{
+	    retryRequests();
+	    wakePollers();
+	}
+
+	/**
+	 * @brief Retry any requests in the queue.
+	 *
+	 * Removes them once processed.
+	 */
+	void retryRequests()
+	{
 	    for (ListIterator<FileSystemMessage> i(&requests); i.hasNext(); i++)
 	    {
 		/* Only handle read/write operations. */
 		switch (i.current()->action)
 		{
 		    case ReadFile:
+		    case ReadFileAt:
 		    
 			if (performRead(i.current()))
 			{
@@ -328,6 +406,7 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 			break;
 		    
 		    case WriteFile:
+		    case WriteFileAt:
 		    
 			if (performWrite(i.current()))
 			{
@@ -340,6 +419,61 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 	    }
 	}
 
+	/**
+	 * @brief Remember a thread polling a Device.
+	 *
+	 * @param msg PollFile request, with the events in size.
+	 */
+	void addPoller(FileSystemMessage *msg)
+	{
+	    for (ListIterator<FileSystemMessage> i(&pollers); i.hasNext(); i++)
+	    {
+		if (i.current()->thread == msg->thread &&
+		    i.current()->deviceID.minor == msg->deviceID.minor)
+		{
+		    i.current()->size |= msg->size;
+		    return;
+		}
+	    }
+	    pollers.insertTail(new FileSystemMessage(*msg));
+	}
+
+	/**
+	 * @brief Wake the pollers of Devices which became ready.
+	 *
+	 * Each poller is woken once, and polls again if needed.
+	 */
+	void wakePollers()
+	{
+	    FileSystemMessage *p;
+
+	    for (ListIterator<FileSystemMessage> i(&pollers); i.hasNext(); i++)
+	    {
+		p = i.current();
+
+		if (devices[p->deviceID.minor]->poll() & p->size)
+		{
+		    ProcessCtl(p->thread, Wakeup);
+		    pollers.remove(p);
+		    delete p;
+		}
+	    }
+	}
+
+	/**
+	 * @brief Identify a request across retries.
+	 *
+	 * A thread may have several requests in flight, each with
+	 * its own buffer.
+	 *
+	 * @param msg Request message.
+	 * @return Sending thread and buffer address.
+	 */
+	u64 requestID(FileSystemMessage *msg)
+	{
+	    return ((u64) msg->thread << 32) | (Address) msg->buffer;
+	}
+
 	/**
 	 * @brief Attempt to perform a read operation.
 	 *
@@ -357,7 +491,8 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 	     * Perform the read operation using the underlying
 	     * read() implementation of the Device.
 	     */
-	    if ((msg->result = dev->read(buffer, msg->size, msg->offset)) >= 0)
+	    if ((msg->result = dev->read(buffer, msg->size, msg->offset,
+					  requestID(msg))) >= 0)
 	    {
 		/* Write the result into the process' buffer. */
 	        msg->result = VMCopy(msg->from, Write, (Address) buffer,
@@ -366,9 +501,10 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 	    /* Update FileDescriptor and send a reply if processed. */
 	    if (msg->result != EAGAIN)
 	    {
-		if (msg->result > 0)
+		if (msg->result > 0 && msg->action != ReadFileAt &&
+		    msg->action != WriteFileAt)
 		    getFileDescriptor(files, msg->from, msg->fd)->position += msg->result;
-		msg->ipc(msg->from, Send, sizeof(*msg));
+		msg->ipc(msg->thread, Send, sizeof(*msg));
 	    }
 	    /* Release memory. And return. */
 	    delete buffer;
@@ -396,14 +532,16 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 		 * Perform the write operation using the underlying
 		 * write() implementation of the Device.
 	    	 */
-		msg->result = dev->write(buffer, msg->size, msg->offset);
+		msg->result = dev->write(buffer, msg->size, msg->offset,
+					 requestID(msg));
 	    }
 	    /* Send a reply if processed. */
 	    if (msg->result != EAGAIN)
 	    {
-		if (msg->result > 0)
+		if (msg->result > 0 && msg->action != ReadFileAt &&
+		    msg->action != WriteFileAt)
 		    getFileDescriptor(files, msg->from, msg->fd)->position += msg->result;
-		msg->ipc(msg->from, Send, sizeof(*msg));
+		msg->ipc(msg->thread, Send, sizeof(*msg));
 	    }
 	    /* Release memory. And return. */
 	    delete buffer;
@@ -429,6 +567,11 @@ class DeviceServer : public IPCServer<DeviceServer, FileSystemMessage>
 	 * @brief A List of pending I/O operations.
 	 */
 	List<FileSystemMessage> requests;
+
+	/**
+	 * @brief PollFile requests which found nothing ready.
+	 */
+	List<FileSystemMessage> pollers;
 	
 	/** Per-process File descriptors. */
         Array<Shared<FileDescriptor> > *files;
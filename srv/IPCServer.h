@@ -19,8 +19,17 @@
 #define __IPCSERVER_H
 
 #include <API/IPCMessage.h>
+#include <API/ProcessCtl.h>
 #include <Error.h>
 #include <ProcessID.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/** Maximum number of worker threads of an IPCServer. */
+#define IPCSERVER_WORKERS_MAX 8
+
+/** Number of messages which may wait for a worker. */
+#define IPCSERVER_QUEUE_SIZE  32
 
 /**
  * Message handler function (dummy) container.
@@ -44,6 +53,15 @@ template <class Func> struct MessageHandler
 
 /**
  * Template class which serves incoming messages, using MessageHandlers.
+ *
+ * By default, one loop receives and handles each message in turn. With
+ * setWorkers(), the loop only dispatches: IPC messages are queued for a
+ * pool of worker threads, which run the handlers concurrently and send
+ * the replies. Handlers must then lock whatever they share. IRQ messages
+ * are still handled by the dispatching thread, as are wakeups: these
+ * arrive when another process calls ProcessCtl(pid, Wakeup), such as a
+ * server whose file we are polling.
+ *
  * @param MsgType Type of Message to serve.
  */
 template <class Base, class MsgType> class IPCServer
@@ -54,6 +72,25 @@ template <class Base, class MsgType> class IPCServer
     /** Member function pointer inside Base, to handle IRQ messages. */
     typedef void (Base::*IRQHandlerFunction)(InterruptMessage *);
 
+    /** Member function pointer inside Base, to handle wakeups. */
+    typedef void (Base::*WakeupHandlerFunction)();
+
+    /**
+     * State of a worker thread.
+     */
+    typedef struct Worker
+    {
+	/** Server which started the worker. */
+	IPCServer *server;
+
+	/** Thread identity. */
+	pthread_t thread;
+
+	/** Waiting for the dispatcher to queue a message? */
+	bool idle;
+    }
+    Worker;
+
     public:
 
         /**
@@ -61,10 +98,12 @@ template <class Base, class MsgType> class IPCServer
 	 * @param num Number of message handlers to support.
          */
         IPCServer(Base *inst, Size num = 32)
-	    : sendReply(true), instance(inst)
+	    : sendReply(true), instance(inst), wakeupHandler(ZERO), workerCount(0),
+	      queueHead(0), queueCount(0)
         {
 	    ipcHandlers = new Array<MessageHandler<IPCHandlerFunction> >(num);
 	    irqHandlers = new Array<MessageHandler<IRQHandlerFunction> >(num);
+	    pthread_mutex_init(&queueLock, ZERO);
 	}
 
 	/**
@@ -85,6 +124,14 @@ template <class Base, class MsgType> class IPCServer
 	    MsgType msg;
 	    InterruptMessage *imsg = (InterruptMessage *) &msg;
 
+	    /* Start the worker threads, if any. */
+	    for (Size i = 0; i < workerCount; i++)
+	    {
+		workers[i].server = this;
+		workers[i].idle   = false;
+		pthread_create(&workers[i].thread, ZERO,
+			       &IPCServer::workerEntry, &workers[i]);
+	    }
     	    /* Enter loop. */
 	    while (true)
 	    {
@@ -98,6 +145,11 @@ template <class Base, class MsgType> class IPCServer
 		switch (msg.type)
 		{			
 		    case IPCType:
+			if (workerCount)
+			{
+			    dispatch(&msg);
+			    continue;
+			}
 			if ((*ipcHandlers)[msg.action])
 			{
 			    sendReply =  (*ipcHandlers)[msg.action]->sendReply;
@@ -109,10 +161,23 @@ template <class Base, class MsgType> class IPCServer
 			break;
 
 		    case IRQType:
-			if ((*irqHandlers)[imsg->vector])
+			sendReply = false;
+
+			/* Handle every pending vector. */
+			for (ulong i = 0, p = imsg->pending; p; i++, p >>= 1)
 			{
-			    sendReply = false;
-			    (instance->*((*irqHandlers)[imsg->vector])->exec) (imsg);
+			    if ((p & 1) && (*irqHandlers)[i])
+			    {
+				imsg->vector = i;
+				(instance->*((*irqHandlers)[i])->exec) (imsg);
+			    }
+			}
+			continue;
+
+		    case WakeupType:
+			if (wakeupHandler)
+			{
+			    (instance->*wakeupHandler) ();
 			}
 			
 		    default:
@@ -121,7 +186,7 @@ template <class Base, class MsgType> class IPCServer
 		/* Send Reply. */
 		if (sendReply)
 		{
-		    IPCMessage(msg.from, Send, &msg, sizeof(MsgType));
+		    IPCMessage(msg.thread, Send, &msg, sizeof(MsgType));
 		}
 	    }
     	    /* Satify compiler. */
@@ -149,12 +214,129 @@ template <class Base, class MsgType> class IPCServer
 	    irqHandlers->insert(slot, new MessageHandler<IRQHandlerFunction>(h, false));
 	}
 
+	/**
+	 * Register the handler of wakeups.
+	 * @param h Handler to execute.
+	 */
+	void setWakeupHandler(WakeupHandlerFunction h)
+	{
+	    wakeupHandler = h;
+	}
+
+	/**
+	 * Serve IPC messages with a pool of worker threads. Must be
+	 * called before run().
+	 * @param count Number of workers, up to IPCSERVER_WORKERS_MAX.
+	 *              Zero handles each message in run() itself.
+	 */
+	void setWorkers(Size count)
+	{
+	    workerCount = count < IPCSERVER_WORKERS_MAX ?
+			  count : IPCSERVER_WORKERS_MAX;
+	}
+
     protected:
 
-	/** Should we send a reply message? */
+	/** Should we send a reply message? Only used without workers. */
 	bool sendReply;
 
     private:
+
+	/**
+	 * Queue a message for the workers, and wake one if it sleeps.
+	 * @param msg Message to queue.
+	 */
+	void dispatch(MsgType *msg)
+	{
+	    ProcessID wake = ANY;
+	    Message bell;
+
+	    pthread_mutex_lock(&queueLock);
+
+	    /* Let the workers catch up if the queue is full. */
+	    while (queueCount == IPCSERVER_QUEUE_SIZE)
+	    {
+		pthread_mutex_unlock(&queueLock);
+		ProcessCtl(SELF, Schedule);
+		pthread_mutex_lock(&queueLock);
+	    }
+	    queue[(queueHead + queueCount) % IPCSERVER_QUEUE_SIZE] = *msg;
+	    queueCount++;
+
+	    /* Find an idle worker. */
+	    for (Size i = 0; i < workerCount; i++)
+	    {
+		if (workers[i].idle)
+		{
+		    workers[i].idle = false;
+		    wake = workers[i].thread;
+		    break;
+		}
+	    }
+	    pthread_mutex_unlock(&queueLock);
+
+	    /* The message itself stays in the queue: send an empty one. */
+	    if (wake != ANY)
+	    {
+		IPCMessage(wake, Send, &bell, sizeof(bell));
+	    }
+	}
+
+	/**
+	 * Handle queued messages forever.
+	 * @param w Our worker state.
+	 */
+	void work(Worker *w)
+	{
+	    MessageHandler<IPCHandlerFunction> *h;
+	    MsgType msg;
+	    Message bell;
+
+	    /* The dispatcher may wake us before pthread_create() returns. */
+	    w->thread = pthread_self();
+
+	    while (true)
+	    {
+		pthread_mutex_lock(&queueLock);
+
+		/* Sleep until the dispatcher wakes us. */
+		while (!queueCount)
+		{
+		    w->idle = true;
+		    pthread_mutex_unlock(&queueLock);
+		    IPCMessage(getpid(), Receive, &bell, sizeof(bell));
+		    pthread_mutex_lock(&queueLock);
+		}
+		msg = queue[queueHead];
+		queueHead = (queueHead + 1) % IPCSERVER_QUEUE_SIZE;
+		queueCount--;
+		pthread_mutex_unlock(&queueLock);
+
+		/* Handle the message. */
+		if ((h = (*ipcHandlers)[msg.action]))
+		{
+		    (instance->*(h->exec)) (&msg);
+		}
+		/* Reply, unless the handler does so later. */
+		if (!h || h->sendReply)
+		{
+		    IPCMessage(msg.thread, Send, &msg, sizeof(MsgType));
+		}
+	    }
+	}
+
+	/**
+	 * Entry point of worker threads.
+	 * @param arg Worker state.
+	 * @return Never.
+	 */
+	static void * workerEntry(void *arg)
+	{
+	    Worker *w = (Worker *) arg;
+
+	    w->server->work(w);
+	    return ZERO;
+	}
     
 	/** IPC handler functions. */
 	Array<MessageHandler<IPCHandlerFunction> > *ipcHandlers;
@@ -164,6 +346,27 @@ template <class Base, class MsgType> class IPCServer
 	
 	/** Server object instance. */
 	Base *instance;
+
+	/** Wakeup handler function, if any. */
+	WakeupHandlerFunction wakeupHandler;
+
+	/** Number of worker threads. Zero if run() handles messages. */
+	Size workerCount;
+
+	/** Worker threads. */
+	Worker workers[IPCSERVER_WORKERS_MAX];
+
+	/** Messages waiting for a worker. */
+	MsgType queue[IPCSERVER_QUEUE_SIZE];
+
+	/** Index of the oldest queued message. */
+	Size queueHead;
+
+	/** Number of queued messages. */
+	Size queueCount;
+
+	/** Protects the queue and the idle flags of the workers. */
+	pthread_mutex_t queueLock;
 };
 
 #endif /* __IPCSERVER_H */
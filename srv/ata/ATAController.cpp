@@ -21,6 +21,7 @@
 #include <Types.h>
 #include <stdlib.h>
 #include <syslog.h>
+#include <unistd.h>
 
 int main(int argc, char **argv)
 {
@@ -93,8 +94,8 @@ Error ATAController::initialize()
 	    IDENTIFY_TEXT_SWAP(drive->identity.model, 40);
 
 	    /* Print out information. */
-	    syslog(LOG_INFO, "ATA drive detected: SERIAL=%20s FIRMWARE=%8s "
-			     "MODEL=%40s MAJOR=%x MINOR=%x SECTORS=%x",
+	    syslog(LOG_INFO, "ATA drive detected: SERIAL=%.20s FIRMWARE=%.8s "
+			     "MODEL=%.40s MAJOR=%#x MINOR=%#x SECTORS=%#x",
 			      drive->identity.serial,
 			      drive->identity.firmware,
 			      drive->identity.model,
@@ -162,7 +163,7 @@ Error ATAController::interrupt(Size vector)
 
 void ATAController::pollReady(bool noData)
 {
-    while (true)
+    for (Size polls = 0; ; polls++)
     {
 	u8 status = inb(ATA_BASE_CMD0 + ATA_REG_STATUS);
 	
@@ -171,5 +172,8 @@ void ATAController::pollReady(bool noData)
 	{
 	    break;
 	}
+	/* Slow drive: stop spinning. */
+	if (polls >= ATA_POLL_SPIN)
+	    usleep(ATA_POLL_SLEEP);
     }
 }
@@ -137,6 +137,12 @@
  * @}
  */
 
+/** @brief Status polls before sleeping in between. */
+#define ATA_POLL_SPIN	1000
+
+/** @brief Microseconds to sleep between status polls, after spinning. */
+#define ATA_POLL_SLEEP	500
+
 /**
  * @name ATA Control Registers.
  * @see http://wiki.osdev.org/ATA_PIO_Mode#Device_Control_Register_.2F_Alternate_Status
@@ -289,6 +295,10 @@ class ATAController : public Device
     
 	/**
 	 * @brief Polls the Regular Status register.
+	 *
+	 * Spins ATA_POLL_SPIN times, then sleeps ATA_POLL_SLEEP
+	 * microseconds between polls to leave the CPU to others.
+	 *
 	 * @param noData Don't wait for the ATA_STATUS_DATA flag to set.
 	 */
 	void pollReady(bool noData = false);
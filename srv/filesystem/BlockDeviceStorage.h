@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FILESYSTEM_BLOCKDEVICESTORAGE_H
+#define __FILESYSTEM_BLOCKDEVICESTORAGE_H
+
+#include <API/IPCMessage.h>
+#include <Types.h>
+#include <Error.h>
+#include <Runtime.h>
+#include "FileStorage.h"
+#include "FileSystemMessage.h"
+
+/** Preferred bytes in a single request to a block device. */
+#define BLOCKDEVICE_BLOCK_SIZE	(PAGESIZE * 16)
+
+/** Sector size: block devices transfer whole sectors. */
+#define BLOCKDEVICE_ALIGNMENT	512
+
+/**
+ * @brief Use a block device file, such as /dev/ata0, as Storage provider.
+ *
+ * A batch given to readAsync() goes to the device server all at once,
+ * as messages with their own offset. Device servers which keep several
+ * requests in flight, such as VirtIO, then complete them together.
+ *
+ * @see Storage
+ * @see DeviceServer
+ */
+class BlockDeviceStorage : public FileStorage
+{
+    public:
+
+	/**
+	 * @brief Constructor function.
+	 * @param path Full path to the device file to use.
+	 * @param offset Offset in the device as a base for I/O.
+	 */
+	BlockDeviceStorage(const char *path, Size offset = ZERO)
+	    : FileStorage(path, offset)
+	{
+	}
+
+	/**
+	 * Start a batch of reads.
+	 * @param requests Reads to start.
+	 * @param count Number of requests.
+	 * @return Error code.
+	 */
+	Error readAsync(StorageRequest *requests, Size count)
+	{
+	    FileSystemMessage msg;
+	    ProcessID mnt = findMount(file);
+
+	    if (file < 0 || !mnt)
+	    {
+		return EBADF;
+	    }
+	    for (Size i = 0; i < count; i++)
+	    {
+		msg.action = ReadFileAt;
+		msg.fd     = file;
+		msg.buffer = (char *) requests[i].buffer;
+		msg.size   = requests[i].size;
+		msg.offset = this->offset + requests[i].offset;
+		requests[i].result = EAGAIN;
+
+		/* Don't wait for the reply here. */
+		if (IPCMessage(mnt, Send, &msg, sizeof(msg)) != ESUCCESS)
+		{
+		    requests[i].result = EIO;
+		}
+	    }
+	    return ESUCCESS;
+	}
+
+	/**
+	 * Wait until a batch started by readAsync() completed.
+	 * @param requests Reads given to readAsync().
+	 * @param count Number of requests.
+	 * @return Error code.
+	 */
+	Error complete(StorageRequest *requests, Size count)
+	{
+	    FileSystemMessage msg;
+	    ProcessID mnt = findMount(file);
+	    Size pending = 0;
+
+	    for (Size i = 0; i < count; i++)
+	    {
+		if (requests[i].result == EAGAIN)
+		    pending++;
+	    }
+	    /* Replies come back in any order: match them by buffer. */
+	    while (pending)
+	    {
+		if (IPCMessage(mnt, Receive, &msg, sizeof(msg)) != ESUCCESS)
+		{
+		    return EIO;
+		}
+		for (Size i = 0; i < count; i++)
+		{
+		    if (requests[i].result == EAGAIN &&
+			requests[i].buffer == msg.buffer)
+		    {
+			requests[i].result = msg.result;
+			pending--;
+			break;
+		    }
+		}
+	    }
+	    return ESUCCESS;
+	}
+
+	/**
+	 * Preferred number of bytes in a single read or write.
+	 * @return Size in bytes.
+	 */
+	Size blockSize()
+	{
+	    return BLOCKDEVICE_BLOCK_SIZE;
+	}
+
+	/**
+	 * Offsets of reads and writes are best a multiple of this.
+	 * @return Alignment in bytes.
+	 */
+	Size alignment()
+	{
+	    return BLOCKDEVICE_ALIGNMENT;
+	}
+};
+
+#endif /* __FILESYSTEM_BLOCKDEVICESTORAGE_H */
@@ -193,8 +193,10 @@ class Directory : public File
 	    {
 		if (strcmp(i.current()->name, name) == 0)
 		{
-		    entries.remove(i.current());
-		    delete i.current();
+		    Dirent *d = i.current();
+
+		    entries.remove(d);
+		    delete d;
 		    size -= sizeof(Dirent);
 		    return;
 		}
@@ -26,6 +26,7 @@
 #include "FileType.h"
 #include "FileMode.h"
 #include "IOBuffer.h"
+#include <pthread.h>
 
 /**
  * @brief Abstracts a file present on a FileSystem.
@@ -43,8 +44,9 @@ class File
 	 */
 	File(FileType t = RegularFile, UserID u = ZERO, GroupID g = ZERO)
 	    : type(t), access(OwnerRWX), size(ZERO),
-	      openCount(ZERO), uid(u), gid(g)
+	      openCount(ZERO), refCount(ZERO), uid(u), gid(g)
 	{
+	    pthread_mutex_init(&lock, ZERO);
 	}
 
 	/**
@@ -63,6 +65,15 @@ class File
 	    return type;
 	}
 
+	/**
+	 * Retrieve the size of the file.
+	 * @return Size in bytes.
+	 */
+	Size getSize()
+	{
+	    return size;
+	}
+
 	/**
 	 * Get the number of times we are opened by a process.
 	 * @return Open count.
@@ -73,6 +84,33 @@ class File
 	    return openCount;
 	}
 
+	/**
+	 * Keep us alive. Each FileCache naming us holds a reference, as
+	 * does a request which uses us without the cache lock.
+	 */
+	void ref()
+	{
+	    __sync_add_and_fetch(&refCount, 1);
+	}
+
+	/**
+	 * Drop a reference taken with ref().
+	 * @return Number of references left.
+	 */
+	Size unref()
+	{
+	    return __sync_sub_and_fetch(&refCount, 1);
+	}
+
+	/**
+	 * Get the lock which serializes I/O on us.
+	 * @return Mutex pointer.
+	 */
+	pthread_mutex_t * getLock()
+	{
+	    return &lock;
+	}
+
 	/**
 	 * Attempt to open a file.
 	 * @param msg Describes the open request.
@@ -160,12 +198,18 @@ class File
 	
 	/** Number of times the File has been opened by a process. */
 	Size openCount;
+
+	/** Number of FileCaches and requests using the File. */
+	volatile Size refCount;
 	
 	/** Owner of the file. */
 	UserID uid;
 	
 	/** Group of the file. */
 	GroupID gid;
+
+	/** Held while a worker thread performs I/O on us. */
+	pthread_mutex_t lock;
 };
 
 #endif /* __FILESYSTEM_FILE_H */
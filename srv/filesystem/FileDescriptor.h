@@ -30,6 +30,12 @@
 /** Maximum number of open file descriptors. */
 #define FILE_DESCRIPTOR_MAX 1024
 
+/** FileDescriptor::mount of a pipe end, served by libposix itself. */
+#define FILE_DESCRIPTOR_PIPE 65532
+
+/** Close the FileDescriptor when spawning a new program. */
+#define FILE_DESCRIPTOR_CLOEXEC (1 << 0)
+
 /**
  * Abstracts a file which is opened by a user process.
  */
@@ -41,7 +47,7 @@ typedef struct FileDescriptor
      * @param ident Unique identifier.
      */
     FileDescriptor(ProcessID mnt, Address ident)
-	: mount(mnt), identifier(ident), position(ZERO)
+	: mount(mnt), identifier(ident), position(ZERO), flags(ZERO)
     {
     }
 
@@ -53,6 +59,9 @@ typedef struct FileDescriptor
 
     /** Current position indicator. */
     Size position;
+
+    /** Bitmask of FILE_DESCRIPTOR_ flags. */
+    Size flags;
 }
 FileDescriptor;
 
@@ -24,9 +24,14 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <errno.h>
 
 /**
  * @brief Use a file as Storage provider.
+ *
+ * Reads and writes carry their own offset (pread, pwrite), so they
+ * take a single round trip and may run from several threads at once.
+ *
  * @see Storage
  */
 class FileStorage : public Storage
@@ -65,9 +70,7 @@ class FileStorage : public Storage
 	    
 	    if (file >= 0)
 	    {
-		lseek(file, this->offset + offset, SEEK_SET);
-		result = ::read(file, buffer, size);
-		
+		result = ::pread(file, buffer, size, this->offset + offset);
 		return result >= 0 ? result : errno;
 	    }
 	    else
@@ -80,15 +83,13 @@ class FileStorage : public Storage
 	 * @param buffer Input buffer.
 	 * @param size Number of bytes to written.
 	 */
-	Error write(u64 offset, void *buffer, Size size)
+	virtual Error write(u64 offset, void *buffer, Size size)
 	{
 	    int result;
 	
 	    if (file >= 0)
 	    {
-		lseek(file, this->offset + offset, SEEK_SET);
-	        result = ::write(file, buffer, size);
-		
+	        result = ::pwrite(file, buffer, size, this->offset + offset);
 		return result >= 0 ? result : errno;
 	    }
 	    else
@@ -104,7 +105,7 @@ class FileStorage : public Storage
 	    return st.st_size;
 	}
 	
-    private:
+    protected:
     
 	/** @brief File descriptor of the file for Storage I/O. */
 	int file;
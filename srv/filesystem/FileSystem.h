@@ -36,6 +36,11 @@
 #include "FileDescriptor.h"
 #include <unistd.h>
 #include <stdlib.h>
+#include <pthread.h>
+#include <poll.h>
+
+/** Number of worker threads of FileSystems backed by slow storage. */
+#define FILESYSTEM_WORKERS 4
 
 /**
  * Cached in-memory file.
@@ -52,11 +57,27 @@ typedef struct FileCache
     FileCache(File *f, const char *name, FileCache *p)
 	: file(f), valid(true)
     {
+	file->ref();
+
 	if (p && p != this)
 	{
 	    p->entries.insert(new String(name), this);
 	}
     }
+
+    /**
+     * @brief Destructor function.
+     *
+     * Deletes the File, unless another FileCache or a request
+     * references it, or a process still has it opened.
+     */
+    ~FileCache()
+    {
+	if (!file->unref() && !file->getOpenCount())
+	{
+	    delete file;
+	}
+    }
     
     /**
      * Comparision operator.
@@ -81,6 +102,11 @@ FileCache;
 
 /**
  * Abstract filesystem class.
+ *
+ * With worker threads, requests are served concurrently. Path lookups
+ * and directory I/O hold cacheLock. I/O on other files holds the lock
+ * of that File. The FileDescriptor tables are protected by filesLock.
+ * Locks are taken in that order.
  */
 class FileSystem : public IPCServer<FileSystem, FileSystemMessage>
 {
@@ -94,6 +120,9 @@ class FileSystem : public IPCServer<FileSystem, FileSystemMessage>
 	    : IPCServer<FileSystem, FileSystemMessage>(this),
 	      root(ZERO), mountPath(path)
 	{
+	    pthread_mutex_init(&cacheLock, ZERO);
+	    pthread_mutex_init(&filesLock, ZERO);
+
 	    /* Register message handlers. */
 	    addIPCHandler(CreateFile, &FileSystem::pathHandler);
 	    addIPCHandler(OpenFile,   &FileSystem::pathHandler);
@@ -102,6 +131,10 @@ class FileSystem : public IPCServer<FileSystem, FileSystemMessage>
 	    addIPCHandler(WriteFile,  &FileSystem::fileDescriptorHandler);
 	    addIPCHandler(CloseFile,  &FileSystem::fileDescriptorHandler);
 	    addIPCHandler(SeekFile,   &FileSystem::fileDescriptorHandler);
+	    addIPCHandler(PollFile,   &FileSystem::fileDescriptorHandler);
+	    addIPCHandler(ReadFileAt,  &FileSystem::fileDescriptorHandler);
+	    addIPCHandler(WriteFileAt, &FileSystem::fileDescriptorHandler);
+	    addIPCHandler(StatFileDescriptor, &FileSystem::fileDescriptorHandler);
 	}
     
 	/**
@@ -200,6 +233,8 @@ class FileSystem : public IPCServer<FileSystem, FileSystemMessage>
 	    else
 		path.parse(buf + strlen(mountPath));
 
+	    pthread_mutex_lock(&cacheLock);
+
 	    /*
 	     * Do we have this file cached?
 	     */
@@ -211,6 +246,7 @@ class FileSystem : public IPCServer<FileSystem, FileSystemMessage>
 	    /* Sorry, no such file! */
 	    else if (msg->action != CreateFile)
 	    {
+		pthread_mutex_unlock(&cacheLock);
 		msg->result = ENOENT;
 		return;
 	    }			
@@ -251,20 +287,35 @@ class FileSystem : public IPCServer<FileSystem, FileSystemMessage>
 		     */
 		    pid   = getpid();
 		    ident = (Address) file;
-		    msg->result = cache->file->open(&pid, &ident);
+
+		    /* Other requests may use the cache while we wait for the file. */
+		    file->ref();
+		    pthread_mutex_unlock(&cacheLock);
+
+		    pthread_mutex_lock(file->getLock());
+		    msg->result = file->open(&pid, &ident);
+		    pthread_mutex_unlock(file->getLock());
 
 		    /* Create a FileDescriptor on success. */
 		    if (msg->result == ESUCCESS)
 		    {
+			pthread_mutex_lock(&filesLock);
         		msg->fd = insertFileDescriptor(msg->from, pid, ident);
+			pthread_mutex_unlock(&filesLock);
 		    }
-		    break;
+		    /* The file may have left the cache meanwhile. */
+		    if (!file->unref() && !file->getOpenCount())
+		    {
+			delete file;
+		    }
+		    return;
 
 		case StatFile:
 		default:
 		    msg->result = file->status(msg);
 		    break;
 	    }
+	    pthread_mutex_unlock(&cacheLock);
 	}
 
 	/**
@@ -284,57 +335,142 @@ class FileSystem : public IPCServer<FileSystem, FileSystemMessage>
 	    IOBuffer io(msg);
 	    FileDescriptor *fd;
 	    File *file = ZERO;
+	    pthread_mutex_t *lock;
+	    Size position = ZERO;
 
 	    /*
-	     * Obtain the FileDescriptor.
+	     * Obtain the FileDescriptor. Another request of the
+	     * process may close it: only use our copy of its fields,
+	     * and keep the file alive until we are done.
 	     */
-	    if (!(fd = getFileDescriptor(files, msg->from, msg->fd)))
+	    pthread_mutex_lock(&filesLock);
+
+	    if ((fd = getFileDescriptor(files, msg->from, msg->fd)))
+	    {
+		file     = (File *) fd->identifier;
+		position = fd->position;
+		file->ref();
+	    }
+	    pthread_mutex_unlock(&filesLock);
+
+	    if (!file)
 	    {
 		msg->result = EBADF;
 		return;
 	    }
+	    /* Directories belong to the file cache. */
+	    lock = file->getType() == DirectoryFile ? &cacheLock : file->getLock();
+	    pthread_mutex_lock(lock);
+
 	    /* Copy FileDescriptor properties. */
-	    if (msg->action != SeekFile)
+	    if (msg->action != SeekFile && msg->action != ReadFileAt &&
+		msg->action != WriteFileAt)
     	    {
-            	msg->offset = fd->position;
-		file = (File *) fd->identifier;
+            	msg->offset = position;
     	    }
 	    /* Perform I/O on the file. */
 	    switch (msg->action)
 	    {
 		case ReadFile:
 		
-		    if ((msg->result = file->read(&io, msg->size, fd->position)) >= 0)
+		    if ((msg->result = file->read(&io, msg->size, position)) >= 0)
 		    {
-			fd->position += msg->result;
+			updatePosition(msg, file, position + msg->result);
 		    }
 		    break;
 		
 		case WriteFile:
 		
-		    if ((msg->result = file->write(&io, msg->size, fd->position)) >= 0)
+		    if ((msg->result = file->write(&io, msg->size, position)) >= 0)
 		    {
-		    	fd->position += msg->result;
+			updatePosition(msg, file, position + msg->result);
 		    }
 		    break;
 
+		case ReadFileAt:
+		    msg->result = file->read(&io, msg->size, msg->offset);
+		    break;
+
+		case WriteFileAt:
+		    msg->result = file->write(&io, msg->size, msg->offset);
+		    break;
+
 		case CloseFile:
-		    file->close();
-		    msg->result = ESUCCESS;
-		    memset(getFileDescriptor(files, msg->from, msg->fd), 0,
-			   sizeof(FileDescriptor));
+		    pthread_mutex_lock(&filesLock);
+
+		    /* Only the request which clears the descriptor closes the file. */
+		    if ((fd = getFileDescriptor(files, msg->from, msg->fd)) &&
+			fd->identifier == (Address) file)
+		    {
+			memset(fd, 0, sizeof(FileDescriptor));
+			file->close();
+			msg->result = ESUCCESS;
+		    }
+		    else
+			msg->result = EBADF;
+
+		    pthread_mutex_unlock(&filesLock);
+		    break;
+
+		case PollFile:
+		    /* Files in memory or on storage never make us wait. */
+		    msg->result = msg->size & (POLLIN | POLLOUT);
+		    break;
+
+		case StatFileDescriptor:
+		    msg->result = file->status(msg);
 		    break;
 
 		case SeekFile:
 		default:
-		    fd->position = msg->offset;
+		    /* Relative to the current position or the end of the file. */
+		    if (msg->size == SEEK_CUR)
+			msg->offset += position;
+		    else if (msg->size == SEEK_END)
+			msg->offset += file->getSize();
+
+		    /* Offsets before the start of the file are invalid. */
+		    if ((off_t) msg->offset < 0)
+		    {
+			msg->result = EINVAL;
+			break;
+		    }
+		    updatePosition(msg, file, msg->offset);
 		    msg->result  = ESUCCESS;
 		    break;
 	    }
+	    pthread_mutex_unlock(lock);
+
+	    /* The file may have been closed and left the cache meanwhile. */
+	    if (!file->unref() && !file->getOpenCount())
+	    {
+		delete file;
+	    }
 	}
     
     protected:
 
+	/**
+	 * Store the position of a FileDescriptor, unless it was
+	 * closed or reused meanwhile.
+	 * @param msg Request which names the FileDescriptor.
+	 * @param file File which the request used.
+	 * @param position New position.
+	 */
+	void updatePosition(FileSystemMessage *msg, File *file, Size position)
+	{
+	    FileDescriptor *fd;
+
+	    pthread_mutex_lock(&filesLock);
+
+	    if ((fd = getFileDescriptor(files, msg->from, msg->fd)) &&
+		fd->identifier == (Address) file)
+	    {
+		fd->position = position;
+	    }
+	    pthread_mutex_unlock(&filesLock);
+	}
+
 	/**
 	 * @brief Change the filesystem root directory.
 	 *
@@ -505,42 +641,30 @@ class FileSystem : public IPCServer<FileSystem, FileSystemMessage>
 	}
 
 	/**
-	 * Cleans up the entire file cache (except opened file caches and root).
+	 * Cleans up the entire file cache (except root). Files which are
+	 * still opened are deleted when closed.
 	 * @param cache Input FileCache object. ZERO to clean up all from root.
 	 */
 	void clearFileCache(FileCache *cache = ZERO)
 	{
+	    List<String> keys;
+
 	    /* Start from root? */
 	    if (!cache)
 	    {
 		cache = root;
 	    }
-	    /* Mark invalid immediately. */
-	    else
-	        cache->valid = false;
-
-	    /* Walk all our childs. */
+	    /* Release all our childs. */
 	    for (HashIterator<String, FileCache> i(&cache->entries); i.hasNext(); i++)
 	    {
-		/* Traverse subtree if it isn't invalidated yet. */
-		if (i.current()->valid)
-		{
-		    clearFileCache(i.current());
-
-		    /* May we remove reference to this entry? */
-		    if (i.current()->file->getOpenCount() == 0)
-		    
-		    {
-			cache->entries.remove(i.key(), true);
-		    }
-		}
+		clearFileCache(i.current());
+		delete i.current();
+		keys.insertTail(i.key());
 	    }
-	    /* Remove the entry itself, if empty. */
-	    if (!cache->valid && cache->entries.count() == 0 &&
-	         cache->file->getOpenCount() == 0)
+	    /* Then forget them. */
+	    for (ListIterator<String> i(&keys); i.hasNext(); i++)
 	    {
-		delete cache->file;
-		delete cache;
+		cache->entries.remove(i.current(), true);
 	    }
 	}
     
@@ -559,6 +683,12 @@ class FileSystem : public IPCServer<FileSystem, FileSystemMessage>
         /** Per-process File descriptors. */
         Array<Shared<FileDescriptor> > *files;
 
+	/** Protects the file cache and directories. */
+	pthread_mutex_t cacheLock;
+
+	/** Protects the FileDescriptor tables. */
+	pthread_mutex_t filesLock;
+
     private:
     	
 	/** 
@@ -582,6 +712,7 @@ class FileSystem : public IPCServer<FileSystem, FileSystemMessage>
         	    fds->get(i)->mount      = mount;
         	    fds->get(i)->identifier = ident;
         	    fds->get(i)->position   = ZERO;
+        	    fds->get(i)->flags      = ZERO;
         	    return i;
     		}
 	    }
@@ -28,6 +28,18 @@
 
 /**
  * Actions which may be performed on the filesystem.
+ *
+ * PollFile replies with the poll() events in size which are ready on fd.
+ * If none, the server wakes the sender's thread with ProcessCtl once
+ * that may have changed.
+ *
+ * ReadFileAt and WriteFileAt transfer at the given offset, leaving the
+ * position of fd as is.
+ *
+ * SeekFile takes the lseek() whence in size and replies the resulting
+ * position in offset.
+ *
+ * StatFileDescriptor is StatFile for the file opened as fd.
  */
 typedef enum FileSystemAction
 {
@@ -39,6 +51,10 @@ typedef enum FileSystemAction
     StatFile      = 5,
     ChangeFile    = 6,
     CloseFile     = 7,
+    PollFile      = 8,
+    ReadFileAt    = 9,
+    WriteFileAt   = 10,
+    StatFileDescriptor = 11,
 }
 FileSystemAction;
 
@@ -61,6 +77,7 @@ typedef struct FileSystemMessage : public Message
     void operator = (FileSystemMessage *m)
     {
         from        = m->from;
+        thread      = m->thread;
         type        = m->type;
         action      = m->action;
         result      = m->result;
@@ -84,6 +101,7 @@ typedef struct FileSystemMessage : public Message
     bool operator == (FileSystemMessage *m)
     {
 	return this->from   == m->from &&
+	       this->thread == m->thread &&
 	       this->type   == m->type &&
 	       this->action == m->action;
     }
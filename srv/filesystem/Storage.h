@@ -21,6 +21,25 @@
 #include <Types.h>
 #include <Error.h>
 
+/**
+ * One read in a batch passed to Storage::readAsync().
+ */
+typedef struct StorageRequest
+{
+    /** Offset to start reading from. */
+    u64 offset;
+
+    /** Output buffer. */
+    void *buffer;
+
+    /** Number of bytes to read. */
+    Size size;
+
+    /** Bytes read or an error code, EAGAIN while in progress. */
+    Error result;
+}
+StorageRequest;
+
 /**
  * Provides a storage device to build filesystems on top.
  */
@@ -62,6 +81,56 @@ class Storage
 	    return ENOTSUP;
 	}
 
+	/**
+	 * Start a batch of reads.
+	 *
+	 * The reads may complete in any order, each into its own buffer,
+	 * which must stay valid until complete() returns. By default, they are done here,
+	 * one after the other.
+	 *
+	 * @param requests Reads to start.
+	 * @param count Number of requests.
+	 * @return Error code.
+	 */
+	virtual Error readAsync(StorageRequest *requests, Size count)
+	{
+	    for (Size i = 0; i < count; i++)
+	    {
+		requests[i].result = read(requests[i].offset,
+					  requests[i].buffer, requests[i].size);
+	    }
+	    return ESUCCESS;
+	}
+
+	/**
+	 * Wait until a batch started by readAsync() completed.
+	 * @param requests Reads given to readAsync().
+	 * @param count Number of requests.
+	 * @return Error code.
+	 */
+	virtual Error complete(StorageRequest *requests, Size count)
+	{
+	    return ESUCCESS;
+	}
+
+	/**
+	 * Preferred number of bytes in a single read or write.
+	 * @return Size in bytes.
+	 */
+	virtual Size blockSize()
+	{
+	    return 1;
+	}
+
+	/**
+	 * Offsets of reads and writes are best a multiple of this.
+	 * @return Alignment in bytes.
+	 */
+	virtual Size alignment()
+	{
+	    return 1;
+	}
+
 	/**
 	 * Retrieve maximum storage capacity.
 	 * @return Storage capacity.
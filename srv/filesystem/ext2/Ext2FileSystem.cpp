@@ -18,6 +18,7 @@
 #include <File.h>
 #include <BootModule.h> 
 #include <FileStorage.h>
+#include <BlockDeviceStorage.h>
 #include <Directory.h>
 #include <Device.h>
 #include "Ext2FileSystem.h"
@@ -35,13 +36,20 @@ int main(int argc, char **argv)
     Storage *storage = ZERO;
     bool background  = false;
     const char *path = "/";
+    struct stat st;
     
     /* 
      * Mount the given file, or use the default GRUB boot module. 
      */
     if (argc > 3)
     {
-        storage    = new FileStorage(argv[1], atoi(argv[2]));
+        /* Device files take block requests with their own offset. */
+        if (stat(argv[1], &st) == 0 &&
+           (S_ISCHR(st.st_mode) || S_ISBLK(st.st_mode)))
+            storage = new BlockDeviceStorage(argv[1], atoi(argv[2]));
+        else
+            storage = new FileStorage(argv[1], atoi(argv[2]));
+
         background = true;
         path       = argv[3];
     }
@@ -62,6 +70,8 @@ int main(int argc, char **argv)
     {
         Ext2FileSystem server(path, storage);
 
+        server.setWorkers(FILESYSTEM_WORKERS);
+
         if (server.mount(background))
         {
             return server.run();
@@ -92,7 +102,7 @@ Ext2FileSystem::Ext2FileSystem(const char *p, Storage *s)
     /* Verify magic. */
     if (superBlock.magic != EXT2_SUPER_MAGIC)
     {
-	syslog(LOG_ERR, "%x != EXT2_SUPER_MAGIC",
+	syslog(LOG_ERR, "%#x != EXT2_SUPER_MAGIC",
 	     superBlock.magic);
 	exit(EXIT_FAILURE);
     }
@@ -49,8 +49,8 @@ GRUBFileSystem::GRUBFileSystem(const char *path)
     insertFileCache(new PseudoFile("%s", info.cmdline), "cmdline");
     
     /* Memory information. */
-    insertFileCache(new PseudoFile("%x", info.memorySize),  "memory_size");
-    insertFileCache(new PseudoFile("%x", info.memoryAvail), "memory_avail");
+    insertFileCache(new PseudoFile("%#x", info.memorySize),  "memory_size");
+    insertFileCache(new PseudoFile("%#x", info.memoryAvail), "memory_avail");
     
     /* Boot Modules. */
     for (Size i = 0; i < info.moduleCount; i++)
@@ -33,15 +33,25 @@ LinnFile::~LinnFile()
 Error LinnFile::read(IOBuffer *buffer, Size size, Size offset)
 {
     LinnSuperBlock *sb;
-    Size bytes = 0, blockNr = 0;
-    u64 storageOffset, copyOffset = offset;
+    Storage *storage = fs->getStorage();
+    StorageRequest requests[LINN_FILE_BATCH];
+    Size bytes = 0, blockNr = 0, batch, count, want, remain;
+    Size copyOffset = offset;
+    u64 storageOffset;
     u8 *block;
     Size total = 0;
     Error e;
 
     /* Initialize variables. */
     sb     = fs->getSuperBlock();
-    block  = new u8[sb->blockSize];
+    batch  = storage->blockSize() / sb->blockSize;
+
+    /* Fetch as many blocks at once as the Storage likes. */
+    if (batch < 1)
+	batch = 1;
+    if (batch > LINN_FILE_BATCH)
+	batch = LINN_FILE_BATCH;
+    block  = new u8[sb->blockSize * batch];
 
     /* Skip ahead blocks. */
     while ((sb->blockSize * (blockNr + 1)) <= copyOffset)
@@ -55,27 +65,55 @@ Error LinnFile::read(IOBuffer *buffer, Size size, Size offset)
     while (blockNr < LINN_INODE_NUM_BLOCKS(sb, inode) &&
 	   total < size && inode->size - (offset + total) > 0)
     {
-	/* Calculate the offset in storage for this block. */
-	storageOffset = fs->getOffset(inode, blockNr);
+	/* Bytes left to copy, within the inode and the remote buffer. */
+	remain = inode->size - (offset + total);
+	if (remain > size - total)
+	    remain = size - total;
+
+	want = (CEIL(copyOffset + remain, sb->blockSize));
+	if (want > batch)
+	    want = batch;
+	if (want > LINN_INODE_NUM_BLOCKS(sb, inode) - blockNr)
+	    want = LINN_INODE_NUM_BLOCKS(sb, inode) - blockNr;
 
-        /* Fetch the next block. */
-        if (fs->getStorage()->read(storageOffset, block, sb->blockSize) < 0)
+	/* Calculate the offsets in storage, merging adjacent blocks. */
+	for (Size i = count = 0; i < want; i++)
 	{
-	    delete block;
-	    return EIO;
+	    storageOffset = fs->getOffset(inode, blockNr + i);
+
+	    if (count && requests[count - 1].offset +
+			 requests[count - 1].size == storageOffset &&
+		(Size) requests[count - 1].offset % storage->alignment() == 0)
+	    {
+		requests[count - 1].size += sb->blockSize;
+	    }
+	    else
+	    {
+		requests[count].offset = storageOffset;
+		requests[count].buffer = block + sb->blockSize * i;
+		requests[count].size   = sb->blockSize;
+		count++;
+	    }
 	}
-	/* Calculate the number of bytes to copy. */
-	bytes = sb->blockSize - copyOffset;
-	
-	/* Respect the inode size. */
-	if (bytes > inode->size - (offset + total))
+        /* Fetch the blocks. */
+	storage->readAsync(requests, count);
+	storage->complete(requests, count);
+
+	/* Short reads would leave stale bytes in the block. */
+	for (Size i = 0; i < count; i++)
 	{
-	    bytes = inode->size - (offset + total);
+	    if (requests[i].result != (Error) requests[i].size)
+	    {
+		delete block;
+		return EIO;
+	    }
 	}
-	/* Respect the remote process buffer. */
-	if (bytes > size - total)
+	/* Calculate the number of bytes to copy. */
+	bytes = sb->blockSize * want - copyOffset;
+
+	if (bytes > remain)
 	{
-	    bytes = size - total;
+	    bytes = remain;
 	}
         /* Copy into the buffer. */
 	if ((e = buffer->write(block + copyOffset, bytes, total)) < 0)
@@ -86,7 +124,7 @@ Error LinnFile::read(IOBuffer *buffer, Size size, Size offset)
 	/* Update state. */
 	total      += bytes;
 	copyOffset  = 0;
-	blockNr++;
+	blockNr    += want;
     }
     /* Success. */
     delete block;
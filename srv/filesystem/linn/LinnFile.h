@@ -32,6 +32,9 @@
  * @{
  */
 
+/** Most blocks fetched from storage at once by LinnFile::read(). */
+#define LINN_FILE_BATCH 16
+
 /**
  * Represents a file on a mounted LinnFS filesystem.
  */
@@ -54,6 +57,9 @@ class LinnFile : public File
 	/**
 	 * @brief Read out the file.
 	 *
+	 * The blocks are fetched in batches sized after the preferred
+	 * Storage block size, merging blocks which are adjacent in storage.
+	 *
 	 * @param buffer Input/Output buffer to write bytes to.
 	 * @param size Number of bytes to copy at maximum.
 	 * @param offset Offset in the file to start reading.
@@ -17,6 +17,7 @@
 
 #include <Types.h>
 #include <FileStorage.h>
+#include <BlockDeviceStorage.h>
 #include <BootModule.h>
 #include "LinnFileSystem.h"
 #include "LinnInode.h"
@@ -30,13 +31,20 @@ int main(int argc, char **argv)
     Storage *storage = ZERO;
     bool background  = false;
     const char *path = "/";
+    struct stat st;
 
     /*
      * Mount the given file, or use the default GRUB boot module.
      */
     if (argc > 3)
     {
-	storage    = new FileStorage(argv[1], atoi(argv[2]));
+	/* Device files take block requests with their own offset. */
+	if (stat(argv[1], &st) == 0 &&
+	   (S_ISCHR(st.st_mode) || S_ISBLK(st.st_mode)))
+	    storage = new BlockDeviceStorage(argv[1], atoi(argv[2]));
+	else
+	    storage = new FileStorage(argv[1], atoi(argv[2]));
+
 	background = true;
 	path       = argv[3];
     }
@@ -57,6 +65,8 @@ int main(int argc, char **argv)
     {
 	LinnFileSystem server(path, storage);
 	
+	server.setWorkers(FILESYSTEM_WORKERS);
+
 	if (server.mount(background))
 	{
     	    return server.run();
@@ -15,85 +15,112 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <API/IPCMessage.h>
 #include <FreeNOS/Process.h>
-#include <ProcessMessage.h>
-#include <ProcessServer.h>
+#include <UserProcess.h>
 #include <FileSystemPath.h>
+#include <HashIterator.h>
+#include <String.h>
 #include <Error.h>
-#include <PseudoFile.h>
+#include <stdio.h>
+#include <string.h>
 #include "ProcRootDirectory.h"
 #include "ProcFileSystem.h"
-
-char * ProcFileSystem::states[] =
-{
-    "Running",
-    "Ready",
-    "Stopped",
-    "Sleeping",
-};
+#include "ProcessFile.h"
+#include "SystemStatsFile.h"
 
 ProcFileSystem::ProcFileSystem(const char *path)
-    : FileSystem(path)
+    : FileSystem(path), lastGeneration(0), synced(false)
 {
     rootDir = new ProcRootDirectory(this);
     setRoot(rootDir);
+
+    /* Fixed entries. */
+    rootDir->insert(DirectoryFile, ".");
+    rootDir->insert(DirectoryFile, "..");
+    rootDir->insert(RegularFile, "stats");
+    insertFileCache(new SystemStatsFile, "stats");
+
+    /* No processes listed yet. */
+    memset(listed, 0, sizeof(listed));
+    generation.load(USER_PROCESS_GENERATION_KEY, 1);
 }
 
 void ProcFileSystem::refresh()
 {
-    ProcessMessage msg;
-    ProcessID pid = 0;
-    UserProcess uproc;    
-    String slash("/");
+    Size current = *generation.get();
+
+    /* Nothing changed since the last time? */
+    if (synced && current == lastGeneration)
+    {
+	return;
+    }
+    lastGeneration = current;
+    synced = true;
+
+    /* Only update processes which came or went. */
+    for (ProcessID pid = 0; pid < MAX_PROCS; pid++)
+    {
+	bool alive = procs[pid]->command[0] != ZERO;
+
+	if (alive && !listed[pid])
+	    insertProcess(pid);
+
+	else if (!alive && listed[pid])
+	    removeProcess(pid);
+    }
+}
+
+void ProcFileSystem::insertProcess(ProcessID pid)
+{
     Directory *procDir;
 
-    /* Clear the current cache. */
-    clearFileCache();
-    
-    /* Update root. */
-    rootDir->insert(DirectoryFile, ".");
-    rootDir->insert(DirectoryFile, "..");
-    
-    /* Reinsert into the cache. */
-    insertFileCache(rootDir, ".");
-    insertFileCache(rootDir, "..");
+    /* Per-process directory. */
+    procDir = new Directory;
+    procDir->insert(DirectoryFile, ".");
+    procDir->insert(DirectoryFile, "..");
+    procDir->insert(RegularFile, "cmdline");
+    procDir->insert(RegularFile, "status");
+    procDir->insert(RegularFile, "stats");
+    rootDir->insert(DirectoryFile, "%u", pid);
+
+    /* Insert into the cache. */
+    insertFileCache(procDir, "%u",    pid);
+    insertFileCache(procDir, "%u/.",  pid);
+    insertFileCache(rootDir, "%u/..", pid);
+
+    /* Contents are generated when read. */
+    insertFileCache(new ProcessFile(pid, procs[pid], ProcessCommand),
+		    "%u/cmdline", pid);
+    insertFileCache(new ProcessFile(pid, procs[pid], ProcessStatus),
+		    "%u/status",  pid);
+    insertFileCache(new ProcessFile(pid, procs[pid], ProcessStatistics),
+		    "%u/stats",   pid);
+    listed[pid] = true;
+}
+
+void ProcFileSystem::removeProcess(ProcessID pid)
+{
+    char name[16];
+    FileCache *dir;
+
+    snprintf(name, sizeof(name), "%u", pid);
+    String key(name);
+
+    /* Remove the directory entry. */
+    rootDir->remove(name);
+    listed[pid] = false;
+
+    if (!(dir = findFileCache(name)))
+    {
+	return;
+    }
+    root->entries.remove(&key, true);
 
-    /* Read processes from process server. */
-    while (true)
+    /* Files still opened elsewhere are deleted on their last close. */
+    for (HashIterator<String, FileCache> i(&dir->entries); i.hasNext(); i++)
     {
-	/* Fill message. */
-        msg.action = ReadProcess;
-        msg.buffer = &uproc;
-	msg.number = pid;
-
-	/* Read next process. */
-	if (IPCMessage(PROCSRV_PID, SendReceive, &msg, sizeof(msg)) || msg.result)
-	{
-	    break;
-	}
-	/* Per-process directory. */
-	procDir = new Directory;
-        procDir->insert(DirectoryFile, ".");
-        procDir->insert(DirectoryFile, "..");
-        procDir->insert(RegularFile, "cmdline");
-        procDir->insert(RegularFile, "status");
-        rootDir->insert(DirectoryFile, "%u", msg.number);
-
-	/* Reinsert into the cache. */
-	insertFileCache(procDir, "%u",    msg.number);
-	insertFileCache(procDir, "%u/.",  msg.number);
-	insertFileCache(rootDir, "%u/..", msg.number);
-
-	/* Command line string. */
-	insertFileCache(new PseudoFile("%s", uproc.command),
-			"%u/cmdline", msg.number);
-	
-	/* Process status. */
-	insertFileCache(new PseudoFile("%s", states[uproc.state]),
-		        "%u/status",  msg.number);
-	
-	/* Move to next PID. */
-	pid = msg.number + 1;
-    }    
+	delete i.current();
+	delete i.key();
+    }
+    delete dir;
 }
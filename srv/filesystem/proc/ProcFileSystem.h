@@ -21,6 +21,8 @@
 #include <File.h>
 #include <FileSystem.h>
 #include <FileSystemMessage.h>
+#include <FreeNOS/Process.h>
+#include <Shared.h>
 #include <Types.h>
 #include <Error.h>
 #include "ProcRootDirectory.h"
@@ -35,6 +37,10 @@ class ProcRootDirectory;
 
 /**
  * Process filesystem (procfs). Maps processes into a pseudo filesystem.
+ *
+ * The tree is kept between listings. Only processes created or
+ * terminated since the last listing are added or removed, which the
+ * ProcessServer signals by bumping a shared generation counter.
  */
 class ProcFileSystem : public FileSystem
 {
@@ -47,17 +53,38 @@ class ProcFileSystem : public FileSystem
 	ProcFileSystem(const char *path);
 
 	/**
-	 * Refreshes the entire process file tree.
+	 * Brings the process file tree up to date with the process table.
 	 */
 	void refresh();
 
     private:
-	
-	/** String representation of process states. */
-	static char *states[];
+
+	/**
+	 * Add the directory of a process.
+	 * @param pid Process to add.
+	 */
+	void insertProcess(ProcessID pid);
+
+	/**
+	 * Remove the directory of a terminated process.
+	 * @param pid Process to remove.
+	 */
+	void removeProcess(ProcessID pid);
 	
 	/** Root of the process filesystem. */
 	ProcRootDirectory *rootDir;
+
+	/** Process table generation counter, updated by the ProcessServer. */
+	Shared<Size> generation;
+
+	/** Generation of the process table at the last refresh. */
+	Size lastGeneration;
+
+	/** Set once the first refresh is done. */
+	bool synced;
+
+	/** Processes which currently have a directory. */
+	bool listed[MAX_PROCS];
 };
 
 /**
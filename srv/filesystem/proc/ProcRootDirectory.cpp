@@ -26,7 +26,6 @@ ProcRootDirectory::ProcRootDirectory(ProcFileSystem *p)
 
 Error ProcRootDirectory::read(IOBuffer *buffer, Size size, Size offset)
 {
-    clear();
     proc->refresh();
     return Directory::read(buffer, size, offset);
 }
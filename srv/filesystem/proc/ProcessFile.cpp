@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/ProcessCtl.h>
+#include <stdio.h>
+#include "ProcessFile.h"
+
+const char * ProcessFile::states[] =
+{
+    "Running",
+    "Ready",
+    "Stopped",
+    "Sleeping",
+    "Exited",
+};
+
+ProcessFile::ProcessFile(ProcessID p, UserProcess *e, ProcessFileField f)
+    : pid(p), entry(e), field(f)
+{
+    access = OwnerR;
+}
+
+Error ProcessFile::read(IOBuffer *buffer, Size size, Size offset)
+{
+    ProcessInfo info;
+    ProcessStats stats;
+    char buf[256];
+    Size bytes = 0;
+    Error e;
+
+    /* Generate the contents. */
+    switch (field)
+    {
+	case ProcessCommand:
+	    bytes = snprintf(buf, sizeof(buf), "%s", entry->command);
+	    break;
+
+	case ProcessStatus:
+	    if ((e = ProcessCtl(pid, InfoPID, (Address) &info)) != 0)
+	    {
+		return e;
+	    }
+	    bytes = snprintf(buf, sizeof(buf), "%s", states[info.state]);
+	    break;
+
+	case ProcessStatistics:
+	    if ((e = ProcessCtl(pid, StatsPID, (Address) &stats)) != 0)
+	    {
+		return e;
+	    }
+	    bytes = snprintf(buf, sizeof(buf),
+			     "voluntary_switches   %llu\r\n"
+			     "involuntary_switches %llu\r\n"
+			     "ticks                %llu\r\n"
+			     "messages_sent        %llu\r\n"
+			     "messages_received    %llu\r\n"
+			     "copy_bytes           %llu\r\n"
+			     "page_faults          %llu\r\n",
+			      stats.voluntarySwitches, stats.involuntarySwitches,
+			      stats.ticks, stats.messagesSent,
+			      stats.messagesReceived, stats.copyBytes,
+			      stats.pageFaults);
+	    break;
+    }
+    /* Bounds checking. */
+    if (offset >= bytes)
+    {
+	return 0;
+    }
+    /* How much bytes to copy? */
+    if (bytes - offset < size)
+	size = bytes - offset;
+
+    /* Copy the buffers. */
+    return buffer->write(buf + offset, size);
+}
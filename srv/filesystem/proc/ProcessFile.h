@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FILESYSTEM_PROCESSFILE_H
+#define __FILESYSTEM_PROCESSFILE_H
+
+#include <File.h>
+#include <IOBuffer.h>
+#include <UserProcess.h>
+#include <Types.h>
+#include <Error.h>
+
+/** 
+ * @defgroup procfs procfs (Process Filesystem) 
+ * @{ 
+ */
+
+/**
+ * Contents of a ProcessFile.
+ */
+typedef enum ProcessFileField
+{
+    ProcessCommand    = 0,
+    ProcessStatus     = 1,
+    ProcessStatistics = 2,
+}
+ProcessFileField;
+
+/**
+ * @brief Describes a single property of a process.
+ *
+ * The contents are generated each time the file is read, from the
+ * user process table or by asking the kernel. Nothing is stored.
+ */
+class ProcessFile : public File
+{
+    public:
+
+	/**
+	 * @brief Constructor function.
+	 * @param pid Process to report on.
+	 * @param entry Entry of the process in the user process table.
+	 * @param field Property of the process to report.
+	 */
+	ProcessFile(ProcessID pid, UserProcess *entry, ProcessFileField field);
+
+        /** 
+         * @brief Read bytes from the file. 
+	 *
+         * @param buffer Output buffer. 
+         * @param size Number of bytes to read, at maximum. 
+         * @param offset Offset inside the file to start reading. 
+         * @return Number of bytes read on success, Error on failure. 
+	 *
+	 * @see IOBuffer
+         */
+        Error read(IOBuffer *buffer, Size size, Size offset);
+
+    private:
+
+	/** @brief String representation of process states. */
+	static const char *states[];
+
+	/** @brief Process to report on. */
+	ProcessID pid;
+
+	/** @brief Entry in the user process table. */
+	UserProcess *entry;
+
+	/** @brief Property to report. */
+	ProcessFileField field;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __FILESYSTEM_PROCESSFILE_H */
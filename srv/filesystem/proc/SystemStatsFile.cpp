@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/SystemInfo.h>
+#include <stdio.h>
+#include "SystemStatsFile.h"
+
+const char * SystemStatsFile::names[] =
+{
+    ZERO,
+    "IPCMessage",
+    "VMCopy",
+    "PrivExec",
+    "ProcessCtl",
+    "VMCtl",
+    "SystemInfo",
+    "ThreadCtl",
+};
+
+SystemStatsFile::SystemStatsFile()
+{
+    access = OwnerR;
+}
+
+Error SystemStatsFile::read(IOBuffer *buffer, Size size, Size offset)
+{
+    SystemInformation info;
+    char buf[1024];
+    Size bytes;
+
+    /* Header. */
+    bytes = snprintf(buf, sizeof(buf), "%-12s %12s %20s\r\n",
+		     "API", "CALLS", "CYCLES");
+
+    /* One line per system call in use. */
+    for (Size i = 0; i < MAX_APIS; i++)
+    {
+	if (!info.apiStats[i].calls)
+	    continue;
+
+	if (i < sizeof(names) / sizeof(names[0]) && names[i])
+	    bytes += snprintf(buf + bytes, sizeof(buf) - bytes, "%-12s ",
+			      names[i]);
+	else
+	    bytes += snprintf(buf + bytes, sizeof(buf) - bytes, "%-12u ", i);
+
+	bytes += snprintf(buf + bytes, sizeof(buf) - bytes, "%12llu %20llu\r\n",
+			  info.apiStats[i].calls, info.apiStats[i].cycles);
+    }
+    /* Pool of cleared pages. */
+    bytes += snprintf(buf + bytes, sizeof(buf) - bytes,
+		      "\r\nZEROPOOL %u pages, %u hits, %u misses\r\n",
+		      info.zeroPool.count, info.zeroPool.hits,
+		      info.zeroPool.misses);
+
+    /* Kernel heap. */
+    bytes += snprintf(buf + bytes, sizeof(buf) - bytes,
+		      "HEAP     %u pages, %u objects, %u bytes\r\n",
+		      info.heap.pages, info.heap.objects, info.heap.bytes);
+
+    /* Processor cores. */
+    bytes += snprintf(buf + bytes, sizeof(buf) - bytes,
+		      "CORES    %u\r\n", info.coreCount);
+
+    /* Bounds checking. */
+    if (offset >= bytes)
+    {
+	return 0;
+    }
+    /* How much bytes to copy? */
+    if (bytes - offset < size)
+	size = bytes - offset;
+
+    /* Copy the buffers. */
+    return buffer->write(buf + offset, size);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FILESYSTEM_SYSTEMSTATSFILE_H
+#define __FILESYSTEM_SYSTEMSTATSFILE_H
+
+#include <File.h>
+#include <IOBuffer.h>
+#include <Types.h>
+#include <Error.h>
+
+/** 
+ * @defgroup procfs procfs (Process Filesystem) 
+ * @{ 
+ */
+
+/**
+ * @brief System wide performance counters.
+ *
+ * Lists the number of calls and the cycles spent per system call,
+ * as reported by SystemInfo() at the time of reading.
+ *
+ * @see APIStats
+ */
+class SystemStatsFile : public File
+{
+    public:
+
+	/**
+	 * @brief Constructor function.
+	 */
+	SystemStatsFile();
+
+        /** 
+         * @brief Read bytes from the file. 
+	 *
+         * @param buffer Output buffer. 
+         * @param size Number of bytes to read, at maximum. 
+         * @param offset Offset inside the file to start reading. 
+         * @return Number of bytes read on success, Error on failure. 
+	 *
+	 * @see IOBuffer
+         */
+        Error read(IOBuffer *buffer, Size size, Size offset);
+
+    private:
+
+	/** @brief Names of the system calls, by number. */
+	static const char *names[];
+};
+
+/**
+ * @}
+ */
+
+#endif /* __FILESYSTEM_SYSTEMSTATSFILE_H */
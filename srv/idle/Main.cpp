@@ -16,8 +16,29 @@
  */
 
 #include <API/PrivExec.h>
+#include <API/SystemInfo.h>
+#include <pthread.h>
+
+/**
+ * Become the idle process of a processor core.
+ * @param arg Not used.
+ * @return Never.
+ */
+static void * idleThread(void *arg)
+{
+    PrivExec(Idle);
+    return ZERO;
+}
 
 int main(int argc, char **argv)
 {
+    SystemInformation info;
+    pthread_t thread;
+
+    /* One idle thread for every other core. */
+    for (Size i = 1; i < info.coreCount; i++)
+    {
+        pthread_create(&thread, ZERO, idleThread, ZERO);
+    }
     return PrivExec(Idle);
 }
@@ -44,7 +44,7 @@ const char Keyboard::keymap[0x3a][2] =
     /*38*/{0x0, 0x0}, {' ', ' '}
 };
 
-Keyboard::Keyboard() : shiftState(ZERO)
+Keyboard::Keyboard() : shiftState(ZERO), key(ZERO), pending(false)
 {
 }
 
@@ -55,7 +55,23 @@ Error Keyboard::initialize()
 
 Error Keyboard::interrupt(Size vector)
 {
-    pending = true;
+    /*
+     * Read byte from the keyboard.
+     */
+    u8 keycode = inb(PS2_PORT);
+
+    /* Update shift state. */
+    if (keycode == 0x2a || keycode == 0xaa)
+    {
+	shiftState ^= 1;
+    }
+    /* Don't do anything on release. */
+    else if (!(keycode & PS2_RELEASE) &&
+	      (keymap[keycode & 0x7f][shiftState]))
+    {
+	key     = keymap[keycode & 0x7f][shiftState];
+	pending = true;
+    }
     return ESUCCESS;
 }
 
@@ -64,26 +80,14 @@ Error Keyboard::read(s8 *buffer, Size size, Size offset)
     /* Do we have any new key events? */
     if (pending)
     {
-	pending = false;
-    
-	/*
-         * Read byte from the keyboard.
-         */
-        u8 keycode = inb(PS2_PORT);
-
-        /* Update shift state. */
-        if (keycode == 0x2a || keycode == 0xaa)
-        {
-    	    shiftState ^= 1;
-	}
-        /* Don't do anything on release. */
-	else if (!(keycode & PS2_RELEASE) &&
-	          (keymap[keycode & 0x7f][shiftState]))
-	{
-	    /* Write to buffer. */
-	    buffer[0] = keymap[keycode & 0x7f][shiftState];
-    	    return 1;
-	}
+	pending   = false;
+	buffer[0] = key;
+	return 1;
     }
     return EAGAIN;
 }
+
+short Keyboard::poll()
+{
+    return pending ? POLLIN : 0;
+}
@@ -72,6 +72,12 @@ class Keyboard : public Device
 	 */
 	Error read(s8 *buffer, Size size, Size offset);
 
+	/**
+	 * @brief Check for a character.
+	 * @return POLLIN if a character can be read, zero otherwise.
+	 */
+	short poll();
+
     private:
 
 	/**
@@ -86,7 +92,10 @@ class Keyboard : public Device
 	 */
 	u8 shiftState;
 	
-	/** Do we have a byte ready? */
+	/** Character typed, if pending. */
+	char key;
+
+	/** Do we have a character ready? */
 	bool pending;
 };
 
@@ -42,7 +42,7 @@ void MemoryServer::createPrivate(MemoryMessage *msg)
     }
     /* Set mapping flags. */
     // TODO: only allow pinned pages for uid == 0!
-    msg->protection &= PAGE_PINNED  | PAGE_RESERVED | PAGE_RW;
+    msg->protection &= PAGE_PINNED  | PAGE_RESERVED | PAGE_RW | PAGE_LAZY;
     msg->protection |= PAGE_PRESENT | PAGE_USER;
     
     /* Try to map the range. */
@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryAreaTree.h"
+
+/**
+ * Height of a (possibly empty) subtree.
+ */
+#define HEIGHT(n) ((n) ? (n)->height : 0)
+
+MemoryAreaTree::MemoryAreaTree()
+    : root(ZERO), complete(false)
+{
+}
+
+MemoryAreaTree::~MemoryAreaTree()
+{
+    destroy(root);
+}
+
+void MemoryAreaTree::insert(Address start, Size size, MemoryAreaType type)
+{
+    Address last = start + size - 1;
+    MemoryArea *area;
+
+    /* Merge with any overlapping areas. */
+    while ((area = findFirst(start, last)))
+    {
+	/* Reservations already cover everything inside them. */
+	if (area->type == ReservedArea &&
+	    area->start <= start && area->last >= last)
+	{
+	    return;
+	}
+	if (area->start < start) start = area->start;
+	if (area->last  > last)  last  = area->last;
+	if (area->type == ReservedArea) type = ReservedArea;
+
+	root = removeNode(root, area->start);
+    }
+    add(start, last, type);
+}
+
+void MemoryAreaTree::release(Address start, Size size)
+{
+    Address last = start + size - 1, from = start, areaStart, areaLast;
+    MemoryAreaType type;
+    MemoryArea *area;
+
+    /* Walk all overlapping areas, in order. */
+    while ((area = findFirst(from, last)))
+    {
+	areaStart = area->start;
+	areaLast  = area->last;
+	type      = area->type;
+
+	/* Reserved areas stay, regardless of what is mapped inside. */
+	if (type != ReservedArea)
+	{
+	    root = removeNode(root, areaStart);
+
+	    /* Keep the parts outside the released range. */
+	    if (areaStart < start)
+		add(areaStart, start - 1, type);
+
+	    if (areaLast > last)
+		add(last + 1, areaLast, type);
+	}
+	if (areaLast >= last)
+	    break;
+
+	from = areaLast + 1;
+    }
+}
+
+Address MemoryAreaTree::findFree(Size size, Address low, Address high)
+{
+    return size ? search(root, low, high, size) : ZERO;
+}
+
+void MemoryAreaTree::clear()
+{
+    destroy(root);
+    root     = ZERO;
+    complete = false;
+}
+
+bool MemoryAreaTree::isComplete() const
+{
+    return complete;
+}
+
+void MemoryAreaTree::setComplete()
+{
+    complete = true;
+}
+
+MemoryArea * MemoryAreaTree::findFirst(Address start, Address last)
+{
+    MemoryArea *node = root, *found = ZERO;
+
+    /* Find the lowest area which ends at or after start. */
+    while (node)
+    {
+	if (node->last >= start)
+	{
+	    found = node;
+	    node  = node->left;
+	}
+	else
+	    node = node->right;
+    }
+    /* It must also begin before the end of the range. */
+    return found && found->start <= last ? found : ZERO;
+}
+
+void MemoryAreaTree::add(Address start, Address last, MemoryAreaType type)
+{
+    MemoryArea *area = new MemoryArea;
+
+    area->start  = start;
+    area->last   = last;
+    area->type   = type;
+    area->left   = ZERO;
+    area->right  = ZERO;
+    update(area);
+
+    root = insertNode(root, area);
+}
+
+Address MemoryAreaTree::search(MemoryArea *node, Address low,
+			       Address high, Size size)
+{
+    Address found, after;
+
+    /* Is the given interval large enough at all? */
+    if (low > high || high - low < size - 1)
+    {
+	return ZERO;
+    }
+    /* Nothing in the way. */
+    if (!node)
+    {
+	return low;
+    }
+    /* Hole before the first area of this subtree. */
+    if (node->low > low && node->low - low >= size)
+    {
+	return low;
+    }
+    /* Skip subtrees without a large enough hole inside or behind them. */
+    after = node->high >= low ? node->high + 1 : low;
+
+    if (node->gap < size &&
+       (node->high >= high || high - after < size - 1))
+    {
+	return ZERO;
+    }
+    /* Try below this area first, then above it. */
+    if (node->start > low &&
+       (found = search(node->left, low,
+		       node->start - 1 < high ? node->start - 1 : high, size)))
+    {
+	return found;
+    }
+    if (node->last >= high)
+    {
+	return ZERO;
+    }
+    return search(node->right, node->last >= low ? node->last + 1 : low,
+		  high, size);
+}
+
+MemoryArea * MemoryAreaTree::insertNode(MemoryArea *node, MemoryArea *area)
+{
+    if (!node)
+	return area;
+
+    if (area->start < node->start)
+	node->left  = insertNode(node->left, area);
+    else
+	node->right = insertNode(node->right, area);
+
+    return balance(node);
+}
+
+MemoryArea * MemoryAreaTree::removeNode(MemoryArea *node, Address start)
+{
+    MemoryArea *next;
+
+    if (!node)
+	return ZERO;
+
+    if (start < node->start)
+	node->left  = removeNode(node->left, start);
+    else if (start > node->start)
+	node->right = removeNode(node->right, start);
+
+    /* Unlink areas with at most one child directly. */
+    else if (!node->left || !node->right)
+    {
+	next = node->left ? node->left : node->right;
+	delete node;
+	return next;
+    }
+    /* Otherwise, take over the next area and remove that one instead. */
+    else
+    {
+	for (next = node->right; next->left; next = next->left)
+	    ;
+	node->start = next->start;
+	node->last  = next->last;
+	node->type  = next->type;
+	node->right = removeNode(node->right, next->start);
+    }
+    return balance(node);
+}
+
+MemoryArea * MemoryAreaTree::balance(MemoryArea *node)
+{
+    update(node);
+
+    /* Left side too high? */
+    if (HEIGHT(node->left) > HEIGHT(node->right) + 1)
+    {
+	if (HEIGHT(node->left->left) < HEIGHT(node->left->right))
+	    node->left = rotateLeft(node->left);
+
+	return rotateRight(node);
+    }
+    /* Right side too high? */
+    if (HEIGHT(node->right) > HEIGHT(node->left) + 1)
+    {
+	if (HEIGHT(node->right->right) < HEIGHT(node->right->left))
+	    node->right = rotateRight(node->right);
+
+	return rotateLeft(node);
+    }
+    return node;
+}
+
+MemoryArea * MemoryAreaTree::rotateLeft(MemoryArea *node)
+{
+    MemoryArea *top = node->right;
+
+    node->right = top->left;
+    top->left   = node;
+    update(node);
+    update(top);
+
+    return top;
+}
+
+MemoryArea * MemoryAreaTree::rotateRight(MemoryArea *node)
+{
+    MemoryArea *top = node->left;
+
+    node->left = top->right;
+    top->right = node;
+    update(node);
+    update(top);
+
+    return top;
+}
+
+void MemoryAreaTree::update(MemoryArea *node)
+{
+    Size left = HEIGHT(node->left), right = HEIGHT(node->right);
+
+    node->height = (left > right ? left : right) + 1;
+    node->low    = node->left  ? node->left->low   : node->start;
+    node->high   = node->right ? node->right->high : node->last;
+    node->gap    = 0;
+
+    /* Holes between the subtrees and this area. */
+    if (node->left)
+    {
+	node->gap = node->left->gap;
+
+	if (node->start - node->left->high - 1 > node->gap)
+	    node->gap = node->start - node->left->high - 1;
+    }
+    if (node->right)
+    {
+	if (node->right->gap > node->gap)
+	    node->gap = node->right->gap;
+
+	if (node->right->low - node->last - 1 > node->gap)
+	    node->gap = node->right->low - node->last - 1;
+    }
+}
+
+void MemoryAreaTree::destroy(MemoryArea *node)
+{
+    if (node)
+    {
+	destroy(node->left);
+	destroy(node->right);
+	delete node;
+    }
+}
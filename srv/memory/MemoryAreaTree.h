@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __MEMORY_MEMORY_AREA_TREE_H
+#define __MEMORY_MEMORY_AREA_TREE_H
+
+#include <Types.h>
+#include <Macros.h>
+
+/**
+ * @addtogroup memory
+ * @{
+ */
+
+/**
+ * Kinds of virtual memory areas.
+ */
+typedef enum MemoryAreaType
+{
+    /** Found in the page tables, origin unknown. */
+    MappedArea   = 0,
+
+    /** Created with CreatePrivate. */
+    PrivateArea  = 1,
+
+    /** Created with CreatePrivate, using pinned pages. */
+    PinnedArea   = 2,
+
+    /** Created with CreateShared. */
+    SharedArea   = 3,
+
+    /** Reserved with ReservePrivate, e.g. the heap. */
+    ReservedArea = 4,
+}
+MemoryAreaType;
+
+/**
+ * Describes a range of virtual memory in use by a process.
+ */
+typedef struct MemoryArea
+{
+    /** First virtual address of the area. */
+    Address start;
+
+    /** Last virtual address of the area (inclusive). */
+    Address last;
+
+    /** Kind of area. */
+    MemoryAreaType type;
+
+    /** Areas below and above this one. */
+    MemoryArea *left, *right;
+
+    /** Height of the subtree rooted at this area. */
+    Size height;
+
+    /** Lowest and highest address covered by the subtree. */
+    Address low, high;
+
+    /** Largest hole between two areas inside the subtree. */
+    Size gap;
+}
+MemoryArea;
+
+/**
+ * Balanced tree of the virtual memory areas of a single process.
+ *
+ * Areas never overlap. Each node keeps track of the largest hole
+ * in its subtree, which allows a first-fit search for free virtual
+ * memory in O(log n), instead of scanning the page tables.
+ */
+class MemoryAreaTree
+{
+    public:
+
+	/**
+	 * Constructor function.
+	 */
+	MemoryAreaTree();
+
+	/**
+	 * Destructor function.
+	 */
+	~MemoryAreaTree();
+
+	/**
+	 * Add an area. Overlapping areas are merged into it.
+	 * @param start First virtual address.
+	 * @param size Number of bytes.
+	 * @param type Kind of area.
+	 */
+	void insert(Address start, Size size, MemoryAreaType type);
+
+	/**
+	 * Remove a range from all areas, except reserved areas.
+	 * @param start First virtual address.
+	 * @param size Number of bytes.
+	 */
+	void release(Address start, Size size);
+
+	/**
+	 * Find the lowest free range of the given size.
+	 * @param size Number of bytes needed.
+	 * @param low Lowest acceptable virtual address.
+	 * @param high Highest acceptable virtual address (inclusive).
+	 * @return Virtual start address if found, ZERO otherwise.
+	 */
+	Address findFree(Size size, Address low, Address high);
+
+	/**
+	 * Remove all areas.
+	 */
+	void clear();
+
+	/**
+	 * Check if the tree describes the whole address space.
+	 * @return True if complete, false if it must be rebuilt.
+	 */
+	bool isComplete() const;
+
+	/**
+	 * Mark the tree complete.
+	 */
+	void setComplete();
+
+    private:
+
+	/**
+	 * Find the lowest area which overlaps the given range.
+	 * @param start First virtual address.
+	 * @param last Last virtual address (inclusive).
+	 * @return Pointer to the area if found, ZERO otherwise.
+	 */
+	MemoryArea * findFirst(Address start, Address last);
+
+	/**
+	 * Allocate and link a new area.
+	 * @param start First virtual address.
+	 * @param last Last virtual address (inclusive).
+	 * @param type Kind of area.
+	 */
+	void add(Address start, Address last, MemoryAreaType type);
+
+	/**
+	 * Search a subtree for a free range.
+	 * @param node Subtree to search.
+	 * @param low Lowest acceptable virtual address.
+	 * @param high Highest acceptable virtual address (inclusive).
+	 * @param size Number of bytes needed.
+	 * @return Virtual start address if found, ZERO otherwise.
+	 */
+	static Address search(MemoryArea *node, Address low,
+			      Address high, Size size);
+
+	/**
+	 * Insert an area into a subtree.
+	 * @return New root of the subtree.
+	 */
+	static MemoryArea * insertNode(MemoryArea *node, MemoryArea *area);
+
+	/**
+	 * Remove the area starting at the given address from a subtree.
+	 * @return New root of the subtree.
+	 */
+	static MemoryArea * removeNode(MemoryArea *node, Address start);
+
+	/**
+	 * Restore the balance of a subtree.
+	 * @return New root of the subtree.
+	 */
+	static MemoryArea * balance(MemoryArea *node);
+
+	/**
+	 * Rotate a subtree to the left.
+	 * @return New root of the subtree.
+	 */
+	static MemoryArea * rotateLeft(MemoryArea *node);
+
+	/**
+	 * Rotate a subtree to the right.
+	 * @return New root of the subtree.
+	 */
+	static MemoryArea * rotateRight(MemoryArea *node);
+
+	/**
+	 * Recalculate the height, bounds and largest hole of an area.
+	 * @param node Area to update.
+	 */
+	static void update(MemoryArea *node);
+
+	/**
+	 * Release all areas in a subtree.
+	 * @param node Subtree to release.
+	 */
+	static void destroy(MemoryArea *node);
+
+	/** Root of the tree. */
+	MemoryArea *root;
+
+	/** Set if all areas of the process are known. */
+	bool complete;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __MEMORY_MEMORY_AREA_TREE_H */
@@ -49,6 +49,9 @@ typedef enum MemoryAction
     /* Diagnostics. */
     SystemMemory   = 12,
     ProcessMemory  = 13,
+
+    /* Process management. */
+    ResetProcess   = 14,
 }
 MemoryAction;
 
@@ -74,6 +77,9 @@ typedef struct MemoryMessage : public Message, public MemoryRange
     
     /** Indicates if a shared mapping is newly created, or reused. */
     bool created;
+
+    /** Process to act upon, for ResetProcess. */
+    ProcessID processID;
 }
 MemoryMessage;
 
@@ -34,7 +34,14 @@ MemoryServer::MemoryServer()
     addIPCHandler(ReleasePrivate, &MemoryServer::releasePrivate);
     addIPCHandler(CreateShared,   &MemoryServer::createShared);
     addIPCHandler(SystemMemory,   &MemoryServer::systemMemory);
-    
+    addIPCHandler(ResetProcess,   &MemoryServer::resetProcess);
+
+    /* Allocate per-process memory area trees. */
+    areas = new MemoryAreaTree[MAX_PROCS];
+
+    /* Keep our own mappings out of the way of the heap. */
+    getAreas(SELF)->insert(VMCTL_ALLOC_START, MEMSRV_HEAP_SIZE, ReservedArea);
+
     /* Allocate a user process table. */
     insertShared(SELF, USER_PROCESS_KEY,
 		 sizeof(UserProcess) * MAX_PROCS, &range);
@@ -68,7 +75,7 @@ MemoryServer::MemoryServer()
 	    range.physicalAddress = info.modules[i].modStart;
 	    range.protection      = PAGE_PRESENT | PAGE_USER;
 	    range.bytes           = PAGESIZE * 2;
-	    VMCtl(SELF, Map, &range);
+	    insertMapping(SELF, &range);
 	    
 	    image = (BootImage *) range.virtualAddress;
 	    break;
@@ -96,55 +103,64 @@ MemoryServer::MemoryServer()
 
 Address MemoryServer::findFreeRange(ProcessID procID, Size size)
 {
+    return getAreas(procID)->findFree(size, FREE_RANGE_LOW, FREE_RANGE_HIGH);
+}
+
+MemoryAreaTree * MemoryServer::getAreas(ProcessID procID)
+{
+    MemoryAreaTree *tree = &areas[procID == SELF ? MEMSRV_PID : procID];
     Address *pageDir, *pageTab, vaddr, vbegin;
 
+    /* Only build the tree once per process. */
+    if (tree->isComplete())
+    {
+	return tree;
+    }
     /* Initialize variables. */
-    vbegin  = ZERO;
-    vaddr   = 1024 * 1024 * 16;
     pageDir = PAGETABADDR_FROM(PAGETABFROM, PAGEUSERFROM);
-    pageTab = PAGETABADDR_FROM(vaddr, PAGEUSERFROM);
 
     /* Map page tables. */
     VMCtl(procID, MapTables);
 
-    /* Scan tables. */
-    for (Size inc = PAGESIZE; DIRENTRY(vaddr) < PAGEDIR_MAX ; vaddr += inc)
+    /* Collect everything mapped or reserved so far. */
+    for (Size i = DIRENTRY(FREE_RANGE_LOW); i < PAGEDIR_MAX; i++)
     {
-	/* Is the hole big enough? */
-	if (vbegin && vaddr - vbegin >= size)
+	vaddr = i * PAGETAB_MAX * PAGESIZE;
+
+	/* Reserved and large entries cover the whole page table. */
+	if (pageDir[i] & (PAGE_RESERVED | PAGE_LARGE))
 	{
-	    break;
+	    tree->insert(vaddr, PAGETAB_MAX * PAGESIZE,
+			 pageDir[i] & PAGE_RESERVED ? ReservedArea : MappedArea);
+	    continue;
 	}
-	/* Increment per page table. */
-	inc = PAGETAB_MAX * PAGESIZE;
-	
-	/* Try the current address. */
-	if (pageDir[DIRENTRY(vaddr)] & PAGE_RESERVED)
+	else if (!(pageDir[i] & PAGE_PRESENT))
 	{
-	    vbegin = ZERO; continue;
+	    continue;
 	}
-	else if (pageDir[DIRENTRY(vaddr)] & PAGE_PRESENT)
+	/* Add runs of present and demand-zero pages. */
+	pageTab = PAGETABADDR_FROM(vaddr, PAGEUSERFROM);
+	vbegin  = ZERO;
+
+	for (Size j = 0; j <= PAGETAB_MAX; j++)
 	{
-	    /* Look further into the page table. */
-	    inc     = PAGESIZE;
-	    pageTab = PAGETABADDR_FROM(vaddr, PAGEUSERFROM);
-	
-	    if (pageTab[TABENTRY(vaddr)] & PAGE_PRESENT)
+	    if (j < PAGETAB_MAX && (pageTab[j] & (PAGE_PRESENT | PAGE_LAZY)))
 	    {
-		vbegin = ZERO; continue;
+		if (!vbegin) vbegin = vaddr + (j * PAGESIZE);
+	    }
+	    else if (vbegin)
+	    {
+		tree->insert(vbegin, vaddr + (j * PAGESIZE) - vbegin, MappedArea);
+		vbegin = ZERO;
 	    }
-	}
-	/* Reset start address if needed. */
-	if (!vbegin)
-	{
-	    vbegin = vaddr;
 	}
     }
     /* Clean up. */
     VMCtl(procID, UnMapTables);
-    
+    tree->setComplete();
+
     /* Done. */
-    return vbegin;
+    return tree;
 }
 
 Error MemoryServer::insertMapping(ProcessID procID, MemoryRange *range)
@@ -166,6 +182,11 @@ Error MemoryServer::insertMapping(ProcessID procID, MemoryRange *range)
     {
         return result;
     }
+    /* Remember the new area. */
+    getAreas(procID)->insert(range->virtualAddress,
+			     (range->bytes + PAGESIZE - 1) & PAGEMASK,
+			     range->protection & PAGE_PINNED ?
+			     PinnedArea : PrivateArea);
     /* Done! */
     return ESUCCESS;
 }
@@ -206,6 +227,9 @@ SharedMemory * MemoryServer::insertShared(ProcessID procID,
 	/* We didn't create a new mapping, flag that. */
 	if (created) *created = false;
     }
+    /* Remember the new area. */
+    getAreas(procID)->insert(range->virtualAddress,
+			     (size + PAGESIZE - 1) & PAGEMASK, SharedArea);
     /* Done. */
     return obj;
 }
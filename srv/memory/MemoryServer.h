@@ -34,10 +34,27 @@
 #include <List.h>
 #include <ListIterator.h>
 #include <String.h>
+#include <VMCtlAllocator.h>
 #include <Types.h>
 #include <Macros.h>
 #include <Error.h>
 #include "MemoryMessage.h"
+#include "MemoryAreaTree.h"
+
+/** Lowest virtual address handed out by findFreeRange(). */
+#define FREE_RANGE_LOW  (1024 * 1024 * 16)
+
+/**
+ * Highest virtual address handed out by findFreeRange().
+ * Kernel stacks, including those of threads, live above.
+ */
+#define FREE_RANGE_HIGH 0xcfffffff
+
+/**
+ * Virtual memory kept free for our own heap. It grows with VMCtl()
+ * from VMCTL_ALLOC_START, without asking findFreeRange().
+ */
+#define MEMSRV_HEAP_SIZE (1024 * 1024 * 64)
 
 /**
  * Describes a shared memory region.
@@ -111,6 +128,20 @@ class MemoryServer : public IPCServer<MemoryServer, MemoryMessage>
 	 */
 	void systemMemory(MemoryMessage *msg);
 
+	/**
+	 * Forget the memory areas of a process, when its ID is reused.
+	 * @param msg Request message.
+	 */
+	void resetProcess(MemoryMessage *msg);
+
+	/**
+	 * Retrieve the memory areas of a process.
+	 * @param procID Process identity number.
+	 * @return Pointer to the MemoryAreaTree of the process.
+	 * @note The tree is rebuilt from the page tables when incomplete.
+	 */
+	MemoryAreaTree * getAreas(ProcessID procID);
+
 	/**
 	 * Find a free virtual memory range.
 	 * @param procID Process identity number.
@@ -148,6 +179,9 @@ class MemoryServer : public IPCServer<MemoryServer, MemoryMessage>
 	 */
 	SharedMemory * findShared(char *key);
 	
+	/** Virtual memory areas per process. */
+	MemoryAreaTree *areas;
+
 	/** Keeps track of all current shared memory regions. */
 	List<SharedMemory> shared;
 	
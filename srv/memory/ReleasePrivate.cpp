@@ -33,6 +33,11 @@ void MemoryServer::releasePrivate(MemoryMessage *msg)
     /* Unmap now. */
     VMCtl(msg->from, Map, msg);
 
+    /* Forget the released pages. */
+    getAreas(msg->from)->release(msg->virtualAddress & PAGEMASK,
+				 ((msg->virtualAddress + msg->bytes + PAGESIZE - 1)
+				  & PAGEMASK) - (msg->virtualAddress & PAGEMASK));
+
     /* Done. */
     msg->result = ESUCCESS;
 }
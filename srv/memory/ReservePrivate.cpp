@@ -43,7 +43,12 @@ void MemoryServer::reservePrivate(MemoryMessage *msg)
     }
     /* Unmap. */
     VMCtl(msg->from, UnMapTables);
-    
+
+    /* Remember the reserved page tables. */
+    getAreas(msg->from)->insert(msg->virtualAddress & LARGE_PAGEMASK,
+				((msg->bytes + LARGE_PAGESIZE - 1) / LARGE_PAGESIZE)
+				* LARGE_PAGESIZE, ReservedArea);
+
     /* Done. */
     msg->result = ESUCCESS;
 }
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MemoryServer.h"
+#include "MemoryMessage.h"
+
+void MemoryServer::resetProcess(MemoryMessage *msg)
+{
+    /* Only the process server hands out process IDs. */
+    if (msg->from != PROCSRV_PID)
+    {
+	msg->result = EPERM;
+	return;
+    }
+    /* Verify the process ID. */
+    if (msg->processID >= MAX_PROCS)
+    {
+	msg->result = EINVAL;
+	return;
+    }
+    /* Rebuild from the page tables on the next request. */
+    areas[msg->processID].clear();
+
+    /* Done. */
+    msg->result = ESUCCESS;
+}
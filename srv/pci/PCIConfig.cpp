@@ -62,3 +62,35 @@ Error PCIConfig::read(IOBuffer *buffer, Size size, Size offset)
 	return buffer->write(&value, bytes);
     }
 }
+
+Error PCIConfig::write(IOBuffer *buffer, Size size, Size offset)
+{
+    ulong value = 0;
+    Error e;
+
+    /* Bounds checking. */
+    if (offset >= 256)
+    {
+	return 0;
+    }
+    /* Obtain the new value. */
+    if ((e = buffer->read(&value, size > 4 ? 4 : size)) < 0)
+    {
+	return e;
+    }
+    /* Write out the register. */
+    switch (size)
+    {
+	case 1:
+	    PCI_WRITE_BYTE(bus, slot, func, offset, value);
+	    return 1;
+
+	case 2:
+	    PCI_WRITE_WORD(bus, slot, func, offset, value);
+	    return 2;
+
+	default:
+	    PCI_WRITE_LONG(bus, slot, func, offset, value);
+	    return 4;
+    }
+}
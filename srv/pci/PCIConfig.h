@@ -61,6 +61,19 @@ class PCIConfig : public File
 	 * @see PCIServer.h
          */
         Error read(IOBuffer *buffer, Size size, Size offset);
+
+	/**
+	 * @brief Write bytes to the file.
+	 *
+	 * @param buffer Input buffer.
+	 * @param size Number of bytes to write: 1, 2 or 4.
+	 * @param offset Offset inside the file to start writing.
+	 * @return Number of bytes written on success, Error on failure.
+	 *
+	 * @see IOBuffer
+	 * @see PCIServer.h
+	 */
+	Error write(IOBuffer *buffer, Size size, Size offset);
 	
     private:
 
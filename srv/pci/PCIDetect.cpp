@@ -131,12 +131,12 @@ int main(int argc, char **argv)
 		revision = readint(bus, slot, func, "revision");
 		
 		/* Log the device. */
-                syslog(LOG_INFO, "[%s:%s:%s] %x:%x (rev %d)",
+                syslog(LOG_INFO, "[%s:%s:%s] 0x%x:0x%x (rev %d)",
                        bus->d_name, slot->d_name, func->d_name,
 		       vendor, device, revision);
 
 		/* Construct path to a device driver server. */
-		snprintf(path, sizeof(path), "/etc/pci/%x:%x",
+		snprintf(path, sizeof(path), "/etc/pci/0x%x:0x%x",
 			 vendor, device);
 		
 		/* Find device server, if any. */
@@ -90,6 +90,16 @@ class PCIDevice : public Device
 	    return readRegister(reg, sizeof(u8));
 	}
 
+	/**
+	 * @brief Write a 16-bit register in PCI configuration space.
+	 * @param reg Offset in the PCI configuration space.
+	 * @param value 16-bit integer.
+	 */
+	void writeWord(u8 reg, u16 value)
+	{
+	    writeRegister(reg, value, sizeof(u16));
+	}
+
     private:
     
 	/**
@@ -108,7 +118,7 @@ class PCIDevice : public Device
 	    /*
 	     * Attempt to read value.
 	     */
-	    if (::lseek(file, reg, SEEK_SET) == 0 &&
+	    if (::lseek(file, reg, SEEK_SET) != -1 &&
 	        ::read(file, &value, size) > 0)
 	    {
 		return value;
@@ -117,6 +127,23 @@ class PCIDevice : public Device
 		return ZERO;
 	}
 	
+	/**
+	 * @brief Write a register in PCI configuration space in /dev/pci.
+	 * @param reg Offset in PCI configuration space.
+	 * @param value Integer value.
+	 * @param size Size of the register to write. Must be between 1 and 4.
+	 */
+	void writeRegister(u8 reg, ulong value, Size size)
+	{
+	    assert(size > 0);
+	    assert(size <= sizeof(ulong));
+
+	    if (::lseek(file, reg, SEEK_SET) != -1)
+	    {
+		::write(file, &value, size);
+	    }
+	}
+
 	/**
 	 * @brief File descriptor for the PCI configuration file found in /dev/pci.
 	 */
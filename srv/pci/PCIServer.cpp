@@ -113,20 +113,20 @@ void PCIServer::scan()
 	        if (!busDir)
 	        {
 		    busDir = new Directory;
-		    rootDir->insert(DirectoryFile, "%x", bus);
-		    insertFileCache(busDir, "%x", bus);
+		    rootDir->insert(DirectoryFile, "0x%x", bus);
+		    insertFileCache(busDir, "0x%x", bus);
 		}
 		/* Make slot directory, if needed. */
 		if (!slotDir)
 		{
 		    slotDir = new Directory;
 
-		    busDir->insert(DirectoryFile, "%x", slot);
-	    	    insertFileCache(slotDir, "%x/%x", bus, slot);
+		    busDir->insert(DirectoryFile, "0x%x", slot);
+	    	    insertFileCache(slotDir, "0x%x/0x%x", bus, slot);
 		}
 		/* Then make & fill the function directory. */
 		detect(bus, slot, func);
-		slotDir->insert(DirectoryFile, "%x", func);
+		slotDir->insert(DirectoryFile, "0x%x", func);
 	    }
 	    slotDir = ZERO;
 	}
@@ -153,42 +153,42 @@ void PCIServer::detect(u16 bus, u16 slot, u16 func)
     dir->insert(RegularFile, "bar3");
     dir->insert(RegularFile, "bar4");
     dir->insert(RegularFile, "bar5");
-    insertFileCache(dir, "%x/%x/%x", bus, slot, func);
+    insertFileCache(dir, "0x%x/0x%x/0x%x", bus, slot, func);
 
     /*
      * Now create actual files.
      * Put them into the cache.
      */
     insertFileCache(new PCIConfig(bus, slot, func),
-		    "%x/%x/%x/config", bus, slot, func);
+		    "0x%x/0x%x/0x%x/config", bus, slot, func);
     
     insertFileCache(new PCIRegister(bus, slot, func, PCI_VID, 2),
-		    "%x/%x/%x/vendor", bus, slot, func);
+		    "0x%x/0x%x/0x%x/vendor", bus, slot, func);
 	
     insertFileCache(new PCIRegister(bus, slot, func, PCI_DID, 2),
-		    "%x/%x/%x/device", bus, slot, func);
+		    "0x%x/0x%x/0x%x/device", bus, slot, func);
 				
     insertFileCache(new PCIRegister(bus, slot, func, PCI_RID, 1),
-		    "%x/%x/%x/revision",  bus, slot, func);
+		    "0x%x/0x%x/0x%x/revision",  bus, slot, func);
 
     insertFileCache(new PCIRegister(bus, slot, func, PCI_IRQ, 1),
-		    "%x/%x/%x/interrupt", bus, slot, func);
+		    "0x%x/0x%x/0x%x/interrupt", bus, slot, func);
 
     insertFileCache(new PCIRegister(bus, slot, func, PCI_BAR0, 4),
-		    "%x/%x/%x/bar0", bus, slot, func);
+		    "0x%x/0x%x/0x%x/bar0", bus, slot, func);
 
     insertFileCache(new PCIRegister(bus, slot, func, PCI_BAR1, 4),
-		    "%x/%x/%x/bar1", bus, slot, func);
+		    "0x%x/0x%x/0x%x/bar1", bus, slot, func);
 
     insertFileCache(new PCIRegister(bus, slot, func, PCI_BAR2, 4),
-		    "%x/%x/%x/bar2", bus, slot, func);
+		    "0x%x/0x%x/0x%x/bar2", bus, slot, func);
 
     insertFileCache(new PCIRegister(bus, slot, func, PCI_BAR3, 4),
-		    "%x/%x/%x/bar3", bus, slot, func);
+		    "0x%x/0x%x/0x%x/bar3", bus, slot, func);
 
     insertFileCache(new PCIRegister(bus, slot, func, PCI_BAR4, 4),
-		    "%x/%x/%x/bar4", bus, slot, func);
+		    "0x%x/0x%x/0x%x/bar4", bus, slot, func);
 
     insertFileCache(new PCIRegister(bus, slot, func, PCI_BAR5, 4),
-		    "%x/%x/%x/bar5", bus, slot, func);
+		    "0x%x/0x%x/0x%x/bar5", bus, slot, func);
 }
@@ -82,6 +82,24 @@
 /** @brief Interrupt Request Vector. */
 #define PCI_IRQ	 0x3c
 
+/**
+ * @}
+ */
+
+/**
+ * @name PCI Command Register Flags
+ * @{
+ */
+
+/** @brief Respond to I/O space accesses. */
+#define PCI_CMD_IO	0x1
+
+/** @brief Respond to memory space accesses. */
+#define PCI_CMD_MEMORY	0x2
+
+/** @brief Allow the device to access memory (DMA). */
+#define PCI_CMD_MASTER	0x4
+
 /**
  * @}
  */
@@ -136,15 +154,15 @@
  * @brief Write a word to PCI configuration space.
  */
 #define PCI_WRITE_WORD(bus, dev, func, reg, val) \
-    (PCI_WRITE_BYTE(bus, dev, func, reg, val), \
-     PCI_WRITE_BYTE(bus, dev, func, reg+1, val))
+    (PCI_WRITE_BYTE(bus, dev, func, reg, (val) & 0xff), \
+     PCI_WRITE_BYTE(bus, dev, func, reg+1, ((val) >> 8) & 0xff))
 
 /**
  * @brief Write a long to the PCI configuration space.
  */
 #define PCI_WRITE_LONG(bus, dev, func, reg, val) \
-    (PCI_WRITE_WORD(bus, dev, func, reg, val), \
-     PCI_WRITE_WORD(bus, dev, func, reg+2, val))
+    (PCI_WRITE_WORD(bus, dev, func, reg, (val) & 0xffff), \
+     PCI_WRITE_WORD(bus, dev, func, reg+2, ((val) >> 16) & 0xffff))
 
 /**
  * @}
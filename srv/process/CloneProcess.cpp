@@ -20,12 +20,14 @@
 #include <API/VMCtl.h>
 #include <API/ProcessCtl.h> 
 #include <FreeNOS/Memory.h> 
+#include <FreeNOS/InfoPage.h>
 #include <FileSystemMessage.h>
 #include <FileDescriptor.h>
 #include <FileSystem.h>
 #include <MemoryMessage.h>
 #include "ProcessMessage.h"
 #include "ProcessServer.h"
+#include <Pipe.h>
 
 void copyReservedFlags(Address *parentDir, ProcessID child)
 {
@@ -67,7 +69,8 @@ void ProcessServer::cloneProcessHandler(ProcessMessage *msg)
     Shared<FileDescriptor> *parentFd, *childFd;
     Address *pageTable;
     FileSystemMessage fs;
-    MemoryRange range;
+    MemoryMessage mem;
+    MemoryRange range, large;
     ProcessID id;
     ProcessInfo info;
     u8 *page;
@@ -75,6 +78,11 @@ void ProcessServer::cloneProcessHandler(ProcessMessage *msg)
     /* Create a new Process. */
     id   = ProcessCtl(ANY, Spawn, ZERO);
     page = new u8[PAGESIZE];
+
+    /* Let the memory server forget the previous owner of this ID. */
+    mem.action    = ResetProcess;
+    mem.processID = id;
+    mem.ipc(MEMSRV_PID, SendReceive, sizeof(mem));
     
     /* Map the page tables of the parent process. */
     VMCtl(msg->from, MapTables);
@@ -82,8 +90,18 @@ void ProcessServer::cloneProcessHandler(ProcessMessage *msg)
     /* Loop the page directory. */
     for (Size i = 4; i < PAGEDIR_MAX; i++)
     {
+	/* Large pages are pinned: share them with the child. */
+	if ((pageDirectory[i] & PAGE_PRESENT) &&
+	    (pageDirectory[i] & PAGE_LARGE))
+	{
+	    large.virtualAddress  = i * PAGETAB_MAX * PAGESIZE;
+	    large.physicalAddress = pageDirectory[i] & LARGE_PAGEMASK;
+	    large.protection      = pageDirectory[i] & ~PAGEMASK & ~PAGE_LARGE;
+	    large.bytes           = LARGE_PAGESIZE;
+	    VMCtl(id, Map, &large);
+	}
 	/* Do we need to create a copy this page table (and below)? */
-	if (pageDirectory[i] & PAGE_PRESENT)
+	else if (pageDirectory[i] & PAGE_PRESENT)
 	{
 	    /* Point to the correct page table. */
 	    pageTable = PAGETABADDR_FROM(i * PAGESIZE * PAGEDIR_MAX,
@@ -92,8 +110,25 @@ void ProcessServer::cloneProcessHandler(ProcessMessage *msg)
 	    /* Loop the page table. */
 	    for (Size j = 0; j < PAGETAB_MAX; j++)
 	    {	    
+		/* Calculate virtual address. */
+		range.virtualAddress  = (i * PAGETAB_MAX * PAGESIZE) +
+					(j * PAGESIZE);
+
+		/* The kernel already mapped the information pages. */
+		if (range.virtualAddress == PROCESS_PAGE_ADDR ||
+		    range.virtualAddress == CLOCK_PAGE_ADDR)
+		{
+		    continue;
+		}
+		/* Demand-zero pages are not populated yet: nothing to copy. */
+		if ((pageTable[j] & (PAGE_PRESENT | PAGE_LAZY)) == PAGE_LAZY)
+		{
+		    range.physicalAddress = ZERO;
+		    range.protection      = pageTable[j] & ~PAGEMASK;
+		    VMCtl(id, Map, &range);
+		}
 		/* Are we going to create a (hard)copy this page? */
-		if (pageTable[j] & PAGE_PRESENT)
+		else if (pageTable[j] & PAGE_PRESENT)
 		{
 		    /* Only allocate a new physical page for non-pinned entries. */
 		    if (pageTable[j] & PAGE_PINNED)
@@ -103,9 +138,6 @@ void ProcessServer::cloneProcessHandler(ProcessMessage *msg)
 		    else
 			range.physicalAddress = ZERO;
 		    
-		    /* Calculate virtual address. */
-		    range.virtualAddress  = (i * PAGETAB_MAX * PAGESIZE) +
-					    (j * PAGESIZE);
 		    range.protection = pageTable[j] & ~PAGEMASK;
 		    
 		    /* Perform the mapping. */
@@ -131,6 +163,7 @@ void ProcessServer::cloneProcessHandler(ProcessMessage *msg)
     
     /* Inherit strings from parent. */
     strlcpy(procs[id]->command, procs[msg->from]->command, COMMANDLEN);
+    (*generation.get())++;
     strlcpy(procs[id]->currentDirectory,
             procs[msg->from]->currentDirectory, PATHLEN);
 
@@ -142,6 +175,13 @@ void ProcessServer::cloneProcessHandler(ProcessMessage *msg)
     parentFd = getFileDescriptors(files, msg->from);
     childFd  = getFileDescriptors(files, id);
     memcpy(**childFd, **parentFd, childFd->size());
+
+    /* Count the inherited pipe ends. */
+    for (Size i = 0; i < FILE_DESCRIPTOR_MAX; i++)
+    {
+	if (childFd->get(i)->mount == FILE_DESCRIPTOR_PIPE)
+	    pipeRetain(childFd->get(i));
+    }
                 
     /* Unmap page tables. */
     delete page;
@@ -150,6 +190,7 @@ void ProcessServer::cloneProcessHandler(ProcessMessage *msg)
     /* Repoint stack of the child. */
     ProcessCtl(msg->from, InfoPID, (Address) &info);
     ProcessCtl(id, SetStack, info.stack);
+    ProcessCtl(id, SetParent, msg->from);
 
     /* Begin execution of the child. */
     ProcessCtl(id, Resume);
@@ -157,7 +198,7 @@ void ProcessServer::cloneProcessHandler(ProcessMessage *msg)
     /* Send a reply to the parent. */
     msg->result = ESUCCESS;
     msg->number = id;
-    msg->ipc(msg->from, Send, sizeof(ProcessMessage));
+    msg->ipc(msg->thread, Send, sizeof(ProcessMessage));
     
     /* And to the child aswell. */
     msg->number = ZERO;
@@ -23,17 +23,32 @@
 #include <Error.h>
 #include "ProcessMessage.h"
 #include "ProcessServer.h"
+#include <Pipe.h>
 #include <string.h>
 
 void ProcessServer::exitProcessHandler(ProcessMessage *msg)
 {
     ProcessMessage reply;
+    Shared<FileDescriptor> *fds;
 
     /* Clear process entry. */
     memset(procs[msg->from], 0, sizeof(UserProcess));
+    (*generation.get())++;
 
     // TODO: close files here!!!
 
+    /* Release pipe ends, so the other end sees end-of-file. */
+    fds = getFileDescriptors(files, msg->from);
+
+    for (Size i = 0; i < FILE_DESCRIPTOR_MAX; i++)
+    {
+	if (fds->get(i)->mount == FILE_DESCRIPTOR_PIPE)
+	{
+	    pipeRelease(fds->get(i));
+	    memset(fds->get(i), 0, sizeof(FileDescriptor));
+	}
+    }
+
     /* Ask kernel to terminate the process. */
     ProcessCtl(msg->from, KillPID);
     
@@ -50,7 +65,7 @@ void ProcessServer::exitProcessHandler(ProcessMessage *msg)
 	    reply.action = WaitProcess;
 	    reply.number = msg->number;
 	    reply.result = ESUCCESS;
-	    IPCMessage(i, Send, &reply, sizeof(reply));
+	    IPCMessage(procs[i]->waitThread, Send, &reply, sizeof(reply));
 	}
     }
 }
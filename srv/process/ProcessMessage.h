@@ -28,9 +28,12 @@
 #include <Macros.h>
 #include <ProcessID.h>
 
-/** @see ProcessServer.h */
+/** @see UserProcess.h */
 class UserProcess;
 
+/** @see UserProcess.h */
+class ProcessRecord;
+
 /**
  * Actions which can be specified in an ProcessMessage.
  */
@@ -43,6 +46,7 @@ typedef enum ProcessAction
     CloneProcess = 4,
     WaitProcess  = 5,
     SetCurrentDirectory = 6,
+    ReadProcessBatch    = 7,
 }
 ProcessAction;
 
@@ -68,6 +72,9 @@ typedef struct ProcessMessage : public Message
 	/** Input/Output buffer for ReadProcess. */
 	UserProcess *buffer;
 
+	/** Output buffer for ReadProcessBatch. */
+	ProcessRecord *records;
+
 	/** Pointer to an array of arguments for SpawnProcess. */
 	char *arguments;
     };
@@ -75,8 +82,11 @@ typedef struct ProcessMessage : public Message
     /** Path to an executable program. */
     char *path;
 
+    /** Number of ProcessRecords in the buffer for ReadProcessBatch. */
+    Size count;
+
     /** Unused. */
-    ulong unused[2];
+    ulong unused;
 }
 ProcessMessage;
 
@@ -36,6 +36,7 @@ ProcessServer::ProcessServer()
 
     /* Register message handlers. */
     addIPCHandler(ReadProcess,  &ProcessServer::readProcessHandler);
+    addIPCHandler(ReadProcessBatch, &ProcessServer::readProcessBatchHandler);
     addIPCHandler(ExitProcess,  &ProcessServer::exitProcessHandler,  false);
     addIPCHandler(SpawnProcess, &ProcessServer::spawnProcessHandler);
     addIPCHandler(CloneProcess, &ProcessServer::cloneProcessHandler, false);
@@ -44,5 +45,6 @@ ProcessServer::ProcessServer()
 
     /* Load shared objects. */
     procs.load(USER_PROCESS_KEY, MAX_PROCS);
+    generation.load(USER_PROCESS_GENERATION_KEY, 1);
     files = new Array<Shared<FileDescriptor> >(MAX_PROCS);
 }
@@ -52,6 +52,18 @@ class ProcessServer : public IPCServer<ProcessServer, ProcessMessage>
 	 */
 	void readProcessHandler(ProcessMessage *msg);
 
+	/**
+	 * Read many entries of the user process table at once.
+	 *
+	 * Copies up to count ProcessRecords of live processes into
+	 * the records buffer, starting at the PID given in number.
+	 * On return, count holds the number of records copied and
+	 * number the PID at which to continue.
+	 *
+	 * @param msg Incoming message.
+	 */
+	void readProcessBatchHandler(ProcessMessage *msg);
+
 	/**
 	 * Terminate a process.
 	 * @param msg Incoming message.
@@ -84,6 +96,9 @@ class ProcessServer : public IPCServer<ProcessServer, ProcessMessage>
 
 	/** User Process table. */
 	Shared<UserProcess> procs;
+
+	/** Incremented on each change of the process table. */
+	Shared<Size> generation;
 	
 	/** Per-process FileDescriptor table. */
 	Array<Shared<FileDescriptor> > *files;
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/VMCopy.h>
+#include <API/ProcessCtl.h> 
+#include <FreeNOS/Process.h> 
+#include <Error.h>
+#include "ProcessMessage.h"
+#include "ProcessServer.h"
+#include <string.h>
+
+/** Number of ProcessRecords gathered before copying them out. */
+#define BATCH_CHUNK 8
+
+void ProcessServer::readProcessBatchHandler(ProcessMessage *msg)
+{
+    ProcessRecord chunk[BATCH_CHUNK], *record;
+    ProcessInfo info;
+    Size count = 0, filled = 0, i;
+    Error e;
+
+    /* Collect live processes, starting at the given PID. */
+    for (i = msg->number; i < MAX_PROCS && count < msg->count; i++)
+    {
+	if (!procs[i]->command[0])
+	    continue;
+
+	/* Request kernel's process information. */
+	if (ProcessCtl(i, InfoPID, (Address) &info) != 0)
+	    continue;
+
+	/* Update entry. */
+	procs[i]->state = info.state;
+
+	/* Fill the record. */
+	record = &chunk[filled];
+	record->id    = i;
+	record->state = info.state;
+	memcpy(&record->process, procs[i], sizeof(UserProcess));
+	ProcessCtl(i, StatsPID, (Address) &record->stats);
+	filled++;
+	count++;
+
+	/* Copy out once the chunk is full. */
+	if (filled == BATCH_CHUNK)
+	{
+	    if ((e = VMCopy(msg->from, Write, (Address) chunk,
+			    (Address) (msg->records + count - filled),
+			     sizeof(ProcessRecord) * filled)) < 0)
+	    {
+		msg->result = e;
+		return;
+	    }
+	    filled = 0;
+	}
+    }
+    /* Copy out the remainder. */
+    if (filled && (e = VMCopy(msg->from, Write, (Address) chunk,
+			      (Address) (msg->records + count - filled),
+			       sizeof(ProcessRecord) * filled)) < 0)
+    {
+	msg->result = e;
+	return;
+    }
+    /* Report the number of records and where to continue. */
+    msg->result = count ? ESUCCESS : ENOENT;
+    msg->number = i;
+    msg->count  = count;
+}
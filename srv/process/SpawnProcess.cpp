@@ -21,6 +21,7 @@
 #include <API/ProcessCtl.h> 
 #include <FreeNOS/Memory.h> 
 #include <FileSystemMessage.h>
+#include <MemoryMessage.h>
 #include <FileSystem.h>
 #include <ExecutableFormat.h>
 #include <String.h>
@@ -28,6 +29,7 @@
 #include <Error.h>
 #include "ProcessMessage.h"
 #include "ProcessServer.h"
+#include <Pipe.h>
 #include <stdio.h>
 #include <errno.h>
 
@@ -35,6 +37,7 @@ void ProcessServer::spawnProcessHandler(ProcessMessage *msg)
 {
     char path[PATHLEN], *tmp;
     FileSystemMessage fs;
+    MemoryMessage mem;
     ExecutableFormat *fmt;
     MemoryRegion regions[16];
     MemoryRange range;
@@ -64,6 +67,11 @@ void ProcessServer::spawnProcessHandler(ProcessMessage *msg)
     /* Create new process. */
     pid = ProcessCtl(ANY, Spawn, fmt->entry());
 
+    /* Let the memory server forget the previous owner of this ID. */
+    mem.action    = ResetProcess;
+    mem.processID = pid;
+    mem.ipc(MEMSRV_PID, SendReceive, sizeof(mem));
+
     /* Map program regions into virtual memory of the new process. */
     for (int i = 0; i < numRegions; i++)
     {
@@ -116,12 +124,23 @@ void ProcessServer::spawnProcessHandler(ProcessMessage *msg)
     /* Set command-line string. */
     snprintf(procs[pid]->command, COMMANDLEN,
              "%s", path);
+    (*generation.get())++;
 
     /* Copy the FileDescriptor table. */
     parentFd = getFileDescriptors(files, msg->from);
     childFd  = getFileDescriptors(files, pid);
     memcpy(**childFd, **parentFd, childFd->size());
 
+    /* Drop close-on-exec entries, and count the inherited pipe ends. */
+    for (Size i = 0; i < FILE_DESCRIPTOR_MAX; i++)
+    {
+	if (childFd->get(i)->flags & FILE_DESCRIPTOR_CLOEXEC)
+	    memset(childFd->get(i), 0, sizeof(FileDescriptor));
+
+	else if (childFd->get(i)->mount == FILE_DESCRIPTOR_PIPE)
+	    pipeRetain(childFd->get(i));
+    }
+
     /* Inherit user and group identities. */
     procs[pid]->userID  = procs[msg->from]->userID;
     procs[pid]->groupID = procs[msg->from]->groupID;
@@ -129,6 +148,7 @@ void ProcessServer::spawnProcessHandler(ProcessMessage *msg)
 	    procs[msg->from]->currentDirectory, PATHLEN);
 
     /* Begin execution. */
+    ProcessCtl(pid, SetParent, msg->from);
     ProcessCtl(pid, Resume);
 
     /* Success. */
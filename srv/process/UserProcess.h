@@ -49,6 +49,13 @@
 /** Key for the UserProcess shared mapping. */
 #define USER_PROCESS_KEY "UserProcess"
 
+/**
+ * Key for the shared process table generation counter. The counter
+ * is incremented each time a process is added to or removed from the
+ * user process table.
+ */
+#define USER_PROCESS_GENERATION_KEY "UserProcessGeneration"
+
 #ifndef __KERNEL__
 
 /**
@@ -70,12 +77,34 @@ typedef struct UserProcess
     
     /** Waits for exit of this Process. */
     ProcessID waitProcessID;
+
+    /** Our thread which waits, and receives the exit status. */
+    ProcessID waitThread;
     
     /** Current working directory. */
     char currentDirectory[PATHLEN];
 }
 UserProcess;
 
+/**
+ * Process information as returned by ReadProcessBatch.
+ */
+typedef struct ProcessRecord
+{
+    /** Process identity. */
+    ProcessID id;
+
+    /** Kernel state of the process. */
+    ProcessState state;
+
+    /** Entry in the user process table. */
+    UserProcess process;
+
+    /** Kernel performance counters. */
+    ProcessStats stats;
+}
+ProcessRecord;
+
 #endif /* __KERNEL__ */
 
 /**
@@ -28,10 +28,11 @@ void ProcessServer::waitProcessHandler(ProcessMessage *msg)
 	procs[msg->number]->command[0])
     {
 	procs[msg->from]->waitProcessID = msg->number;
+	procs[msg->from]->waitThread    = msg->thread;
     }
     else
     {
 	msg->result = EINVAL;
-	IPCMessage(msg->from, Send, msg, sizeof(*msg));
+	IPCMessage(msg->thread, Send, msg, sizeof(*msg));
     }
 }
@@ -68,7 +68,7 @@ int main(int argc, char **argv)
 	    server.interrupt(dev, uarts[i].irq);
 	    
 	    /* Perform log. */
-	    syslog(LOG_INFO, "detected at PORT=%x IRQ=%x",
+	    syslog(LOG_INFO, "detected at PORT=%#x IRQ=%#x",
 	        	      uarts[i].port, uarts[i].irq);
 	}
     }
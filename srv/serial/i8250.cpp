@@ -31,6 +31,8 @@ i8250::i8250(u16 b, u16 q)
 
 Error i8250::initialize()
 {
+    Error e;
+
     /* Aquire I/O port and IRQ line permissions. */
     ProcessCtl(SELF, AllowIO,  base);
     ProcessCtl(SELF, AllowIO,  base + LINESTATUS);
@@ -40,7 +42,12 @@ Error i8250::initialize()
     ProcessCtl(SELF, AllowIO,  base + MODEMCONTROL);
     ProcessCtl(SELF, AllowIO,  base + DIVISORLOW);
     ProcessCtl(SELF, AllowIO,  base + DIVISORHIGH);
-    ProcessCtl(SELF, WatchIRQ, irq);
+
+    /* Fails once the IRQ has too many watchers. */
+    if ((e = ProcessCtl(SELF, WatchIRQ, irq)) != ESUCCESS)
+    {
+	return e;
+    }
     
     /* 8bit Words, no parity. */
     outb(base + LINECONTROL, 3);
@@ -96,3 +103,11 @@ Error i8250::write(s8 *buffer, Size size, Size offset)
     }
     return bytes ? (Error) bytes : EAGAIN;
 }
+
+short i8250::poll()
+{
+    u8 status = inb(base + LINESTATUS);
+
+    return (status & RXREADY ? POLLIN  : 0) |
+	   (status & TXREADY ? POLLOUT : 0);
+}
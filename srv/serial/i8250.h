@@ -85,6 +85,12 @@ class i8250 : public Device
 	 */
 	Error write(s8 *buffer, Size size, Size offset);
 
+	/**
+	 * Check the line status.
+	 * @return POLLIN if a byte was received, POLLOUT if one can be sent.
+	 */
+	short poll();
+
     private:
 
 	/** Base I/O port. */
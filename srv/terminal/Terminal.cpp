@@ -135,9 +135,25 @@ u16 * Terminal::getCursorValue()
 
 Error Terminal::read(s8 *buffer, Size size, Size offset)
 {
+    /*
+     * Waiting in the input device would hold up writes of other
+     * clients. Instead, let the DeviceServer retry once woken.
+     */
+    if (!(poll() & POLLIN))
+    {
+	return EAGAIN;
+    }
     return ::read(input, buffer, size);
 }
 
+short Terminal::poll()
+{
+    struct pollfd fds = { input, POLLIN, 0 };
+
+    ::poll(&fds, 1, 0);
+    return (fds.revents & POLLIN) | POLLOUT;
+}
+
 Error Terminal::write(s8 *buffer, Size size, Size offset)
 {
     char cr = '\r';
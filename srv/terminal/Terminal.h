@@ -137,6 +137,13 @@ class Terminal : public Device
 	 */
 	Error write(s8 *buffer, Size size, Size offset);
 
+	/**
+	 * Check for input, and ask the input device to wake us
+	 * once it has some.
+	 * @return POLLOUT, with POLLIN if input is available.
+	 */
+	short poll();
+
     private:
 
 	/** Terminal state. */
@@ -41,7 +41,7 @@ Error UHCIController::initialize()
     openlog("USB", LOG_PID | LOG_CONS, LOG_USER);
     
     /* Print out UHCI Controller information. */
-    syslog(LOG_INFO, "UHCI Host Controller at IOADDR=%x IRQ=%x",
+    syslog(LOG_INFO, "UHCI Host Controller at IOADDR=%#x IRQ=%#x",
 	   readLong(PCI_BAR4), readByte(PCI_IRQ));
     
     return ESUCCESS;
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <DeviceServer.h>
+#include "VirtioBlock.h"
+#include <stdlib.h>
+#include <syslog.h>
+
+int main(int argc, char **argv)
+{
+    DeviceServer server("vd", CharacterDeviceFile);
+    VirtioBlock *dev;
+
+    /*
+     * Verify command-line arguments.
+     */
+    if (argc < 4)
+    {
+	return EXIT_SUCCESS;
+    }
+    /* Open the system log. */
+    openlog("VIRTIO", LOG_PID | LOG_CONS, LOG_USER);
+
+    /*
+     * Start serving requests.
+     */
+    dev = new VirtioBlock(argv[1], argv[2], argv[3]);
+    server.add(dev);
+    server.interrupt(dev, dev->getIRQ());
+    return server.run();
+}
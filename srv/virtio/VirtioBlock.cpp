@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <API/ProcessCtl.h>
+#include <MemoryMessage.h>
+#include <ProcessID.h>
+#include <Macros.h>
+#include "VirtioBlock.h"
+#include <string.h>
+#include <syslog.h>
+
+VirtioBlock::VirtioBlock(const char *bus,
+			 const char *slot,
+			 const char *func)
+    : PCIDevice(bus, slot, func)
+{
+    base      = ZERO;
+    capacity  = 0;
+    queueSize = 0;
+    lastUsed  = 0;
+    slots     = 0;
+    starved   = false;
+    memset(requests, 0, sizeof(requests));
+}
+
+Size VirtioBlock::getIRQ()
+{
+    return readByte(PCI_IRQ);
+}
+
+Error VirtioBlock::initialize()
+{
+    u32 bar = readLong(PCI_BAR0);
+    Address phys;
+    Size bytes;
+    u8 *queue, *page;
+
+    /* Legacy devices have their registers in I/O space. */
+    if (!(bar & 1))
+    {
+	syslog(LOG_ERR, "no I/O space at BAR0=%#x", bar);
+	return EIO;
+    }
+    base = bar & ~3;
+
+    /* Request the I/O ports. */
+    for (Size i = 0; i < VIRTIO_REG_BLK_END; i++)
+    {
+	ProcessCtl(SELF, AllowIO, base + i);
+    }
+    /* The device reads and writes our memory. */
+    writeWord(PCI_CMD, readWord(PCI_CMD) | PCI_CMD_IO | PCI_CMD_MASTER);
+
+    /* Reset, then tell the device we drive it. No features needed. */
+    outb(base + VIRTIO_REG_STATUS, 0);
+    outb(base + VIRTIO_REG_STATUS, VIRTIO_STATUS_ACK);
+    outb(base + VIRTIO_REG_STATUS, VIRTIO_STATUS_ACK | VIRTIO_STATUS_DRIVER);
+    outl(base + VIRTIO_REG_GUEST_FEATURES, 0);
+
+    capacity = inl(base + VIRTIO_REG_BLK_CAPACITY) |
+	       (u64) inl(base + VIRTIO_REG_BLK_CAPACITY + 4) << 32;
+
+    /* Size up the first (and only) VirtQueue. */
+    outw(base + VIRTIO_REG_QUEUE_SEL, 0);
+    queueSize = inw(base + VIRTIO_REG_QUEUE_NUM);
+
+    /* Each request takes the header, data and status descriptors. */
+    slots = queueSize / 3;
+    if (slots > VIRTIO_BLK_SLOTS)
+	slots = VIRTIO_BLK_SLOTS;
+
+    /* Descriptors and available ring, then the used ring aligned. */
+    bytes = (sizeof(VirtQueueDesc) * queueSize +
+	     sizeof(u16) * (3 + queueSize) + VIRTQ_ALIGN - 1) & ~(VIRTQ_ALIGN - 1);
+
+    if (!slots ||
+        !(queue = allocate(bytes + sizeof(u16) * 3 +
+			   sizeof(VirtQueueUsedElem) * queueSize, &phys)) ||
+	!(page  = allocate(PAGESIZE, &headersPhys)) ||
+	!(data  = allocate(VIRTIO_BLK_CHUNK * slots, &dataPhys)))
+    {
+	syslog(LOG_ERR, "failed to setup VirtQueue of size %u", queueSize);
+	outb(base + VIRTIO_REG_STATUS, VIRTIO_STATUS_FAILED);
+	return EIO;
+    }
+    desc  = (VirtQueueDesc *) queue;
+    avail = (VirtQueueAvail *) (queue + sizeof(VirtQueueDesc) * queueSize);
+    used  = (VirtQueueUsed *) (queue + bytes);
+
+    /* Status bytes follow the headers. */
+    headers    = (VirtioBlockHeader *) page;
+    status     = page + sizeof(VirtioBlockHeader) * VIRTIO_BLK_SLOTS;
+    statusPhys = headersPhys + sizeof(VirtioBlockHeader) * VIRTIO_BLK_SLOTS;
+
+    /* Each slot always uses the same three descriptors. */
+    for (Size i = 0; i < slots; i++)
+    {
+	desc[i * 3].address     = headersPhys + sizeof(VirtioBlockHeader) * i;
+	desc[i * 3].length      = sizeof(VirtioBlockHeader);
+	desc[i * 3].flags       = VIRTQ_DESC_NEXT;
+	desc[i * 3].next        = i * 3 + 1;
+	desc[i * 3 + 1].address = dataPhys + VIRTIO_BLK_CHUNK * i;
+	desc[i * 3 + 1].next    = i * 3 + 2;
+	desc[i * 3 + 2].address = statusPhys + i;
+	desc[i * 3 + 2].length  = 1;
+	desc[i * 3 + 2].flags   = VIRTQ_DESC_WRITE;
+    }
+    /* Hand over the VirtQueue and start. */
+    outl(base + VIRTIO_REG_QUEUE_PFN, phys / PAGESIZE);
+    outb(base + VIRTIO_REG_STATUS, VIRTIO_STATUS_ACK | VIRTIO_STATUS_DRIVER |
+				   VIRTIO_STATUS_DRIVER_OK);
+
+    syslog(LOG_INFO, "VirtIO block device at IOADDR=%#x IRQ=%u "
+		     "SECTORS=%llu QUEUE=%u SLOTS=%u",
+	   base, getIRQ(), capacity, queueSize, slots);
+    return ESUCCESS;
+}
+
+Error VirtioBlock::read(s8 *buffer, Size size, Size offset, u64 request)
+{
+    return transfer(VIRTIO_BLK_T_IN, buffer, size, offset, request);
+}
+
+Error VirtioBlock::write(s8 *buffer, Size size, Size offset, u64 request)
+{
+    /* Writes don't merge with the surrounding sectors. */
+    if (offset % VIRTIO_BLK_SECTOR || size % VIRTIO_BLK_SECTOR)
+    {
+	return EINVAL;
+    }
+    return transfer(VIRTIO_BLK_T_OUT, buffer, size, offset, request);
+}
+
+Error VirtioBlock::interrupt(Size vector)
+{
+    /* Acknowledge. */
+    inb(base + VIRTIO_REG_ISR);
+
+    /* The DeviceServer retries our requests next. */
+    complete();
+    return ESUCCESS;
+}
+
+u8 * VirtioBlock::allocate(Size bytes, Address *phys)
+{
+    MemoryMessage mem;
+
+    mem.action          = CreatePrivate;
+    mem.bytes           = bytes;
+    mem.virtualAddress  = ZERO;
+    mem.physicalAddress = ZERO;
+    mem.protection      = PAGE_RW | PAGE_PINNED;
+    mem.ipc(MEMSRV_PID, SendReceive, sizeof(mem));
+
+    if (mem.result != ESUCCESS)
+    {
+	return ZERO;
+    }
+    /* Pinned pages are handed out as is. */
+    memset((void *) mem.virtualAddress, 0, bytes);
+    *phys = mem.physicalAddress;
+    return (u8 *) mem.virtualAddress;
+}
+
+Error VirtioBlock::transfer(u32 type, s8 *buffer, Size size, Size offset,
+			    u64 request)
+{
+    Size lead = slots, skew = offset % VIRTIO_BLK_SECTOR, bytes, chunk;
+    Size max = VIRTIO_BLK_CHUNK * slots;
+    Error result;
+
+    /* In case the interrupt was missed. */
+    complete();
+
+    /* Stay within the device, and the bounce buffers. */
+    if (!slots || offset / VIRTIO_BLK_SECTOR >= capacity)
+    {
+	return 0;
+    }
+    if (max > VIRTIO_BLK_MAX)
+	max = VIRTIO_BLK_MAX;
+
+    if (size > max - skew)
+	size = max - skew;
+
+    if ((u64) offset + size > capacity * VIRTIO_BLK_SECTOR)
+	size = capacity * VIRTIO_BLK_SECTOR - offset;
+
+    result = size;
+
+    /* Submitted before? Equal transfers of others are not ours. */
+    for (Size i = 0; i < slots; i++)
+    {
+	if (requests[i].state != RequestFree && requests[i].lead == i &&
+	    requests[i].request == request && requests[i].type == type &&
+	    requests[i].offset == offset && requests[i].size == size)
+	{
+	    lead = i;
+	    break;
+	}
+    }
+    if (lead == slots)
+    {
+	return submit(type, buffer, size, offset, request);
+    }
+    /* Wait for all parts. */
+    for (Size i = 0; i < slots; i++)
+    {
+	if (requests[i].state == RequestBusy && requests[i].lead == lead)
+	{
+	    return EAGAIN;
+	}
+    }
+    /* Collect the parts, in any order. */
+    for (Size i = 0; i < slots; i++)
+    {
+	if (requests[i].state == RequestFree || requests[i].lead != lead)
+	{
+	    continue;
+	}
+	if (requests[i].state == RequestFailed)
+	{
+	    result = EIO;
+	}
+	else if (type == VIRTIO_BLK_T_IN && result >= 0)
+	{
+	    /* Part of the sector aligned range which was asked for. */
+	    chunk = requests[i].part * VIRTIO_BLK_CHUNK;
+	    bytes = VIRTIO_BLK_CHUNK;
+
+	    if (chunk < skew)
+	    {
+		memcpy(buffer, data + VIRTIO_BLK_CHUNK * i + skew,
+		       size < bytes - skew ? size : bytes - skew);
+	    }
+	    else
+	    {
+		if (chunk - skew + bytes > size)
+		    bytes = size - (chunk - skew);
+		memcpy(buffer + chunk - skew, data + VIRTIO_BLK_CHUNK * i, bytes);
+	    }
+	}
+    }
+    for (Size i = 0; i < slots; i++)
+    {
+	if (requests[i].lead == lead)
+	{
+	    requests[i].state = RequestFree;
+	}
+    }
+
+    /* Let the DeviceServer retry a request which found no free slots. */
+    if (starved)
+    {
+	starved = false;
+	ProcessCtl(SELF, Wakeup);
+    }
+    return result;
+}
+
+Error VirtioBlock::submit(u32 type, s8 *buffer, Size size, Size offset,
+			  u64 request)
+{
+    Size skew = offset % VIRTIO_BLK_SECTOR;
+    Size total = (skew + size + VIRTIO_BLK_SECTOR - 1) & ~(VIRTIO_BLK_SECTOR - 1);
+    Size count = (CEIL(total, VIRTIO_BLK_CHUNK));
+    Size lead = slots, part = 0, unused = 0, bytes;
+    u16 index = avail->index;
+
+    /* All parts go in flight at once. */
+    for (Size i = 0; i < slots; i++)
+    {
+	if (requests[i].state == RequestFree)
+	    unused++;
+    }
+    if (unused < count)
+    {
+	starved = true;
+	return EAGAIN;
+    }
+    for (Size i = 0; i < slots && part < count; i++)
+    {
+	if (requests[i].state != RequestFree)
+	{
+	    continue;
+	}
+	if (lead == slots)
+	{
+	    lead = i;
+	}
+	bytes = total - part * VIRTIO_BLK_CHUNK;
+	if (bytes > VIRTIO_BLK_CHUNK)
+	    bytes = VIRTIO_BLK_CHUNK;
+
+	requests[i].state  = RequestBusy;
+	requests[i].lead   = lead;
+	requests[i].part   = part;
+	requests[i].type   = type;
+	requests[i].offset = offset;
+	requests[i].size   = size;
+	requests[i].request = request;
+
+	headers[i].type   = type;
+	headers[i].sector = offset / VIRTIO_BLK_SECTOR +
+			    part * (VIRTIO_BLK_CHUNK / VIRTIO_BLK_SECTOR);
+	status[i] = 0xff;
+
+	desc[i * 3 + 1].length = bytes;
+	desc[i * 3 + 1].flags  = VIRTQ_DESC_NEXT |
+				 (type == VIRTIO_BLK_T_IN ? VIRTQ_DESC_WRITE : 0);
+
+	if (type == VIRTIO_BLK_T_OUT)
+	{
+	    memcpy(data + VIRTIO_BLK_CHUNK * i,
+		   buffer + part * VIRTIO_BLK_CHUNK, bytes);
+	}
+	avail->ring[index++ % queueSize] = i * 3;
+	part++;
+    }
+    /* Publish the requests after filling them in, then notify. */
+    __sync_synchronize();
+    avail->index = index;
+    __sync_synchronize();
+
+    if (!(used->flags & VIRTQ_USED_NO_NOTIFY))
+    {
+	outw(base + VIRTIO_REG_QUEUE_NOTIFY, 0);
+    }
+    return EAGAIN;
+}
+
+void VirtioBlock::complete()
+{
+    VirtQueueUsedElem *elem;
+    Size slot;
+
+    if (!slots)
+    {
+	return;
+    }
+    while (lastUsed != used->index)
+    {
+	__sync_synchronize();
+	elem = &used->ring[lastUsed % queueSize];
+	slot = elem->id / 3;
+
+	if (slot < slots && requests[slot].state == RequestBusy)
+	{
+	    requests[slot].state = status[slot] == VIRTIO_BLK_S_OK ?
+				   RequestDone : RequestFailed;
+	}
+	lastUsed++;
+    }
+}
@@ -0,0 +1,419 @@
+/*
+ * Copyright (C) 2015 Niek Linnenbank
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __VIRTIO_VIRTIOBLOCK_H
+#define __VIRTIO_VIRTIOBLOCK_H
+
+/**
+ * @defgroup virtio VirtIO (Paravirtualized Devices)
+ * @{
+ */
+
+#include <PCIDevice.h>
+#include <Types.h>
+
+/**
+ * @name VirtIO Legacy PCI I/O Registers.
+ * @{
+ */
+
+/** @brief Features offered by the device (32-bit). */
+#define VIRTIO_REG_DEVICE_FEATURES	0x00
+
+/** @brief Features accepted by the driver (32-bit). */
+#define VIRTIO_REG_GUEST_FEATURES	0x04
+
+/** @brief Physical page number of the selected queue (32-bit). */
+#define VIRTIO_REG_QUEUE_PFN		0x08
+
+/** @brief Number of entries in the selected queue (16-bit). */
+#define VIRTIO_REG_QUEUE_NUM		0x0c
+
+/** @brief Selects a queue for the registers above (16-bit). */
+#define VIRTIO_REG_QUEUE_SEL		0x0e
+
+/** @brief Tells the device a queue has new requests (16-bit). */
+#define VIRTIO_REG_QUEUE_NOTIFY		0x10
+
+/** @brief Device Status (8-bit). */
+#define VIRTIO_REG_STATUS		0x12
+
+/** @brief Interrupt Status. Reading acknowledges the interrupt (8-bit). */
+#define VIRTIO_REG_ISR			0x13
+
+/** @brief Capacity of the block device in sectors (64-bit). */
+#define VIRTIO_REG_BLK_CAPACITY		0x14
+
+/** @brief Number of I/O ports used by a block device. */
+#define VIRTIO_REG_BLK_END		0x1c
+
+/**
+ * @}
+ */
+
+/**
+ * @name VirtIO Device Status Flags.
+ * @{
+ */
+
+/** @brief The driver has noticed the device. */
+#define VIRTIO_STATUS_ACK	0x01
+
+/** @brief The driver knows how to drive the device. */
+#define VIRTIO_STATUS_DRIVER	0x02
+
+/** @brief The driver is ready: requests may be sent. */
+#define VIRTIO_STATUS_DRIVER_OK	0x04
+
+/** @brief The driver has given up on the device. */
+#define VIRTIO_STATUS_FAILED	0x80
+
+/**
+ * @}
+ */
+
+/**
+ * @name VirtIO Queue Descriptor Flags.
+ * @{
+ */
+
+/** @brief The request continues in VirtQueueDesc::next. */
+#define VIRTQ_DESC_NEXT		0x1
+
+/** @brief The device writes to this buffer. */
+#define VIRTQ_DESC_WRITE	0x2
+
+/** @brief The device does not need notifications of new requests. */
+#define VIRTQ_USED_NO_NOTIFY	0x1
+
+/** @brief Alignment of the used ring in a legacy queue. */
+#define VIRTQ_ALIGN		4096
+
+/**
+ * @}
+ */
+
+/**
+ * @name VirtIO Block Requests.
+ * @{
+ */
+
+/** @brief Read sectors from the device. */
+#define VIRTIO_BLK_T_IN		0
+
+/** @brief Write sectors to the device. */
+#define VIRTIO_BLK_T_OUT	1
+
+/** @brief Request completed successfully. */
+#define VIRTIO_BLK_S_OK		0
+
+/** @brief Size of a sector in bytes. */
+#define VIRTIO_BLK_SECTOR	512
+
+/** @brief Number of requests which can be in flight at the same time. */
+#define VIRTIO_BLK_SLOTS	32
+
+/** @brief Bytes transferred by a single request. */
+#define VIRTIO_BLK_CHUNK	(PAGESIZE * 2)
+
+/** @brief Maximum bytes transferred by one read() or write(). */
+#define VIRTIO_BLK_MAX		(VIRTIO_BLK_CHUNK * 8)
+
+/**
+ * @}
+ */
+
+/**
+ * @brief Buffer descriptor in a VirtQueue.
+ */
+typedef struct VirtQueueDesc
+{
+    /** Physical address of the buffer. */
+    u64 address;
+
+    /** Length of the buffer in bytes. */
+    u32 length;
+
+    /** VIRTQ_DESC_* flags. */
+    u16 flags;
+
+    /** Next descriptor of the request, with VIRTQ_DESC_NEXT. */
+    u16 next;
+}
+VirtQueueDesc;
+
+/**
+ * @brief Requests made available to the device.
+ */
+typedef struct VirtQueueAvail
+{
+    /** Flags, unused. */
+    u16 flags;
+
+    /** Where the driver puts the next request, modulo the queue size. */
+    volatile u16 index;
+
+    /** First descriptor of each request. */
+    u16 ring[];
+}
+VirtQueueAvail;
+
+/**
+ * @brief Request completed by the device.
+ */
+typedef struct VirtQueueUsedElem
+{
+    /** First descriptor of the request. */
+    u32 id;
+
+    /** Bytes written by the device. */
+    u32 length;
+}
+VirtQueueUsedElem;
+
+/**
+ * @brief Requests completed by the device.
+ */
+typedef struct VirtQueueUsed
+{
+    /** VIRTQ_USED_* flags. */
+    volatile u16 flags;
+
+    /** Where the device puts the next completion, modulo the queue size. */
+    volatile u16 index;
+
+    /** Completed requests. */
+    VirtQueueUsedElem ring[];
+}
+VirtQueueUsed;
+
+/**
+ * @brief Header in front of the data of a block request.
+ */
+typedef struct VirtioBlockHeader
+{
+    /** VIRTIO_BLK_T_IN or VIRTIO_BLK_T_OUT. */
+    u32 type;
+
+    /** Reserved. */
+    u32 reserved;
+
+    /** First sector to transfer. */
+    u64 sector;
+}
+VirtioBlockHeader;
+
+/**
+ * @brief State of a request slot.
+ */
+typedef enum VirtioBlockState
+{
+    RequestFree   = 0,
+    RequestBusy   = 1,
+    RequestDone   = 2,
+    RequestFailed = 3
+}
+VirtioBlockState;
+
+/**
+ * @brief Request slot, with one VIRTIO_BLK_CHUNK of data.
+ *
+ * A read() or write() larger than a chunk occupies several slots,
+ * all in flight at the same time. They point to the first one,
+ * which remembers the whole read() or write().
+ */
+typedef struct VirtioBlockRequest
+{
+    /** State of this slot. */
+    VirtioBlockState state;
+
+    /** Slot remembering the whole read() or write(). */
+    Size lead;
+
+    /** Position of this slot in the read() or write(). */
+    Size part;
+
+    /** VIRTIO_BLK_T_IN or VIRTIO_BLK_T_OUT, in the lead slot. */
+    u32 type;
+
+    /** Offset of the read() or write(), in the lead slot. */
+    Size offset;
+
+    /** Size of the read() or write(), in the lead slot. */
+    Size size;
+
+    /** Identity of the read() or write(), in the lead slot. */
+    u64 request;
+}
+VirtioBlockRequest;
+
+/**
+ * @brief VirtIO block device on the PCI bus (legacy interface).
+ *
+ * Requests are put in a single VirtQueue, which lives in pinned
+ * physical memory along with bounce buffers for the data. Up to
+ * VIRTIO_BLK_SLOTS requests are in flight: read() and write() submit
+ * their requests and return EAGAIN, so that the DeviceServer retries
+ * them when interrupt() has seen them complete.
+ */
+class VirtioBlock : public PCIDevice
+{
+    public:
+
+	/**
+	 * @brief Constructor function.
+	 * @param bus PCI bus number.
+	 * @param slot PCI slot number.
+	 * @param func PCI function number.
+	 */
+	VirtioBlock(const char *bus, const char *slot, const char *func);
+
+	/**
+	 * @brief Get the interrupt line of the device.
+	 * @return IRQ number.
+	 */
+	Size getIRQ();
+
+	/**
+	 * @brief Configures the device and its VirtQueue.
+	 * @return Error result code.
+	 */
+	Error initialize();
+
+        /**
+         * Read bytes from the device.
+         * @param buffer Buffer to store bytes to read.
+         * @param size Number of bytes to read.
+         * @param offset Offset in the device.
+         * @param request Identity of the request, the same for each retry.
+         * @return Number of bytes on success, EAGAIN while in flight
+         *         and an error code on failure.
+         */
+	Error read(s8 *buffer, Size size, Size offset, u64 request);
+
+        /**
+         * Write bytes to the device.
+         * @param buffer Buffer containing bytes to write.
+         * @param size Number of bytes to write, a multiple of sectors.
+         * @param offset Offset in the device, at a sector boundary.
+         * @param request Identity of the request, the same for each retry.
+         * @return Number of bytes on success, EAGAIN while in flight
+         *         and an error code on failure.
+         */
+	Error write(s8 *buffer, Size size, Size offset, u64 request);
+
+	/**
+	 * @brief Process completed requests.
+	 * @param vector Interrupt number.
+	 * @return Error result code.
+	 */
+	Error interrupt(Size vector);
+
+    private:
+
+	/**
+	 * @brief Allocate pinned, physically contiguous memory.
+	 * @param bytes Number of bytes.
+	 * @param phys Receives the physical address.
+	 * @return Virtual address, or ZERO on failure.
+	 */
+	u8 * allocate(Size bytes, Address *phys);
+
+	/**
+	 * @brief Read or write, submitting the requests the first time.
+	 * @param type VIRTIO_BLK_T_IN or VIRTIO_BLK_T_OUT.
+	 * @param buffer Data to read or write.
+	 * @param size Number of bytes.
+	 * @param offset Offset in the device.
+	 * @param request Identity of the request, the same for each retry.
+	 * @return Number of bytes on success, EAGAIN while in flight
+	 *         and an error code on failure.
+	 */
+	Error transfer(u32 type, s8 *buffer, Size size, Size offset,
+		       u64 request);
+
+	/**
+	 * @brief Put the requests for a read or write in the VirtQueue.
+	 * @param type VIRTIO_BLK_T_IN or VIRTIO_BLK_T_OUT.
+	 * @param buffer Data to write.
+	 * @param size Number of bytes, as passed to transfer().
+	 * @param offset Offset in the device, as passed to transfer().
+	 * @param request Identity of the request.
+	 * @return EAGAIN.
+	 */
+	Error submit(u32 type, s8 *buffer, Size size, Size offset,
+		     u64 request);
+
+	/**
+	 * @brief Mark the requests in the used ring as completed.
+	 */
+	void complete();
+
+	/** @brief I/O base of the device registers. */
+	u16 base;
+
+	/** @brief Capacity of the device in sectors. */
+	u64 capacity;
+
+	/** @brief Number of entries in the VirtQueue. */
+	u16 queueSize;
+
+	/** @brief Descriptor table of the VirtQueue. */
+	VirtQueueDesc *desc;
+
+	/** @brief Available ring of the VirtQueue. */
+	VirtQueueAvail *avail;
+
+	/** @brief Used ring of the VirtQueue. */
+	VirtQueueUsed *used;
+
+	/** @brief Next entry to handle in the used ring. */
+	u16 lastUsed;
+
+	/** @brief Number of slots usable with this queue size. */
+	Size slots;
+
+	/** @brief Request slots. */
+	VirtioBlockRequest requests[VIRTIO_BLK_SLOTS];
+
+	/** @brief Request headers, one per slot. */
+	VirtioBlockHeader *headers;
+
+	/** @brief Physical address of the headers. */
+	Address headersPhys;
+
+	/** @brief Status bytes written by the device, one per slot. */
+	volatile u8 *status;
+
+	/** @brief Physical address of the status bytes. */
+	Address statusPhys;
+
+	/** @brief Bounce buffers, one VIRTIO_BLK_CHUNK per slot. */
+	u8 *data;
+
+	/** @brief Physical address of the bounce buffers. */
+	Address dataPhys;
+
+	/** @brief A request waits for free slots. */
+	bool starved;
+};
+
+/**
+ * @}
+ */
+
+#endif /* __VIRTIO_VIRTIOBLOCK_H */